@@ -202,6 +202,18 @@
 #define PGA_CINIT_UPPER          2  /* all uppercase letters                 */
 #define PGA_CINIT_MIXED          3  /* both upper and lower case letters     */
 
+/*****************************************
+*       RANDOM NUMBER GENERATORS         *
+*****************************************/
+#define PGA_RANDOM_XOSHIRO       1  /* xoshiro256**, 53-bit doubles          */
+#define PGA_RANDOM_MARSAGLIA     2  /* Marsaglia-Zaman, 24-bit floats (old)  */
+
+/*****************************************
+*        ISLAND MODEL TOPOLOGIES         *
+*****************************************/
+#define PGA_TOPOLOGY_RING        1  /* island i sends to island i+1          */
+#define PGA_TOPOLOGY_COMPLETE    2  /* every island sends to every other     */
+
 /*****************************************
 *         SET USER FUNCTION              *
 *****************************************/
@@ -239,6 +251,25 @@ typedef struct {                    /* primary population data structure   */
 } PGAIndividual;
 
 
+/*****************************************
+*      DUPLICATE DETECTION STRUCTURE     *
+*****************************************/
+typedef struct {
+    unsigned long long hash; /* fingerprint of the string                 */
+    int p;                   /* index of the string in the population     */
+    int stamp;               /* slot is empty unless this is table's stamp*/
+} PGADuplicateSlot;
+
+typedef struct {
+    int pop;                 /* population the strings are in             */
+    int n;                   /* strings 0,...,n-1 of pop are in the table */
+    int usable;              /* Duplicate function is one we can hash for */
+    int stamp;               /* current stamp, bumped to empty the table  */
+    int size;                /* number of slots, a power of two           */
+    PGADuplicateSlot *slot;  /* open addressing, linear probing           */
+} PGADuplicateTable;
+
+
 /*****************************************
 *          GA ALGORITHM STRUCTURE        *
 *****************************************/
@@ -283,6 +314,7 @@ typedef struct {
     int *sorted;             /* array of sorted individual indices        */
     PGAIndividual *oldpop;   /* pointer to population (old)               */
     PGAIndividual *newpop;   /* pointer to population (new)               */
+    PGADuplicateTable dup;   /* fingerprints of strings copied to newpop  */
 } PGAAlgorithm;
 
 
@@ -324,6 +356,11 @@ typedef struct {
     int      NumDemes;         /* Number of demes in neighborhood model      */
     MPI_Comm DefaultComm;      /* Default communicator for PGARun            */
     int      MPIStubLibrary;   /* Boolean: real or stub version of MPI       */
+    int      NumThreads;       /* Threads evaluating strings in PGAEvaluate  */
+    void    *ThreadPool;       /* Their pool, started by PGASetUp            */
+    int      MigrationInterval; /* Generations between migrations          */
+    int      NumMigrants;      /* Strings an island sends at a migration     */
+    int      Topology;         /* Which islands send to which                */
 } PGAParallel;
 
 /*****************************************
@@ -337,6 +374,8 @@ typedef struct {
      double Average;
      double Best;
      time_t starttime;
+     int    CheckpointFreq;          /* How often to write a checkpoint      */
+     char   *CheckpointFile;         /* Where to write it, NULL for nowhere  */
 } PGAReport;
 
 
@@ -360,11 +399,23 @@ typedef struct {
     int PGADebugFlags[PGA_DEBUG_MAXFLAGS];
 } PGADebug;
 
+/*****************************************
+*        RANDOM NUMBER STREAM            *
+*****************************************/
+typedef struct {                   /* state of one stream of random numbers */
+    int    Generator;              /* PGA_RANDOM_XOSHIRO or _MARSAGLIA      */
+    unsigned long long s[4];       /* xoshiro256** state                    */
+    int    i96, j96;               /* Marsaglia-Zaman state                 */
+    float  u[97], c, cd, cm;
+} PGARandomStream;
+
 /*****************************************
 *      INITIALIZATION STRUCTURE          *
 *****************************************/
 typedef struct {
     int    RandomInit;             /* flag whether to randomize strings    */
+    int    ContiguousPop;          /* flag whether strings are one block   */
+    char   *ResumeFile;            /* checkpoint for PGASetUp to resume    */
     double BinaryProbability;      /* probability that a Bit will be 1     */
     int    RealType;               /* type of real      initialization     */
     int    IntegerType;            /* type of integer   initialization     */
@@ -374,14 +425,21 @@ typedef struct {
     double *RealMin;               /* minimum of range of reals            */
     double *RealMax;               /* maximum of range of reals            */
     int    RandomSeed;             /* integer to seed random numbers with  */
+    int    RandomGenerator;        /* which generator to use               */
 } PGAInitialize;
 
 /*****************************************
 *      SCRATCH DATA STRUCTURES           *
 *****************************************/
+typedef struct {
+    double key;                    /* what the items are sorted on          */
+    int    idx;                    /* the item's index; breaks ties         */
+} PGASortItem;
+
 typedef struct {
     int    *intscratch;            /* integer-scratch space                 */
     double *dblscratch;            /* double- scratch space                 */
+    PGASortItem *sortscratch;      /* keys and indices for PGAPartialSort   */
 } PGAScratch;
 
 /*****************************************
@@ -397,6 +455,7 @@ struct PGAContext {
     PGADebug               debug;
     PGAInitialize          init;
     PGAScratch             scratch;
+    PGARandomStream        random;     /* the stream PGARandom01 draws on */
 };
 
 /*****************************************
@@ -405,6 +464,7 @@ struct PGAContext {
 
 void PGASetBinaryAllele ( PGAContext *ctx, int p, int pop, int i, int val );
 int PGAGetBinaryAllele ( PGAContext *ctx, int p, int pop, int i );
+PGABinary *PGAGetBinaryRow ( PGAContext *ctx, int p, int pop );
 void PGASetBinaryInitProb ( PGAContext *ctx, double probability );
 double PGAGetBinaryInitProb (PGAContext *ctx);
 void PGABinaryCreateString(PGAContext *ctx, int p, int pop, int initflag);
@@ -462,6 +522,8 @@ PGAContext *PGACreate ( int *argc, char **argv,
 void PGASetUp ( PGAContext *ctx );
 void PGASetRandomInitFlag(PGAContext *ctx, int RandomBoolean);
 int PGAGetRandomInitFlag (PGAContext *ctx);
+void PGASetContiguousPopFlag(PGAContext *ctx, int flag);
+int PGAGetContiguousPopFlag (PGAContext *ctx);
 void PGACreatePop (PGAContext *ctx, int pop);
 void PGACreateIndividual (PGAContext *ctx, int p, int pop, int initflag);
 
@@ -524,6 +586,9 @@ int PGADuplicate(PGAContext *ctx, int p, int pop1, int pop2, int n);
 void PGAChange( PGAContext *ctx, int p, int pop );
 void PGASetNoDuplicatesFlag( PGAContext *ctx, int no_dup);
 int PGAGetNoDuplicatesFlag (PGAContext *ctx);
+void PGAClearDuplicateTable(PGAContext *ctx, int pop);
+void PGAAddToDuplicateTable(PGAContext *ctx, int p, int pop);
+unsigned long long PGAHashString(PGAContext *ctx, int p, int pop);
 
 /*****************************************
 *          evaluate.c
@@ -587,6 +652,7 @@ double PGAHammingDistance( PGAContext *ctx, int popindex);
 
 void PGADblHeapSort ( PGAContext *ctx, double *a, int *idx, int n );
 void PGAIntHeapSort ( PGAContext *ctx, int *a, int *idx, int n );
+void PGAPartialSort ( PGAContext *ctx, PGASortItem *a, int n, int k );
 
 /*****************************************
 *          integer.c
@@ -648,6 +714,8 @@ void PGAEvaluateMS(PGAContext *ctx, int pop,
 		   double (*f)(PGAContext *c, int p, int pop), MPI_Comm comm);
 void PGAEvaluateSlave(PGAContext *ctx, int pop,
 		      double (*f)(PGAContext *, int, int), MPI_Comm comm);
+void PGAEvaluateThreads(PGAContext *ctx, int pop,
+			double (*f)(PGAContext *, int, int));
 void PGAEvaluate(PGAContext *ctx, int pop,
 		 double (*f)(PGAContext *, int, int), MPI_Comm comm);
 MPI_Datatype PGABuildDatatype(PGAContext *ctx, int p, int pop);
@@ -669,6 +737,17 @@ void PGASetNumIslands( PGAContext *ctx, int n);
 int PGAGetNumIslands (PGAContext *ctx);
 void PGASetNumDemes( PGAContext *ctx, int numdemes);
 int PGAGetNumDemes (PGAContext *ctx);
+void PGASetMigrationInterval( PGAContext *ctx, int n);
+int PGAGetMigrationInterval (PGAContext *ctx);
+void PGASetNumMigrants( PGAContext *ctx, int n);
+int PGAGetNumMigrants (PGAContext *ctx);
+void PGASetMigrationTopology( PGAContext *ctx, int topology);
+int PGAGetMigrationTopology (PGAContext *ctx);
+void PGASetNumThreads( PGAContext *ctx, int n);
+int PGAGetNumThreads (PGAContext *ctx);
+int PGAGetThreadIndex (PGAContext *ctx);
+void PGAStartThreads(PGAContext *ctx);
+void PGAStopThreads(PGAContext *ctx);
 void PGASetCommunicator( PGAContext *ctx, MPI_Comm comm);
 MPI_Comm PGAGetCommunicator( PGAContext *ctx);
 
@@ -695,6 +774,7 @@ int PGAGetMutationAndCrossoverFlag (PGAContext *ctx);
 *****************************************/
 
 void PGASortPop ( PGAContext *ctx, int pop );
+void PGAPartialSortPop ( PGAContext *ctx, int pop, int n );
 int PGAGetPopSize (PGAContext *ctx);
 int PGAGetNumReplaceValue (PGAContext *ctx);
 int PGAGetPopReplaceType (PGAContext *ctx);
@@ -714,6 +794,11 @@ double PGARandomUniform( PGAContext *ctx, double start, double end);
 double PGARandomGaussian( PGAContext *ctx, double mean, double sigma);
 int PGAGetRandomSeed(PGAContext *ctx);
 void PGASetRandomSeed(PGAContext *ctx, int seed);
+int PGAGetRandomGenerator(PGAContext *ctx);
+void PGASetRandomGenerator(PGAContext *ctx, int generator);
+void PGARandomSeedStream(PGAContext *ctx, PGARandomStream *rs, int seed);
+void PGARandomSubstream(PGAContext *ctx, int n, PGARandomStream *rs);
+double PGARandomStream01(PGARandomStream *rs);
 
 /*****************************************
 *          real.c
@@ -721,6 +806,7 @@ void PGASetRandomSeed(PGAContext *ctx, int seed);
 
 void PGASetRealAllele (PGAContext *ctx, int p, int pop, int i, double value);
 double PGAGetRealAllele (PGAContext *ctx, int p, int pop, int i);
+PGAReal *PGAGetRealRow (PGAContext *ctx, int p, int pop);
 void PGASetRealInitPercent ( PGAContext *ctx, double *median, double *percent);
 void PGASetRealInitRange (PGAContext *ctx, double *min, double *max);
 double PGAGetMinRealInitValue (PGAContext *ctx, int i);
@@ -764,6 +850,12 @@ void PGASetRestartFrequencyValue(PGAContext *ctx, int numiter);
 int PGAGetRestartFrequencyValue(PGAContext *ctx);
 void PGASetRestartAlleleChangeProb(PGAContext *ctx, double prob);
 double PGAGetRestartAlleleChangeProb(PGAContext *ctx);
+void PGAWriteCheckpoint(PGAContext *ctx, char *filename);
+void PGAReadCheckpoint(PGAContext *ctx, char *filename);
+void PGASetCheckpointFile(PGAContext *ctx, char *filename);
+void PGASetCheckpointFrequencyValue(PGAContext *ctx, int freq);
+int PGAGetCheckpointFrequencyValue(PGAContext *ctx);
+void PGASetResumeFile(PGAContext *ctx, char *filename);
 
 /*****************************************
 *          select.c
@@ -829,3 +921,60 @@ void PGAUpdateAverage(PGAContext *ctx, int pop);
 void PGAUpdateOnline(PGAContext *ctx, int pop);
 void PGAUpdateOffline(PGAContext *ctx, int pop);
 int PGAComputeSimilarity(PGAContext *ctx, PGAIndividual *pop);
+
+/*****************************************
+*       OPTIMIZED ACCESS FUNCTIONS       *
+*****************************************/
+
+/*  If OPTIMIZED, the functions reading and writing alleles and evaluations,
+ *  called for every allele and string in the inner loops of the GA and of
+ *  evaluation functions, are replaced by macros indexing the population
+ *  directly, with no checks.  The functions remain in the library, for code
+ *  compiled without OPTIMIZE and for Fortran.  Arguments other than the
+ *  value set may be evaluated more than once.
+ */
+#if OPTIMIZE
+#define PGAGetIndividual(ctx, p, pop) \
+  (((pop) == PGA_OLDPOP ? (ctx)->ga.oldpop : (ctx)->ga.newpop) + \
+   ((p) >= 0 ? (p) : (p) == PGA_TEMP1 ? (ctx)->ga.PopSize : (ctx)->ga.PopSize+1))
+
+#define PGAGetBinaryAllele(ctx, p, pop, i) \
+  (BIT((i)%WL, ((PGABinary *)PGAGetIndividual(ctx, p, pop)->chrom)[(i)/WL]) != 0)
+#define PGASetBinaryAllele(ctx, p, pop, i, val) \
+  ((void)((val) ? \
+     SET((i)%WL, ((PGABinary *)PGAGetIndividual(ctx, p, pop)->chrom)[(i)/WL]) : \
+     UNSET((i)%WL, ((PGABinary *)PGAGetIndividual(ctx, p, pop)->chrom)[(i)/WL])))
+#define PGAGetBinaryRow(ctx, p, pop) \
+  ((PGABinary *)PGAGetIndividual(ctx, p, pop)->chrom)
+#define PGAGetIntegerAllele(ctx, p, pop, i) \
+  ((int)((PGAInteger *)PGAGetIndividual(ctx, p, pop)->chrom)[i])
+#define PGASetIntegerAllele(ctx, p, pop, i, value) \
+  ((void)(((PGAInteger *)PGAGetIndividual(ctx, p, pop)->chrom)[i] = (value)))
+#define PGAGetRealAllele(ctx, p, pop, i) \
+  ((double)((PGAReal *)PGAGetIndividual(ctx, p, pop)->chrom)[i])
+#define PGASetRealAllele(ctx, p, pop, i, value) \
+  ((void)(((PGAReal *)PGAGetIndividual(ctx, p, pop)->chrom)[i] = (value)))
+#define PGAGetRealRow(ctx, p, pop) \
+  ((PGAReal *)PGAGetIndividual(ctx, p, pop)->chrom)
+#define PGAGetCharacterAllele(ctx, p, pop, i) \
+  (((PGACharacter *)PGAGetIndividual(ctx, p, pop)->chrom)[i])
+#define PGASetCharacterAllele(ctx, p, pop, i, value) \
+  ((void)(((PGACharacter *)PGAGetIndividual(ctx, p, pop)->chrom)[i] = (value)))
+
+#define PGAGetEvaluation(ctx, p, pop) \
+  (PGAGetIndividual(ctx, p, pop)->evalfunc)
+#define PGASetEvaluation(ctx, p, pop, val) \
+  ((void)(PGAGetIndividual(ctx, p, pop)->evalfunc = (val), \
+	  PGAGetIndividual(ctx, p, pop)->evaluptodate = PGA_TRUE))
+#define PGAGetEvaluationUpToDateFlag(ctx, p, pop) \
+  (PGAGetIndividual(ctx, p, pop)->evaluptodate)
+#define PGASetEvaluationUpToDateFlag(ctx, p, pop, status) \
+  ((void)(PGAGetIndividual(ctx, p, pop)->evaluptodate = (status)))
+
+#define PGAGetDataType(ctx)        ((ctx)->ga.datatype)
+#define PGAGetOptDirFlag(ctx)      ((ctx)->ga.optdir)
+#define PGAGetStringLength(ctx)    ((ctx)->ga.StringLen)
+#define PGAGetPopSize(ctx)         ((ctx)->ga.PopSize)
+#define PGAGetNumReplaceValue(ctx) ((ctx)->ga.NumReplace)
+#define PGAGetGAIterValue(ctx)     ((ctx)->ga.iter)
+#endif
@@ -170,6 +170,18 @@ c *** RANDOMIZER
       integer PGA_CINIT_MIXED
       parameter ( PGA_CINIT_MIXED =               3)
 
+c *** RANDOM NUMBER GENERATORS
+      integer PGA_RANDOM_XOSHIRO
+      parameter ( PGA_RANDOM_XOSHIRO =            1)
+      integer PGA_RANDOM_MARSAGLIA
+      parameter ( PGA_RANDOM_MARSAGLIA =          2)
+
+c *** ISLAND MODEL TOPOLOGIES
+      integer PGA_TOPOLOGY_RING
+      parameter ( PGA_TOPOLOGY_RING =             1)
+      integer PGA_TOPOLOGY_COMPLETE
+      parameter ( PGA_TOPOLOGY_COMPLETE =         2)
+
 c *** SET USER FUNCTION
       integer PGA_USERFUNCTION_CREATESTRING
       parameter ( PGA_USERFUNCTION_CREATESTRING =       1)
@@ -204,6 +216,7 @@ c *** TAGS
       character PGAGetCharacterAllele
       integer PGACreate
       integer PGAGetRandomInitFlag
+      integer PGAGetContiguousPopFlag
       integer PGAGetCrossoverType
       double precision PGAGetCrossoverProb
       double precision PGAGetUniformCrossoverProb
@@ -235,6 +248,12 @@ c *** TAGS
       integer PGABuildDatatype
       integer PGAGetRank
       integer PGAGetNumProcs
+      integer PGAGetNumThreads
+      integer PGAGetThreadIndex
+      integer PGAGetNumIslands
+      integer PGAGetMigrationInterval
+      integer PGAGetNumMigrants
+      integer PGAGetMigrationTopology
       integer PGAGetCommunicator
       integer PGAGetDataType
       integer PGAGetOptDirFlag
@@ -252,6 +271,7 @@ c *** TAGS
       double precision PGARandomUniform
       double precision PGARandomGaussian
       integer PGAGetRandomSeed
+      integer PGAGetRandomGenerator
       double precision PGAGetRealAllele
       double precision PGAGetMinRealInitValue
       double precision PGAGetMaxRealInitValue
@@ -259,6 +279,7 @@ c *** TAGS
       integer PGAGetPrintFrequencyValue
       integer PGAGetRestartFlag
       integer PGAGetRestartFrequencyValue
+      integer PGAGetCheckpointFrequencyValue
       double precision PGAGetRestartAlleleChangeProb
       integer PGASelectNextIndex
       integer PGAGetSelectType
@@ -283,6 +304,7 @@ c *** TAGS
       external PGAGetCharacterAllele
       external PGACreate
       external PGAGetRandomInitFlag
+      external PGAGetContiguousPopFlag
       external PGAGetCrossoverType
       external PGAGetCrossoverProb
       external PGAGetUniformCrossoverProb
@@ -314,6 +336,12 @@ c *** TAGS
       external PGABuildDatatype
       external PGAGetRank
       external PGAGetNumProcs
+      external PGAGetNumThreads
+      external PGAGetThreadIndex
+      external PGAGetNumIslands
+      external PGAGetMigrationInterval
+      external PGAGetNumMigrants
+      external PGAGetMigrationTopology
       external PGAGetCommunicator
       external PGAGetDataType
       external PGAGetOptDirFlag
@@ -331,6 +359,7 @@ c *** TAGS
       external PGARandomUniform
       external PGARandomGaussian
       external PGAGetRandomSeed
+      external PGAGetRandomGenerator
       external PGAGetRealAllele
       external PGAGetMinRealInitValue
       external PGAGetMaxRealInitValue
@@ -338,6 +367,7 @@ c *** TAGS
       external PGAGetPrintFrequencyValue
       external PGAGetRestartFlag
       external PGAGetRestartFrequencyValue
+      external PGAGetCheckpointFrequencyValue
       external PGAGetRestartAlleleChangeProb
       external PGASelectNextIndex
       external PGAGetSelectType
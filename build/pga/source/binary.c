@@ -74,7 +74,7 @@ privately owned rights.
                              PGAGetBinaryAllele(ctx, p, PGA_OLDPOP, i))
 
 ****************************************************************************U*/
-void PGASetBinaryAllele ( PGAContext *ctx, int p, int pop, int i, int val )
+void (PGASetBinaryAllele) ( PGAContext *ctx, int p, int pop, int i, int val )
 {
     int windex;        /* index of the computer word allele i is in      */
     int bix;           /* bit position in word chrom[windex] of allele i */
@@ -122,7 +122,7 @@ void PGASetBinaryAllele ( PGAContext *ctx, int p, int pop, int i, int val )
                              PGAGetBinaryAllele(ctx, p, PGA_OLDPOP, i))
 
 ****************************************************************************U*/
-int PGAGetBinaryAllele ( PGAContext *ctx, int p, int pop, int i )
+int (PGAGetBinaryAllele) ( PGAContext *ctx, int p, int pop, int i )
 {
 
     int windex;        /* index of the computer word allele i is in      */
@@ -141,6 +141,46 @@ int PGAGetBinaryAllele ( PGAContext *ctx, int p, int pop, int i )
     return( BIT(bix, chrom[windex]) != 0 );
 }
 
+/*U****************************************************************************
+   PGAGetBinaryRow - returns a pointer to the words holding the bits of
+   string p in population pop.  Allele i is bit i%WL of word i/WL, and a
+   string is (StringLen+WL-1)/WL words long.  If PGASetContiguousPopFlag was
+   used, the strings of a population follow each other, in order, in one
+   block which starts at PGAGetBinaryRow(ctx, 0, pop).
+
+   Category: Fitness & Evaluation
+
+   Inputs:
+      ctx - context variable
+      p   - string index
+      pop - symbolic constant of the population the string is in
+
+   Outputs:
+      A pointer to the first word of string p
+
+   Example:
+      Copy the bits of string p in population PGA_NEWPOP to buf
+
+      PGAContext *ctx;
+      PGABinary buf[NWORDS];
+      int p;
+      :
+      memcpy (buf, PGAGetBinaryRow (ctx, p, PGA_NEWPOP), sizeof(buf));
+
+****************************************************************************U*/
+PGABinary *(PGAGetBinaryRow) ( PGAContext *ctx, int p, int pop )
+{
+    PGABinary *chrom;
+
+    PGADebugEntered("PGAGetBinaryRow");
+    PGACheckDataType("PGAGetBinaryRow", PGA_DATATYPE_BINARY);
+
+    chrom = (PGABinary *)PGAGetIndividual ( ctx, p, pop )->chrom;
+
+    PGADebugExited("PGAGetBinaryRow");
+    return( chrom );
+}
+
 /*U****************************************************************************
    PGASetBinaryInitProb - specify the probability of initializing an allele to
    "1" when creating a PGA_DATATYPE_BINARY string.  The default value is 0.5.
@@ -242,10 +282,13 @@ void PGABinaryCreateString(PGAContext *ctx, int p, int pop, int initflag)
     PGADebugPrint( ctx, PGA_DEBUG_PRINTVAR, "PGABinaryCreateString",
 		  "initflag = ", PGA_INT, (void *) &initflag );
     
-    new->chrom = (void *)malloc(ctx->ga.tw * sizeof(PGABinary));
-    if (new->chrom == NULL)
-	PGAError(ctx, "PGABinaryCreateString: No room to allocate "
-		 "new->chrom", PGA_FATAL, PGA_VOID, NULL);
+    /*  With contiguous populations, PGACreatePop has set chrom to the row  */
+    if (ctx->init.ContiguousPop == PGA_FALSE) {
+	new->chrom = (void *)malloc(ctx->ga.tw * sizeof(PGABinary));
+	if (new->chrom == NULL)
+	    PGAError(ctx, "PGABinaryCreateString: No room to allocate "
+		     "new->chrom", PGA_FATAL, PGA_VOID, NULL);
+    }
     
     s = (PGABinary *)new->chrom;
     if (initflag)
@@ -75,7 +75,7 @@ privately owned rights.
                                 PGAGetCharacterAllele(ctx, p, PGA_OLDPOP, i))
 
 ****************************************************************************U*/
-void PGASetCharacterAllele (PGAContext *ctx, int p, int pop, int i, char value)
+void (PGASetCharacterAllele) (PGAContext *ctx, int p, int pop, int i, char value)
 {
     PGAIndividual *ind;
 
@@ -115,7 +115,7 @@ void PGASetCharacterAllele (PGAContext *ctx, int p, int pop, int i, char value)
                                 PGAGetCharacterAllele(ctx, p, PGA_OLDPOP, i))
 
 ****************************************************************************U*/
-char PGAGetCharacterAllele (PGAContext *ctx, int p, int pop, int i)
+char (PGAGetCharacterAllele) (PGAContext *ctx, int p, int pop, int i)
 {
      PGAIndividual *ind;
 
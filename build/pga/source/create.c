@@ -234,6 +234,7 @@ PGAContext *PGACreate ( int *argc, char **argv,
     ctx->ga.ItersOfSame        = 0;
     ctx->ga.PercentSame        = 0;
     ctx->ga.selected           = NULL;
+    ctx->ga.dup.slot           = NULL;
     ctx->ga.SelectIndex        = 0;
     ctx->ga.restart            = PGA_UNINITIALIZED_INT;
     ctx->ga.restartFreq        = PGA_UNINITIALIZED_INT;
@@ -264,6 +265,11 @@ PGAContext *PGACreate ( int *argc, char **argv,
     ctx->par.NumIslands        = PGA_UNINITIALIZED_INT;
     ctx->par.NumDemes          = PGA_UNINITIALIZED_INT;
     ctx->par.DefaultComm       = NULL;
+    ctx->par.NumThreads        = PGA_UNINITIALIZED_INT;
+    ctx->par.ThreadPool        = NULL;
+    ctx->par.MigrationInterval = PGA_UNINITIALIZED_INT;
+    ctx->par.NumMigrants       = PGA_UNINITIALIZED_INT;
+    ctx->par.Topology          = PGA_UNINITIALIZED_INT;
 #ifdef FAKE_MPI
     ctx->par.MPIStubLibrary    = PGA_TRUE;
 #else
@@ -277,6 +283,8 @@ PGAContext *PGACreate ( int *argc, char **argv,
     ctx->rep.Offline           = 0;
     ctx->rep.Best              = PGA_UNINITIALIZED_DOUBLE;
     ctx->rep.starttime         = PGA_UNINITIALIZED_INT;
+    ctx->rep.CheckpointFreq    = PGA_UNINITIALIZED_INT;
+    ctx->rep.CheckpointFile    = NULL;
 
     /* System
      *
@@ -296,11 +304,14 @@ PGAContext *PGACreate ( int *argc, char **argv,
 
     /* Initialization */
     ctx->init.RandomInit        = PGA_UNINITIALIZED_INT;
+    ctx->init.ContiguousPop     = PGA_UNINITIALIZED_INT;
+    ctx->init.ResumeFile        = NULL;
     ctx->init.BinaryProbability = PGA_UNINITIALIZED_DOUBLE;
     ctx->init.RealType          = PGA_UNINITIALIZED_INT;
     ctx->init.IntegerType       = PGA_UNINITIALIZED_INT;
     ctx->init.CharacterType     = PGA_UNINITIALIZED_INT;
     ctx->init.RandomSeed        = PGA_UNINITIALIZED_INT;
+    ctx->init.RandomGenerator   = PGA_UNINITIALIZED_INT;
 
     /*  Allocate and clear arrays to define the minimum and maximum values
      *  allowed by integer and real datatypes.
@@ -694,6 +705,30 @@ void PGASetUp ( PGAContext *ctx )
          ctx->par.NumDemes          = 1;
     if ( ctx->par.DefaultComm      == NULL )
          ctx->par.DefaultComm       = MPI_COMM_WORLD;
+    if ( ctx->par.NumThreads       == PGA_UNINITIALIZED_INT)
+         ctx->par.NumThreads        = 1;
+    if ( ctx->par.MigrationInterval == PGA_UNINITIALIZED_INT)
+         ctx->par.MigrationInterval  = 10;
+    if ( ctx->par.NumMigrants      == PGA_UNINITIALIZED_INT)
+         ctx->par.NumMigrants       = 1;
+    if ( ctx->par.Topology         == PGA_UNINITIALIZED_INT)
+         ctx->par.Topology          = PGA_TOPOLOGY_RING;
+    if ( ctx->par.NumIslands > 1 ) {
+         /*  An island takes in NumMigrants strings from each island
+          *  sending to it, in place of its worst.  */
+         i = ctx->par.NumMigrants;
+         if ( ctx->par.Topology == PGA_TOPOLOGY_COMPLETE )
+              i *= ctx->par.NumIslands - 1;
+         if ( i >= ctx->ga.PopSize )
+              PGAError( ctx, "PGASetUp: Migrants taken in at once must be "
+                        "fewer than PopSize:", PGA_FATAL, PGA_INT,
+                        (void *) &i );
+         if ( ctx->rep.CheckpointFile != NULL ||
+              ctx->init.ResumeFile != NULL )
+              PGAError( ctx, "PGASetUp: Checkpoints are not kept of an "
+                        "island model", PGA_FATAL, PGA_VOID, NULL );
+    }
+    PGAStartThreads(ctx);
 
     
 
@@ -701,6 +736,9 @@ void PGASetUp ( PGAContext *ctx )
     if ( ctx->rep.PrintFreq == PGA_UNINITIALIZED_INT)
          ctx->rep.PrintFreq  = 10;
 
+    if ( ctx->rep.CheckpointFreq == PGA_UNINITIALIZED_INT)
+         ctx->rep.CheckpointFreq  = 100;
+
 /* sys */
     /* no more sets necessary here. */
 
@@ -710,6 +748,22 @@ void PGASetUp ( PGAContext *ctx )
     if ( ctx->init.RandomInit == PGA_UNINITIALIZED_INT)
          ctx->init.RandomInit  = PGA_TRUE;
 
+    if ( ctx->init.ContiguousPop == PGA_UNINITIALIZED_INT)
+         ctx->init.ContiguousPop  = PGA_FALSE;
+
+    if ( ctx->init.ContiguousPop == PGA_TRUE ) {
+         if ( ctx->ga.datatype != PGA_DATATYPE_BINARY &&
+              ctx->ga.datatype != PGA_DATATYPE_REAL )
+              PGAError( ctx, "PGASetUp: Contiguous populations need a binary"
+                        " or real datatype:", PGA_FATAL, PGA_INT,
+                        (void *) &ctx->ga.datatype );
+         if ( ctx->cops.CreateString != PGABinaryCreateString &&
+              ctx->cops.CreateString != PGARealCreateString )
+              PGAError( ctx, "PGASetUp: Contiguous populations need the "
+                        "built-in CreateString function", PGA_FATAL,
+                        PGA_VOID, NULL );
+    }
+
     if ( ctx->init.BinaryProbability == PGA_UNINITIALIZED_DOUBLE)
          ctx->init.BinaryProbability  = 0.5;
 
@@ -746,6 +800,9 @@ void PGASetUp ( PGAContext *ctx )
     if ( ctx->init.RandomSeed == PGA_UNINITIALIZED_INT)
          ctx->init.RandomSeed = (int)time(NULL);
 
+    if ( ctx->init.RandomGenerator == PGA_UNINITIALIZED_INT)
+         ctx->init.RandomGenerator = PGA_RANDOM_XOSHIRO;
+
     /* seed random number generator with this process' unique seed */
     ctx->init.RandomSeed += PGAGetRank(ctx, MPI_COMM_WORLD);
     PGARandom01( ctx, ctx->init.RandomSeed );
@@ -760,6 +817,18 @@ void PGASetUp ( PGAContext *ctx )
          PGAError(ctx, "PGASetUp: No room to allocate ctx->ga.sorted",
                   PGA_FATAL, PGA_VOID, NULL);
 
+    for (ctx->ga.dup.size = 2; ctx->ga.dup.size < 2 * ctx->ga.PopSize; )
+         ctx->ga.dup.size *= 2;
+    ctx->ga.dup.slot = (PGADuplicateSlot *)
+         calloc( ctx->ga.dup.size, sizeof(PGADuplicateSlot) );
+    if (ctx->ga.dup.slot == NULL)
+         PGAError(ctx, "PGASetUp: No room to allocate ctx->ga.dup.slot",
+                  PGA_FATAL, PGA_VOID, NULL);
+    ctx->ga.dup.stamp = 0;
+    ctx->ga.dup.pop = PGA_NEWPOP;
+    ctx->ga.dup.n = 0;
+    ctx->ga.dup.usable = PGA_FALSE;
+
     ctx->scratch.intscratch = (int *)malloc( sizeof(int) * ctx->ga.PopSize );
     if (ctx->scratch.intscratch == NULL)
          PGAError(ctx, "PGASetUp: No room to allocate ctx->scratch.intscratch",
@@ -770,9 +839,18 @@ void PGASetUp ( PGAContext *ctx )
          PGAError(ctx, "PGASetUp: No room to allocate ctx->scratch.dblscratch",
                   PGA_FATAL, PGA_VOID, NULL);
 
+    ctx->scratch.sortscratch =
+         (PGASortItem *)malloc(sizeof(PGASortItem) * ctx->ga.PopSize);
+    if (ctx->scratch.sortscratch == NULL)
+         PGAError(ctx, "PGASetUp: No room to allocate ctx->scratch.sortscratch",
+                  PGA_FATAL, PGA_VOID, NULL);
+
     PGACreatePop ( ctx , PGA_OLDPOP );
     PGACreatePop ( ctx , PGA_NEWPOP );
 
+    if ( ctx->init.ResumeFile != NULL )
+         PGAReadCheckpoint ( ctx, ctx->init.ResumeFile );
+
     ctx->rep.starttime = time(NULL);
 
     PGADebugExited("PGASetUp");
@@ -857,6 +935,82 @@ int PGAGetRandomInitFlag (PGAContext *ctx)
     return(ctx->init.RandomInit);
 }
 
+/*U****************************************************************************
+   PGASetContiguousPopFlag - A boolean flag to indicate whether the strings
+   of each population are allocated as rows of a single block of memory,
+   rather than one by one.  Only binary and real strings can be allocated
+   this way, and only with the built-in CreateString function.  Operators and
+   evaluation functions that run through a population then walk memory in
+   order; PGAGetRealRow and PGAGetBinaryRow return the rows.  Legal values
+   are PGA_TRUE and PGA_FALSE.  Default is PGA_FALSE.
+
+   Category: Initialization
+
+   Inputs:
+      ctx  - context variable
+      flag - either PGA_TRUE or PGA_FALSE
+
+   Outputs:
+      None
+
+   Example:
+      Allocate each population as one PopSize by StringLen block
+
+      PGAContext *ctx;
+      :
+      PGASetContiguousPopFlag(ctx,PGA_TRUE);
+
+****************************************************************************U*/
+void PGASetContiguousPopFlag(PGAContext *ctx, int flag)
+{
+    PGADebugEntered("PGASetContiguousPopFlag");
+    PGAFailIfSetUp("PGASetContiguousPopFlag");
+
+  switch (flag) {
+    case PGA_TRUE:
+    case PGA_FALSE:
+      ctx->init.ContiguousPop = flag;
+      break;
+    default:
+      PGAError(ctx, "PGASetContiguousPopFlag: Invalid value of flag:",
+               PGA_FATAL, PGA_INT, (void *) &flag);
+      break;
+    }
+    PGADebugExited("PGASetContiguousPopFlag");
+}
+
+/*U***************************************************************************
+   PGAGetContiguousPopFlag - returns true/false to indicate whether or not
+   the strings of each population are allocated as one block.
+
+   Category: Initialization
+
+   Inputs:
+      ctx - context variable
+
+   Outputs:
+      Returns PGA_TRUE if each population is one block of strings.
+      Otherwise, returns PGA_FALSE
+
+   Example:
+      PGAContext *ctx;
+      PGAReal *block;
+      :
+      if (PGAGetContiguousPopFlag(ctx) == PGA_TRUE)
+          block = PGAGetRealRow(ctx, 0, PGA_OLDPOP);
+
+***************************************************************************U*/
+int PGAGetContiguousPopFlag (PGAContext *ctx)
+{
+    PGADebugEntered("PGAGetContiguousPopFlag");
+
+    PGAFailIfNotSetUp("PGAGetContiguousPopFlag");
+
+    PGADebugExited("PGAGetContiguousPopFlag");
+
+    return(ctx->init.ContiguousPop);
+}
+
 
 /*I****************************************************************************
   PGACreatePop - allocates a population of individuals and calls
@@ -877,6 +1031,9 @@ int PGAGetRandomInitFlag (PGAContext *ctx)
 ****************************************************************************I*/
 void PGACreatePop (PGAContext *ctx, int pop)
 {
+     PGAIndividual *ind;
+     size_t rowsize;
+     char *block;
      int p, flag;
 
     PGADebugEntered("PGACreatePop");
@@ -904,6 +1061,22 @@ void PGACreatePop (PGAContext *ctx, int pop)
                    PGA_INT, (void *) &pop );
           break;
      };
+     /*  One block, strings 0..PopSize-1 then PGA_TEMP1 and PGA_TEMP2 as
+      *  rows; the CreateString functions leave chrom pointing at them.
+      */
+     if (ctx->init.ContiguousPop == PGA_TRUE) {
+          ind = (pop == PGA_OLDPOP) ? ctx->ga.oldpop : ctx->ga.newpop;
+          if (ctx->ga.datatype == PGA_DATATYPE_BINARY)
+               rowsize = ctx->ga.tw * sizeof(PGABinary);
+          else
+               rowsize = ctx->ga.StringLen * sizeof(PGAReal);
+          block = (char *)malloc(rowsize * (ctx->ga.PopSize + 2));
+          if (block == NULL)
+               PGAError(ctx, "PGACreatePop: No room to allocate "
+                        "population block", PGA_FATAL, PGA_VOID, NULL);
+          for (p = 0; p < ctx->ga.PopSize + 2; p++)
+               ind[p].chrom = (void *)(block + p * rowsize);
+     }
      for (p = 0; p < ctx->ga.PopSize; p++)
           PGACreateIndividual (ctx, p, pop, flag);
      PGACreateIndividual (ctx, PGA_TEMP1, pop, PGA_FALSE);
@@ -123,6 +123,7 @@ PGAFuncRec PGAFuncIndex[PGA_DEBUG_MAXPGAPACKFUNCTIONS] =
         { "PGABinaryBuildDatatype",         109 },
         { "PGASetBinaryAllele",             110 },
         { "PGAGetBinaryAllele",             111 },
+        { "PGAGetBinaryRow",                112 },
         { "PGABinaryHammingDistance",       120 },
         { "PGABinaryPrint",                 121 },
         { "PGAGetBinaryInitProb",           122 },
@@ -160,6 +161,7 @@ PGAFuncRec PGAFuncIndex[PGA_DEBUG_MAXPGAPACKFUNCTIONS] =
         { "PGARealBuildDatatype",           209 },
         { "PGASetRealAllele",               210 },
         { "PGAGetRealAllele",               211 },
+        { "PGAGetRealRow",                  212 },
         { "PGASetRealInitPercent",          220 },
         { "PGASetRealInitRange",            221 },
         { "PGAGetMinRealInitValue",         222 },
@@ -188,6 +190,8 @@ PGAFuncRec PGAFuncIndex[PGA_DEBUG_MAXPGAPACKFUNCTIONS] =
         { "PGACreateIndividual",            303 },
         { "PGAGetRandomInitFlag",           304 },
         { "PGASetRandomInitFlag",           305 },
+        { "PGASetContiguousPopFlag",        306 },
+        { "PGAGetContiguousPopFlag",        307 },
 
         /* cross.c */
         { "PGACrossover",                   310 },
@@ -207,6 +211,7 @@ PGAFuncRec PGAFuncIndex[PGA_DEBUG_MAXPGAPACKFUNCTIONS] =
         { "PGASetPopSize",                  325 },
         { "PGASetNumReplaceValue",          326 },
         { "PGASetPopReplaceType",           327 },
+        { "PGAPartialSortPop",              328 },
 
         /* mutation.c */
         { "PGAMutate",                      330 },
@@ -226,6 +231,9 @@ PGAFuncRec PGAFuncIndex[PGA_DEBUG_MAXPGAPACKFUNCTIONS] =
         { "PGAChange",                      341 },
         { "PGASetNoDuplicatesFlag",         342 },
         { "PGAGetNoDuplicatesFlag",         343 },
+        { "PGAClearDuplicateTable",         344 },
+        { "PGAAddToDuplicateTable",         345 },
+        { "PGAHashString",                  346 },
 
         /* pga.c */
         { "PGARunMutationAndCrossover",     350 },
@@ -250,6 +258,14 @@ PGAFuncRec PGAFuncIndex[PGA_DEBUG_MAXPGAPACKFUNCTIONS] =
         { "PGASetRestartFrequencyValue",    375 },
         { "PGASetRestartAlleleChangeProb",  376 },
 
+        /* restart.c, checkpoints */
+        { "PGAWriteCheckpoint",             410 },
+        { "PGAReadCheckpoint",              411 },
+        { "PGASetCheckpointFile",           412 },
+        { "PGASetCheckpointFrequencyValue", 413 },
+        { "PGAGetCheckpointFrequencyValue", 414 },
+        { "PGASetResumeFile",               415 },
+
         /* select.c */
         { "PGASelect",                      380 },
         { "PGASelectProportional",          381 },
@@ -288,6 +304,7 @@ PGAFuncRec PGAFuncIndex[PGA_DEBUG_MAXPGAPACKFUNCTIONS] =
 	{ "PGAEvaluateSeq",                 515 },
 	{ "PGAEvaluateCoop",                516 },
 	{ "PGAEvaluateSlave",               517 },
+	{ "PGAEvaluateThreads",             518 },
         { "PGASetEvaluation",               511 },
         { "PGASetEvaluationUpToDateFlag",   512 },
         { "PGAGetEvaluation",               513 },
@@ -327,6 +344,17 @@ PGAFuncRec PGAFuncIndex[PGA_DEBUG_MAXPGAPACKFUNCTIONS] =
         { "PGARunGM",                       615 },
         { "PGARunIM",                       616 },
         { "PGARunNM",                       617 },
+        { "PGASetNumThreads",               618 },
+        { "PGAGetNumThreads",               619 },
+        { "PGAGetThreadIndex",              620 },
+        { "PGAStartThreads",                621 },
+        { "PGAStopThreads",                 622 },
+        { "PGASetMigrationInterval",        623 },
+        { "PGAGetMigrationInterval",        624 },
+        { "PGASetNumMigrants",              625 },
+        { "PGAGetNumMigrants",              626 },
+        { "PGASetMigrationTopology",        627 },
+        { "PGAGetMigrationTopology",        628 },
 
 /* System and Utility 700 - 799 */
         /* system.c */
@@ -372,6 +400,10 @@ PGAFuncRec PGAFuncIndex[PGA_DEBUG_MAXPGAPACKFUNCTIONS] =
         { "PGARandomGaussian",              754 },
         { "PGAGetRandomSeed",               755 },
         { "PGASetRandomSeed",               756 },
+        { "PGAGetRandomGenerator",          757 },
+        { "PGASetRandomGenerator",          758 },
+        { "PGARandomSeedStream",            759 },
+        { "PGARandomSubstream",             760 },
 
 /* Miscellaneous Routines 800 - 899 */
         /* hamming.c */
@@ -384,6 +416,7 @@ PGAFuncRec PGAFuncIndex[PGA_DEBUG_MAXPGAPACKFUNCTIONS] =
         { "PGAIntHeapSort",                 813 },
         { "PGAIntHeapify",                  814 },
         { "PGAIntAdjustHeap",               815 },
+        { "PGAPartialSort",                 816 },
 
         /* report.c */
         { "PGAPrintPopulation",             820 },
@@ -765,6 +798,8 @@ void PGASetDebugFlag11(PGAContext *ctx, int Flag)
    ctx->debug.PGADebugFlags[301] = Flag; /*PGASetUp*/
    ctx->debug.PGADebugFlags[304] = Flag; /*PGAGetRandomInitFlag*/
    ctx->debug.PGADebugFlags[305] = Flag; /*PGASetRandomInitFlag*/
+   ctx->debug.PGADebugFlags[306] = Flag; /*PGASetContiguousPopFlag*/
+   ctx->debug.PGADebugFlags[307] = Flag; /*PGAGetContiguousPopFlag*/
 
    ctx->debug.PGADebugFlags[310] = Flag; /*PGACrossover*/
    ctx->debug.PGADebugFlags[311] = Flag; /*PGAGetCrossoverType*/
@@ -798,6 +833,9 @@ void PGASetDebugFlag11(PGAContext *ctx, int Flag)
    ctx->debug.PGADebugFlags[341] = Flag; /*PGAChange*/
    ctx->debug.PGADebugFlags[342] = Flag; /*PGASetNoDuplicatesFlag*/
    ctx->debug.PGADebugFlags[343] = Flag; /*PGAGetNoDuplicatesFlag*/
+   ctx->debug.PGADebugFlags[344] = Flag; /*PGAClearDuplicateTable*/
+   ctx->debug.PGADebugFlags[345] = Flag; /*PGAAddToDuplicateTable*/
+   ctx->debug.PGADebugFlags[346] = Flag; /*PGAHashString*/
 
    ctx->debug.PGADebugFlags[350] = Flag; /*PGARunMutationAndCrossover*/
    ctx->debug.PGADebugFlags[351] = Flag; /*PGARunMutationOrCrossover*/
@@ -819,6 +857,12 @@ void PGASetDebugFlag11(PGAContext *ctx, int Flag)
    ctx->debug.PGADebugFlags[374] = Flag; /*PGASetRestartFlag*/
    ctx->debug.PGADebugFlags[375] = Flag; /*PGASetRestartFrequencyValue*/
    ctx->debug.PGADebugFlags[376] = Flag; /*PGASetRestartAlleleChangeProb*/
+   ctx->debug.PGADebugFlags[410] = Flag; /*PGAWriteCheckpoint*/
+   ctx->debug.PGADebugFlags[411] = Flag; /*PGAReadCheckpoint*/
+   ctx->debug.PGADebugFlags[412] = Flag; /*PGASetCheckpointFile*/
+   ctx->debug.PGADebugFlags[413] = Flag; /*PGASetCheckpointFrequencyValue*/
+   ctx->debug.PGADebugFlags[414] = Flag; /*PGAGetCheckpointFrequencyValue*/
+   ctx->debug.PGADebugFlags[415] = Flag; /*PGASetResumeFile*/
 
    ctx->debug.PGADebugFlags[380] = Flag; /*PGASelect*/
    ctx->debug.PGADebugFlags[386] = Flag; /*PGAGetSelectType*/
@@ -861,6 +905,17 @@ void PGASetDebugFlag11(PGAContext *ctx, int Flag)
    ctx->debug.PGADebugFlags[615] = Flag; /*PGARunSeq*/
    ctx->debug.PGADebugFlags[616] = Flag; /*PGARunIM*/
    ctx->debug.PGADebugFlags[617] = Flag; /*PGARunNM*/
+   ctx->debug.PGADebugFlags[618] = Flag; /*PGASetNumThreads*/
+   ctx->debug.PGADebugFlags[619] = Flag; /*PGAGetNumThreads*/
+   ctx->debug.PGADebugFlags[620] = Flag; /*PGAGetThreadIndex*/
+   ctx->debug.PGADebugFlags[621] = Flag; /*PGAStartThreads*/
+   ctx->debug.PGADebugFlags[622] = Flag; /*PGAStopThreads*/
+   ctx->debug.PGADebugFlags[623] = Flag; /*PGASetMigrationInterval*/
+   ctx->debug.PGADebugFlags[624] = Flag; /*PGAGetMigrationInterval*/
+   ctx->debug.PGADebugFlags[625] = Flag; /*PGASetNumMigrants*/
+   ctx->debug.PGADebugFlags[626] = Flag; /*PGAGetNumMigrants*/
+   ctx->debug.PGADebugFlags[627] = Flag; /*PGASetMigrationTopology*/
+   ctx->debug.PGADebugFlags[628] = Flag; /*PGAGetMigrationTopology*/
 
    ctx->debug.PGADebugFlags[700] = Flag; /*PGAError*/
    ctx->debug.PGADebugFlags[702] = Flag; /*PGAUsage*/
@@ -914,6 +969,17 @@ void PGASetDebugFlag20(PGAContext *ctx, int Flag)
    ctx->debug.PGADebugFlags[614] = Flag; /*PGAGetNumDemes*/
    ctx->debug.PGADebugFlags[616] = Flag; /*PGARunIM*/
    ctx->debug.PGADebugFlags[617] = Flag; /*PGARunNM*/
+   ctx->debug.PGADebugFlags[618] = Flag; /*PGASetNumThreads*/
+   ctx->debug.PGADebugFlags[619] = Flag; /*PGAGetNumThreads*/
+   ctx->debug.PGADebugFlags[620] = Flag; /*PGAGetThreadIndex*/
+   ctx->debug.PGADebugFlags[621] = Flag; /*PGAStartThreads*/
+   ctx->debug.PGADebugFlags[622] = Flag; /*PGAStopThreads*/
+   ctx->debug.PGADebugFlags[623] = Flag; /*PGASetMigrationInterval*/
+   ctx->debug.PGADebugFlags[624] = Flag; /*PGAGetMigrationInterval*/
+   ctx->debug.PGADebugFlags[625] = Flag; /*PGASetNumMigrants*/
+   ctx->debug.PGADebugFlags[626] = Flag; /*PGAGetNumMigrants*/
+   ctx->debug.PGADebugFlags[627] = Flag; /*PGASetMigrationTopology*/
+   ctx->debug.PGADebugFlags[628] = Flag; /*PGAGetMigrationTopology*/
 }
 
 /*I****************************************************************************
@@ -947,6 +1013,17 @@ void PGASetDebugFlag21(PGAContext *ctx, int Flag)
    ctx->debug.PGADebugFlags[614] = Flag; /*PGAGetNumDemes*/
    ctx->debug.PGADebugFlags[616] = Flag; /*PGARunIM*/
    ctx->debug.PGADebugFlags[617] = Flag; /*PGARunNM*/
+   ctx->debug.PGADebugFlags[618] = Flag; /*PGASetNumThreads*/
+   ctx->debug.PGADebugFlags[619] = Flag; /*PGAGetNumThreads*/
+   ctx->debug.PGADebugFlags[620] = Flag; /*PGAGetThreadIndex*/
+   ctx->debug.PGADebugFlags[621] = Flag; /*PGAStartThreads*/
+   ctx->debug.PGADebugFlags[622] = Flag; /*PGAStopThreads*/
+   ctx->debug.PGADebugFlags[623] = Flag; /*PGASetMigrationInterval*/
+   ctx->debug.PGADebugFlags[624] = Flag; /*PGAGetMigrationInterval*/
+   ctx->debug.PGADebugFlags[625] = Flag; /*PGASetNumMigrants*/
+   ctx->debug.PGADebugFlags[626] = Flag; /*PGAGetNumMigrants*/
+   ctx->debug.PGADebugFlags[627] = Flag; /*PGASetMigrationTopology*/
+   ctx->debug.PGADebugFlags[628] = Flag; /*PGAGetMigrationTopology*/
    ctx->debug.PGADebugFlags[714] = Flag; /*PGACheckSum*/
 }
 
@@ -976,6 +1053,7 @@ void PGASetDebugFlag30(PGAContext *ctx, int Flag)
    ctx->debug.PGADebugFlags[109] = Flag; /*PGABinaryBuildDatatype*/
    ctx->debug.PGADebugFlags[110] = Flag; /*PGASetBinaryAllele*/
    ctx->debug.PGADebugFlags[111] = Flag; /*PGAGetBinaryAllele*/
+   ctx->debug.PGADebugFlags[112] = Flag; /*PGAGetBinaryRow*/
    ctx->debug.PGADebugFlags[120] = Flag; /*PGABinaryHammingDistance*/
    ctx->debug.PGADebugFlags[121] = Flag; /*PGABinaryPrint*/
    ctx->debug.PGADebugFlags[122] = Flag; /*PGAGetBinaryInitProb*/
@@ -1043,6 +1121,7 @@ void PGASetDebugFlag34(PGAContext *ctx, int Flag)
    ctx->debug.PGADebugFlags[209] = Flag; /*PGARealBuildDatatype*/
    ctx->debug.PGADebugFlags[210] = Flag; /*PGASetRealAllele*/
    ctx->debug.PGADebugFlags[211] = Flag; /*PGAGetRealAllele*/
+   ctx->debug.PGADebugFlags[212] = Flag; /*PGAGetRealRow*/
    ctx->debug.PGADebugFlags[220] = Flag; /*PGASetRealInitPercent*/
    ctx->debug.PGADebugFlags[221] = Flag; /*PGASetRealInitRange*/
    ctx->debug.PGADebugFlags[222] = Flag; /*PGAGetMinRealInitValue*/
@@ -1105,6 +1184,8 @@ void PGASetDebugFlag40(PGAContext *ctx, int Flag)
    ctx->debug.PGADebugFlags[303] = Flag; /*PGACreateIndividual*/
    ctx->debug.PGADebugFlags[304] = Flag; /*PGAGetRandomInitFlag*/
    ctx->debug.PGADebugFlags[305] = Flag; /*PGASetRandomInitFlag*/
+   ctx->debug.PGADebugFlags[306] = Flag; /*PGASetContiguousPopFlag*/
+   ctx->debug.PGADebugFlags[307] = Flag; /*PGAGetContiguousPopFlag*/
    ctx->debug.PGADebugFlags[150] = Flag; /*PGAIntegerCreateString*/
    ctx->debug.PGADebugFlags[158] = Flag; /*PGAIntegerInitString*/
    ctx->debug.PGADebugFlags[170] = Flag; /*PGASetIntegerInitPermute*/
@@ -1228,10 +1309,12 @@ void PGASetDebugFlag48(PGAContext *ctx, int Flag)
 {
    ctx->debug.PGADebugFlags[110] = Flag; /*PGASetBinaryAllele*/
    ctx->debug.PGADebugFlags[111] = Flag; /*PGAGetBinaryAllele*/
+   ctx->debug.PGADebugFlags[112] = Flag; /*PGAGetBinaryRow*/
    ctx->debug.PGADebugFlags[160] = Flag; /*PGASetIntegerAllele*/
    ctx->debug.PGADebugFlags[161] = Flag; /*PGAGetIntegerAllele*/
    ctx->debug.PGADebugFlags[210] = Flag; /*PGASetRealAllele*/
    ctx->debug.PGADebugFlags[211] = Flag; /*PGAGetRealAllele*/
+   ctx->debug.PGADebugFlags[212] = Flag; /*PGAGetRealRow*/
    ctx->debug.PGADebugFlags[260] = Flag; /*PGASetCharacterAllele*/
    ctx->debug.PGADebugFlags[261] = Flag; /*PGAGetCharacterAllele*/
    ctx->debug.PGADebugFlags[500] = Flag; /*PGAGetRealFromBinary*/
@@ -1307,6 +1390,9 @@ void PGASetDebugFlag52(PGAContext *ctx, int Flag)
    ctx->debug.PGADebugFlags[341] = Flag; /*PGAChange*/
    ctx->debug.PGADebugFlags[342] = Flag; /*PGASetNoDuplicatesFlag*/
    ctx->debug.PGADebugFlags[343] = Flag; /*PGAGetNoDuplicatesFlag*/
+   ctx->debug.PGADebugFlags[344] = Flag; /*PGAClearDuplicateTable*/
+   ctx->debug.PGADebugFlags[345] = Flag; /*PGAAddToDuplicateTable*/
+   ctx->debug.PGADebugFlags[346] = Flag; /*PGAHashString*/
 }
 
 /*I****************************************************************************
@@ -1330,6 +1416,12 @@ void PGASetDebugFlag54(PGAContext *ctx, int Flag)
    ctx->debug.PGADebugFlags[374] = Flag; /*PGASetRestartFlag*/
    ctx->debug.PGADebugFlags[375] = Flag; /*PGASetRestartFrequencyValue*/
    ctx->debug.PGADebugFlags[376] = Flag; /*PGASetRestartAlleleChangeProb*/
+   ctx->debug.PGADebugFlags[410] = Flag; /*PGAWriteCheckpoint*/
+   ctx->debug.PGADebugFlags[411] = Flag; /*PGAReadCheckpoint*/
+   ctx->debug.PGADebugFlags[412] = Flag; /*PGASetCheckpointFile*/
+   ctx->debug.PGADebugFlags[413] = Flag; /*PGASetCheckpointFrequencyValue*/
+   ctx->debug.PGADebugFlags[414] = Flag; /*PGAGetCheckpointFrequencyValue*/
+   ctx->debug.PGADebugFlags[415] = Flag; /*PGASetResumeFile*/
 }
 
 /*I****************************************************************************
@@ -1401,12 +1493,14 @@ void PGASetDebugFlag60(PGAContext *ctx, int Flag)
 {
    ctx->debug.PGADebugFlags[320] = Flag; /*PGASortPop*/
    ctx->debug.PGADebugFlags[324] = Flag; /*PGAGetSortedPopIndex*/
+   ctx->debug.PGADebugFlags[328] = Flag; /*PGAPartialSortPop*/
    ctx->debug.PGADebugFlags[810] = Flag; /*PGADblHeapSort*/
    ctx->debug.PGADebugFlags[811] = Flag; /*PGADblHeapify*/
    ctx->debug.PGADebugFlags[812] = Flag; /*PGADblAdjustHeap*/
    ctx->debug.PGADebugFlags[813] = Flag; /*PGAIntHeapSort*/
    ctx->debug.PGADebugFlags[814] = Flag; /*PGAIntHeapify*/
    ctx->debug.PGADebugFlags[815] = Flag; /*PGAIntAdjustHeap*/
+   ctx->debug.PGADebugFlags[816] = Flag; /*PGAPartialSort*/
 }
 
 /*I****************************************************************************
@@ -1430,6 +1524,10 @@ void PGASetDebugFlag62(PGAContext *ctx, int Flag)
    ctx->debug.PGADebugFlags[754] = Flag; /*PGARandomGaussian*/
    ctx->debug.PGADebugFlags[755] = Flag; /*PGAGetRandomSeed*/
    ctx->debug.PGADebugFlags[756] = Flag; /*PGASetRandomSeed*/
+   ctx->debug.PGADebugFlags[757] = Flag; /*PGAGetRandomGenerator*/
+   ctx->debug.PGADebugFlags[758] = Flag; /*PGASetRandomGenerator*/
+   ctx->debug.PGADebugFlags[759] = Flag; /*PGARandomSeedStream*/
+   ctx->debug.PGADebugFlags[760] = Flag; /*PGARandomSubstream*/
 }
 
 /*I****************************************************************************
@@ -108,7 +108,22 @@ int PGADuplicate(PGAContext *ctx, int p, int pop1, int pop2, int n)
 		  PGA_INT, (void *) &n );
     
     if (ctx->ga.NoDuplicates == PGA_TRUE) {
-	if (ctx->fops.Duplicate) {
+	if (ctx->ga.dup.usable && ctx->ga.dup.pop == pop2 &&
+	    ctx->ga.dup.n == n) {
+	    PGADuplicateSlot *slot = ctx->ga.dup.slot;
+	    unsigned long long h = PGAHashString(ctx, p, pop1);
+	    int mask = ctx->ga.dup.size - 1;
+	    int i;
+
+	    /*  Only strings with the same fingerprint can be the same  */
+	    for (i = (int)(h & mask); slot[i].stamp == ctx->ga.dup.stamp;
+		 i = (i + 1) & mask)
+		if (slot[i].hash == h &&
+		    (*ctx->cops.Duplicate)(ctx, p, pop1, slot[i].p, pop2)) {
+		    RetVal = PGA_TRUE;
+		    break;
+		}
+	} else if (ctx->fops.Duplicate) {
 	    fp = ((p == PGA_TEMP1) || (p == PGA_TEMP2)) ? p : p+1;
 	    for (p2 = 1; p2 <= n; p2++)
 		if ((*ctx->fops.Duplicate)(&ctx, &fp, &pop1, &p2, &pop2)) {
@@ -272,3 +287,187 @@ int PGAGetNoDuplicatesFlag (PGAContext *ctx)
 
     return(ctx->ga.NoDuplicates);
 }
+
+
+/*I****************************************************************************
+   PGAClearDuplicateTable - empties the table of string fingerprints which
+   lets PGADuplicate look up strings 0,...,n-1 of a population instead of
+   comparing against each of them.  The table is filled by
+   PGAAddToDuplicateTable as strings are copied into pop, in order.  It is
+   only used if duplicates are not allowed and the Duplicate function is the
+   one PGAPack supplies for the data type, else PGADuplicate compares
+   against every string as before.
+
+   Inputs:
+      ctx - context variable
+      pop - symbolic constant of the population that will be added
+
+   Outputs:
+      None
+
+   Example:
+      PGAContext *ctx;
+      :
+      PGAClearDuplicateTable(ctx, PGA_NEWPOP);
+
+****************************************************************************I*/
+void PGAClearDuplicateTable(PGAContext *ctx, int pop)
+{
+    PGADebugEntered("PGAClearDuplicateTable");
+
+    ctx->ga.dup.pop = pop;
+    ctx->ga.dup.n = 0;
+    ctx->ga.dup.usable = PGA_FALSE;
+    /*  The built-in functions find any two strings of one allele (or of
+     *  one word, for binary strings) to be duplicates, which no fingerprint
+     *  can reproduce.
+     */
+    if (ctx->ga.NoDuplicates == PGA_TRUE && ctx->fops.Duplicate == NULL &&
+	ctx->ga.StringLen > 1) {
+	switch (ctx->ga.datatype) {
+	case PGA_DATATYPE_BINARY:
+	    ctx->ga.dup.usable = ctx->cops.Duplicate == PGABinaryDuplicate &&
+		ctx->ga.tw > 1;
+	    break;
+	case PGA_DATATYPE_INTEGER:
+	    ctx->ga.dup.usable = ctx->cops.Duplicate == PGAIntegerDuplicate;
+	    break;
+	case PGA_DATATYPE_REAL:
+	    ctx->ga.dup.usable = ctx->cops.Duplicate == PGARealDuplicate;
+	    break;
+	case PGA_DATATYPE_CHARACTER:
+	    ctx->ga.dup.usable = ctx->cops.Duplicate == PGACharacterDuplicate;
+	    break;
+	}
+    }
+
+    /*  Slots are empty unless they carry the current stamp, so emptying
+     *  the table only needs a new stamp.
+     */
+    if (ctx->ga.dup.usable) {
+	if (++ctx->ga.dup.stamp == INT_MAX) {
+	    memset(ctx->ga.dup.slot, 0,
+		   ctx->ga.dup.size * sizeof(PGADuplicateSlot));
+	    ctx->ga.dup.stamp = 1;
+	}
+    }
+
+    PGADebugExited("PGAClearDuplicateTable");
+}
+
+
+/*I****************************************************************************
+   PGAAddToDuplicateTable - adds the fingerprint of string p of population
+   pop to the table cleared by PGAClearDuplicateTable.  Strings must be
+   added in order, 0,...,n-1; if one is not, the table is no longer used
+   until it is cleared again.
+
+   Inputs:
+      ctx - context variable
+      p   - string index
+      pop - symbolic constant of the population containing string p
+
+   Outputs:
+      None
+
+   Example:
+      PGAContext *ctx;
+      int n;
+      :
+      PGACopyIndividual(ctx, PGA_TEMP1, PGA_NEWPOP, n, PGA_NEWPOP);
+      PGAAddToDuplicateTable(ctx, n, PGA_NEWPOP);
+
+****************************************************************************I*/
+void PGAAddToDuplicateTable(PGAContext *ctx, int p, int pop)
+{
+    PGADuplicateSlot *slot = ctx->ga.dup.slot;
+    unsigned long long h;
+    int mask, i;
+
+    PGADebugEntered("PGAAddToDuplicateTable");
+
+    if (ctx->ga.dup.usable && ctx->ga.dup.pop == pop &&
+	ctx->ga.dup.n == p && p < ctx->ga.PopSize) {
+	h = PGAHashString(ctx, p, pop);
+	mask = ctx->ga.dup.size - 1;
+	for (i = (int)(h & mask); slot[i].stamp == ctx->ga.dup.stamp;
+	     i = (i + 1) & mask)
+	    ;
+	slot[i].hash = h;
+	slot[i].p = p;
+	slot[i].stamp = ctx->ga.dup.stamp;
+	ctx->ga.dup.n++;
+    } else
+	ctx->ga.dup.usable = PGA_FALSE;
+
+    PGADebugExited("PGAAddToDuplicateTable");
+}
+
+
+/*  Mixes a 64 bit word into the fingerprint h  */
+static unsigned long long mix(unsigned long long h, unsigned long long w)
+{
+    h ^= w;
+    h *= 0x9e3779b97f4a7c15ULL;
+    return h ^ (h >> 29);
+}
+
+/*I****************************************************************************
+   PGAHashString - returns a fingerprint of the alleles of string p.  Strings
+   the built-in Duplicate function for the data type finds the same always
+   have the same fingerprint; in particular real alleles 0.0 and -0.0 hash
+   alike.
+
+   Inputs:
+      ctx - context variable
+      p   - string index
+      pop - symbolic constant of the population containing string p
+
+   Outputs:
+      A 64 bit fingerprint of the string
+
+   Example:
+      PGAContext *ctx;
+      unsigned long long h;
+      :
+      h = PGAHashString(ctx, PGA_TEMP1, PGA_NEWPOP);
+
+****************************************************************************I*/
+unsigned long long PGAHashString(PGAContext *ctx, int p, int pop)
+{
+    void *chrom = PGAGetIndividual(ctx, p, pop)->chrom;
+    unsigned long long h = 0x243f6a8885a308d3ULL, w;
+    int i, len = ctx->ga.StringLen;
+
+    PGADebugEntered("PGAHashString");
+
+    switch (ctx->ga.datatype) {
+    case PGA_DATATYPE_BINARY:
+	for (i = 0; i < ctx->ga.tw; i++)
+	    h = mix(h, ((PGABinary *)chrom)[i]);
+	break;
+    case PGA_DATATYPE_INTEGER:
+	for (i = 0; i < len; i++)
+	    h = mix(h, (unsigned long long)((PGAInteger *)chrom)[i]);
+	break;
+    case PGA_DATATYPE_REAL:
+	for (i = 0; i < len; i++) {
+	    double v = ((PGAReal *)chrom)[i];
+
+	    if (v == 0.0)
+		v = 0.0;
+	    memcpy(&w, &v, sizeof(w));
+	    h = mix(h, w);
+	}
+	break;
+    case PGA_DATATYPE_CHARACTER:
+	for (i = 0; i < len; i++)
+	    h = mix(h, (unsigned char)((PGACharacter *)chrom)[i]);
+	break;
+    }
+    h = mix(h, (unsigned long long)len);
+
+    PGADebugExited("PGAHashString");
+
+    return(h ^ (h >> 32));
+}
@@ -73,7 +73,7 @@ privately owned rights.
       PGASetEvaluation(ctx, p, PGA_NEWPOP, 123.456);
 
 ****************************************************************************U*/
-void PGASetEvaluation ( PGAContext *ctx, int p, int pop, double val )
+void (PGASetEvaluation) ( PGAContext *ctx, int p, int pop, double val )
 {
     PGAIndividual *ind;
 
@@ -114,7 +114,7 @@ void PGASetEvaluation ( PGAContext *ctx, int p, int pop, double val )
       eval = PGAGetEvaluation(ctx, p, PGA_NEWPOP);
 
 ***************************************************************************U*/
-double PGAGetEvaluation ( PGAContext *ctx, int p, int pop )
+double (PGAGetEvaluation) ( PGAContext *ctx, int p, int pop )
 {
     PGAIndividual *ind;
 
@@ -165,7 +165,7 @@ double PGAGetEvaluation ( PGAContext *ctx, int p, int pop )
       PGASetEvaluationUpToDateFlag(ctx, p, PGA_NEWPOP, PGA_FALSE);
 
 ****************************************************************************U*/
-void PGASetEvaluationUpToDateFlag ( PGAContext *ctx, int p, int pop,
+void (PGASetEvaluationUpToDateFlag) ( PGAContext *ctx, int p, int pop,
                                    int status )
 {
     PGAIndividual *ind;
@@ -222,7 +222,7 @@ void PGASetEvaluationUpToDateFlag ( PGAContext *ctx, int p, int pop,
       }
 
 ***************************************************************************U*/
-int PGAGetEvaluationUpToDateFlag ( PGAContext *ctx, int p, int pop )
+int (PGAGetEvaluationUpToDateFlag) ( PGAContext *ctx, int p, int pop )
 {
     PGAIndividual *ind;
 
@@ -76,6 +76,8 @@ privately owned rights.
 #define pgasetup_                        PGASETUP
 #define pgasetrandominitflag_            PGASETRANDOMINITFLAG
 #define pgagetrandominitflag_            PGAGETRANDOMINITFLAG
+#define pgasetcontiguouspopflag_         PGASETCONTIGUOUSPOPFLAG
+#define pgagetcontiguouspopflag_         PGAGETCONTIGUOUSPOPFLAG
 #define pgacrossover_                    PGACROSSOVER
 #define pgagetcrossovertype_             PGAGETCROSSOVERTYPE
 #define pgagetcrossoverprob_             PGAGETCROSSOVERPROB
@@ -142,6 +144,17 @@ privately owned rights.
 #define pgasendreceiveindividual_        PGASENDRECEIVEINDIVIDUAL
 #define pgagetrank_                      PGAGETRANK
 #define pgagetnumprocs_                  PGAGETNUMPROCS
+#define pgasetnumthreads_                PGASETNUMTHREADS
+#define pgagetnumthreads_                PGAGETNUMTHREADS
+#define pgagetthreadindex_               PGAGETTHREADINDEX
+#define pgasetnumislands_                PGASETNUMISLANDS
+#define pgagetnumislands_                PGAGETNUMISLANDS
+#define pgasetmigrationinterval_         PGASETMIGRATIONINTERVAL
+#define pgagetmigrationinterval_         PGAGETMIGRATIONINTERVAL
+#define pgasetnummigrants_               PGASETNUMMIGRANTS
+#define pgagetnummigrants_               PGAGETNUMMIGRANTS
+#define pgasetmigrationtopology_         PGASETMIGRATIONTOPOLOGY
+#define pgagetmigrationtopology_         PGAGETMIGRATIONTOPOLOGY
 #define pgasetcommunicator_              PGASETCOMMUNICATOR
 #define pgagetcommunicator_              PGAGETCOMMUNICATOR
 #define pgarun_                          PGARUN
@@ -157,6 +170,7 @@ privately owned rights.
 #define pgagetmutationorcrossoverflag_   PGAGETMUTATIONORCROSSOVERFLAG
 #define pgagetmutationandcrossoverflag_  PGAGETMUTATIONANDCROSSOVERFLAG
 #define pgasortpop_                      PGASORTPOP
+#define pgapartialsortpop_               PGAPARTIALSORTPOP
 #define pgagetpopsize_                   PGAGETPOPSIZE
 #define pgagetnumreplacevalue_           PGAGETNUMREPLACEVALUE
 #define pgagetpopreplacetype_            PGAGETPOPREPLACETYPE
@@ -171,6 +185,8 @@ privately owned rights.
 #define pgarandomgaussian_               PGARANDOMGAUSSIAN
 #define pgagetrandomseed_                PGAGETRANDOMSEED
 #define pgasetrandomseed_                PGASETRANDOMSEED
+#define pgagetrandomgenerator_           PGAGETRANDOMGENERATOR
+#define pgasetrandomgenerator_           PGASETRANDOMGENERATOR
 #define pgasetrealallele_                PGASETREALALLELE
 #define pgagetrealallele_                PGAGETREALALLELE
 #define pgasetrealinitpercent_           PGASETREALINITPERCENT
@@ -193,6 +209,8 @@ privately owned rights.
 #define pgagetrestartfrequencyvalue_     PGAGETRESTARTFREQUENCYVALUE
 #define pgasetrestartallelechangeprob_   PGASETRESTARTALLELECHANGEPROB
 #define pgagetrestartallelechangeprob_   PGAGETRESTARTALLELECHANGEPROB
+#define pgasetcheckpointfrequencyvalue_  PGASETCHECKPOINTFREQUENCYVALUE
+#define pgagetcheckpointfrequencyvalue_  PGAGETCHECKPOINTFREQUENCYVALUE
 #define pgaselect_                       PGASELECT
 #define pgaselectnextindex_              PGASELECTNEXTINDEX
 #define pgasetselecttype_                PGASETSELECTTYPE
@@ -236,6 +254,8 @@ privately owned rights.
 #define pgasetup_                        _pgasetup_
 #define pgasetrandominitflag_            _pgasetrandominitflag_
 #define pgagetrandominitflag_            _pgagetrandominitflag_
+#define pgasetcontiguouspopflag_         _pgasetcontiguouspopflag_
+#define pgagetcontiguouspopflag_         _pgagetcontiguouspopflag_
 #define pgacrossover_                    _pgacrossover_
 #define pgagetcrossovertype_             _pgagetcrossovertype_
 #define pgagetcrossoverprob_             _pgagetcrossoverprob_
@@ -302,6 +322,17 @@ privately owned rights.
 #define pgasendreceiveindividual_        _pgasendreceiveindividual_
 #define pgagetrank_                      _pgagetrank_
 #define pgagetnumprocs_                  _pgagetnumprocs_
+#define pgasetnumthreads_                _pgasetnumthreads_
+#define pgagetnumthreads_                _pgagetnumthreads_
+#define pgagetthreadindex_               _pgagetthreadindex_
+#define pgasetnumislands_                _pgasetnumislands_
+#define pgagetnumislands_                _pgagetnumislands_
+#define pgasetmigrationinterval_         _pgasetmigrationinterval_
+#define pgagetmigrationinterval_         _pgagetmigrationinterval_
+#define pgasetnummigrants_               _pgasetnummigrants_
+#define pgagetnummigrants_               _pgagetnummigrants_
+#define pgasetmigrationtopology_         _pgasetmigrationtopology_
+#define pgagetmigrationtopology_         _pgagetmigrationtopology_
 #define pgasetcommunicator_              _pgasetcommunicator_
 #define pgagetcommunicator_              _pgagetcommunicator_
 #define pgarun_                          _pgarun_
@@ -317,6 +348,7 @@ privately owned rights.
 #define pgagetmutationorcrossoverflag_   _pgagetmutationorcrossoverflag_
 #define pgagetmutationandcrossoverflag_  _pgagetmutationandcrossoverflag_
 #define pgasortpop_                      _pgasortpop_
+#define pgapartialsortpop_               _pgapartialsortpop_
 #define pgagetpopsize_                   _pgagetpopsize_
 #define pgagetnumreplacevalue_           _pgagetnumreplacevalue_
 #define pgagetpopreplacetype_            _pgagetpopreplacetype_
@@ -331,6 +363,8 @@ privately owned rights.
 #define pgarandomgaussian_               _pgarandomgaussian_
 #define pgagetrandomseed_                _pgagetrandomseed_
 #define pgasetrandomseed_                _pgasetrandomseed_
+#define pgagetrandomgenerator_           _pgagetrandomgenerator_
+#define pgasetrandomgenerator_           _pgasetrandomgenerator_
 #define pgasetrealallele_                _pgasetrealallele_
 #define pgagetrealallele_                _pgagetrealallele_
 #define pgasetrealinitpercent_           _pgasetrealinitpercent_
@@ -353,6 +387,8 @@ privately owned rights.
 #define pgagetrestartfrequencyvalue_     _pgagetrestartfrequencyvalue_
 #define pgasetrestartallelechangeprob_   _pgasetrestartallelechangeprob_
 #define pgagetrestartallelechangeprob_   _pgagetrestartallelechangeprob_
+#define pgasetcheckpointfrequencyvalue_  _pgasetcheckpointfrequencyvalue_
+#define pgagetcheckpointfrequencyvalue_  _pgagetcheckpointfrequencyvalue_
 #define pgaselect_                       _pgaselect_
 #define pgaselectnextindex_              _pgaselectnextindex_
 #define pgasetselecttype_                _pgasetselecttype_
@@ -396,6 +432,8 @@ privately owned rights.
 #define pgasetup_                        pgasetup
 #define pgasetrandominitflag_            pgasetrandominitflag
 #define pgagetrandominitflag_            pgagetrandominitflag
+#define pgasetcontiguouspopflag_         pgasetcontiguouspopflag
+#define pgagetcontiguouspopflag_         pgagetcontiguouspopflag
 #define pgacrossover_                    pgacrossover
 #define pgagetcrossovertype_             pgagetcrossovertype
 #define pgagetcrossoverprob_             pgagetcrossoverprob
@@ -462,6 +500,17 @@ privately owned rights.
 #define pgasendreceiveindividual_        pgasendreceiveindividual
 #define pgagetrank_                      pgagetrank
 #define pgagetnumprocs_                  pgagetnumprocs
+#define pgasetnumthreads_                pgasetnumthreads
+#define pgagetnumthreads_                pgagetnumthreads
+#define pgagetthreadindex_               pgagetthreadindex
+#define pgasetnumislands_                pgasetnumislands
+#define pgagetnumislands_                pgagetnumislands
+#define pgasetmigrationinterval_         pgasetmigrationinterval
+#define pgagetmigrationinterval_         pgagetmigrationinterval
+#define pgasetnummigrants_               pgasetnummigrants
+#define pgagetnummigrants_               pgagetnummigrants
+#define pgasetmigrationtopology_         pgasetmigrationtopology
+#define pgagetmigrationtopology_         pgagetmigrationtopology
 #define pgasetcommunicator_              pgasetcommunicator
 #define pgagetcommunicator_              pgagetcommunicator
 #define pgarun_                          pgarun
@@ -477,6 +526,7 @@ privately owned rights.
 #define pgagetmutationorcrossoverflag_   pgagetmutationorcrossoverflag
 #define pgagetmutationandcrossoverflag_  pgagetmutationandcrossoverflag
 #define pgasortpop_                      pgasortpop
+#define pgapartialsortpop_               pgapartialsortpop
 #define pgagetpopsize_                   pgagetpopsize
 #define pgagetnumreplacevalue_           pgagetnumreplacevalue
 #define pgagetpopreplacetype_            pgagetpopreplacetype
@@ -491,6 +541,8 @@ privately owned rights.
 #define pgarandomgaussian_               pgarandomgaussian
 #define pgagetrandomseed_                pgagetrandomseed
 #define pgasetrandomseed_                pgasetrandomseed
+#define pgagetrandomgenerator_           pgagetrandomgenerator
+#define pgasetrandomgenerator_           pgasetrandomgenerator
 #define pgasetrealallele_                pgasetrealallele
 #define pgagetrealallele_                pgagetrealallele
 #define pgasetrealinitpercent_           pgasetrealinitpercent
@@ -513,6 +565,8 @@ privately owned rights.
 #define pgagetrestartfrequencyvalue_     pgagetrestartfrequencyvalue
 #define pgasetrestartallelechangeprob_   pgasetrestartallelechangeprob
 #define pgagetrestartallelechangeprob_   pgagetrestartallelechangeprob
+#define pgasetcheckpointfrequencyvalue_  pgasetcheckpointfrequencyvalue
+#define pgagetcheckpointfrequencyvalue_  pgagetcheckpointfrequencyvalue
 #define pgaselect_                       pgaselect
 #define pgaselectnextindex_              pgaselectnextindex
 #define pgasetselecttype_                pgasetselecttype
@@ -559,6 +613,8 @@ unsigned long pgacreate_(int *datatype, int *len, int *maxormin);
 void pgasetup_(PGAContext **ftx);
 void pgasetrandominitflag_(PGAContext **ftx, int *RandomBoolean);
 int pgagetrandominitflag_(PGAContext **ftx);
+void pgasetcontiguouspopflag_(PGAContext **ftx, int *flag);
+int pgagetcontiguouspopflag_(PGAContext **ftx);
 void pgacrossover_(PGAContext **ftx, int *m1, int *m2, int *oldpop, int *t1,
      int *t2, int *newpop);
 int pgagetcrossovertype_(PGAContext **ftx);
@@ -641,6 +697,17 @@ void pgareceiveindividual_(PGAContext **ftx, int *p, int *pop, int *source, int
 void pgasendreceiveindividual_(PGAContext **ftx, int *send_p, int *send_pop, int *dest, int *send_tag, int *recv_p, int *recv_pop, int *source, int *recv_tag, MPI_Comm *comm, MPI_Status *status);
 int pgagetrank_(PGAContext **ftx, MPI_Comm *comm);
 int pgagetnumprocs_(PGAContext **ftx, MPI_Comm *comm);
+void pgasetnumthreads_(PGAContext **ftx, int *n);
+int pgagetnumthreads_(PGAContext **ftx);
+int pgagetthreadindex_(PGAContext **ftx);
+void pgasetnumislands_(PGAContext **ftx, int *n);
+int pgagetnumislands_(PGAContext **ftx);
+void pgasetmigrationinterval_(PGAContext **ftx, int *n);
+int pgagetmigrationinterval_(PGAContext **ftx);
+void pgasetnummigrants_(PGAContext **ftx, int *n);
+int pgagetnummigrants_(PGAContext **ftx);
+void pgasetmigrationtopology_(PGAContext **ftx, int *topology);
+int pgagetmigrationtopology_(PGAContext **ftx);
 void pgasetcommunicator_(PGAContext **ftx, MPI_Comm *comm);
 MPI_Comm pgagetcommunicator_(PGAContext **ftx);
 void pgarun_(PGAContext **ftx,
@@ -658,6 +725,7 @@ void pgasetmutationandcrossoverflag_(PGAContext **ftx, int *flag);
 int pgagetmutationorcrossoverflag_(PGAContext **ftx);
 int pgagetmutationandcrossoverflag_(PGAContext **ftx);
 void pgasortpop_(PGAContext **ftx, int *pop);
+void pgapartialsortpop_(PGAContext **ftx, int *pop, int *n);
 int pgagetpopsize_(PGAContext **ftx);
 int pgagetnumreplacevalue_(PGAContext **ftx);
 int pgagetpopreplacetype_(PGAContext **ftx);
@@ -672,6 +740,8 @@ double pgarandomuniform_(PGAContext **ftx, double *start, double *end);
 double pgarandomgaussian_(PGAContext **ftx, double *mean, double *sigma);
 int pgagetrandomseed_(PGAContext **ftx);
 void pgasetrandomseed_(PGAContext **ftx, int *seed);
+int pgagetrandomgenerator_(PGAContext **ftx);
+void pgasetrandomgenerator_(PGAContext **ftx, int *generator);
 void pgasetrealallele_(PGAContext **ftx, int *p, int *pop, int *i,
      double *val);
 double pgagetrealallele_(PGAContext **ftx, int *p, int *pop, int *i);
@@ -697,6 +767,8 @@ void pgasetrestartfrequencyvalue_(PGAContext **ftx, int *numiter);
 int pgagetrestartfrequencyvalue_(PGAContext **ftx);
 void pgasetrestartallelechangeprob_(PGAContext **ftx, double *prob);
 double pgagetrestartallelechangeprob_(PGAContext **ftx);
+void pgasetcheckpointfrequencyvalue_(PGAContext **ftx, int *freq);
+int pgagetcheckpointfrequencyvalue_(PGAContext **ftx);
 void pgaselect_(PGAContext **ftx, int *popix);
 int pgaselectnextindex_(PGAContext **ftx);
 void pgasetselecttype_(PGAContext **ftx, int *select_type);
@@ -805,6 +877,16 @@ int pgagetrandominitflag_(PGAContext **ftx)
      return PGAGetRandomInitFlag  (*ftx);
 }
 
+void pgasetcontiguouspopflag_(PGAContext **ftx, int *flag)
+{
+     PGASetContiguousPopFlag  (*ftx, *flag);
+}
+
+int pgagetcontiguouspopflag_(PGAContext **ftx)
+{
+     return PGAGetContiguousPopFlag  (*ftx);
+}
+
 void pgacrossover_(PGAContext **ftx, int *m1, int *m2, int *oldpop, int *t1,
      int *t2, int *newpop)
 {
@@ -1238,6 +1320,61 @@ int pgagetnumprocs_(PGAContext **ftx, MPI_Comm *comm)
      return PGAGetNumProcs  (*ftx, *comm);
 }
 
+void pgasetnumthreads_(PGAContext **ftx, int *n)
+{
+     PGASetNumThreads  (*ftx, *n);
+}
+
+int pgagetnumthreads_(PGAContext **ftx)
+{
+     return PGAGetNumThreads  (*ftx);
+}
+
+int pgagetthreadindex_(PGAContext **ftx)
+{
+     return PGAGetThreadIndex  (*ftx);
+}
+
+void pgasetnumislands_(PGAContext **ftx, int *n)
+{
+     PGASetNumIslands  (*ftx, *n);
+}
+
+int pgagetnumislands_(PGAContext **ftx)
+{
+     return PGAGetNumIslands  (*ftx);
+}
+
+void pgasetmigrationinterval_(PGAContext **ftx, int *n)
+{
+     PGASetMigrationInterval  (*ftx, *n);
+}
+
+int pgagetmigrationinterval_(PGAContext **ftx)
+{
+     return PGAGetMigrationInterval  (*ftx);
+}
+
+void pgasetnummigrants_(PGAContext **ftx, int *n)
+{
+     PGASetNumMigrants  (*ftx, *n);
+}
+
+int pgagetnummigrants_(PGAContext **ftx)
+{
+     return PGAGetNumMigrants  (*ftx);
+}
+
+void pgasetmigrationtopology_(PGAContext **ftx, int *topology)
+{
+     PGASetMigrationTopology  (*ftx, *topology);
+}
+
+int pgagetmigrationtopology_(PGAContext **ftx)
+{
+     return PGAGetMigrationTopology  (*ftx);
+}
+
 void pgasetcommunicator_(PGAContext **ftx, MPI_Comm *comm)
 {
      PGASetCommunicator  (*ftx, *comm);
@@ -1315,6 +1452,11 @@ void pgasortpop_(PGAContext **ftx, int *pop)
      PGASortPop  (*ftx, *pop);
 }
 
+void pgapartialsortpop_(PGAContext **ftx, int *pop, int *n)
+{
+     PGAPartialSortPop  (*ftx, *pop, *n);
+}
+
 int pgagetpopsize_(PGAContext **ftx)
 {
      return PGAGetPopSize  (*ftx);
@@ -1385,6 +1527,16 @@ void pgasetrandomseed_(PGAContext **ftx, int *seed)
      PGASetRandomSeed  (*ftx, *seed);
 }
 
+int pgagetrandomgenerator_(PGAContext **ftx)
+{
+     return PGAGetRandomGenerator  (*ftx);
+}
+
+void pgasetrandomgenerator_(PGAContext **ftx, int *generator)
+{
+     PGASetRandomGenerator  (*ftx, *generator);
+}
+
 void pgasetrealallele_(PGAContext **ftx, int *p, int *pop, int *i,
      double *val)
 {
@@ -1633,6 +1785,16 @@ double pgagetrestartallelechangeprob_(PGAContext **ftx)
      return PGAGetRestartAlleleChangeProb  (*ftx);
 }
 
+void pgasetcheckpointfrequencyvalue_(PGAContext **ftx, int *freq)
+{
+     PGASetCheckpointFrequencyValue  (*ftx, *freq);
+}
+
+int pgagetcheckpointfrequencyvalue_(PGAContext **ftx)
+{
+     return PGAGetCheckpointFrequencyValue  (*ftx);
+}
+
 void pgaselect_(PGAContext **ftx, int *popix)
 {
      PGASelect  (*ftx, *popix);
@@ -528,6 +528,7 @@ void PGAFitnessLinearNormal ( PGAContext *ctx, PGAIndividual *pop )
 
     int i;
     double K, sigma, mean;
+    PGASortItem *items = ctx->scratch.sortscratch;
 
     PGADebugEntered("PGAFitnessLinearNormal");
 
@@ -535,7 +536,8 @@ void PGAFitnessLinearNormal ( PGAContext *ctx, PGAIndividual *pop )
 
     for(i=0;i<ctx->ga.PopSize;i++) {
         ctx->scratch.dblscratch[i] = (pop+i)->fitness;
-        ctx->scratch.intscratch[i] =                i;
+        items[i].key = (pop+i)->fitness;
+        items[i].idx = i;
     }
 
     /* calculate parameters for linear normalization */
@@ -545,13 +547,12 @@ void PGAFitnessLinearNormal ( PGAContext *ctx, PGAIndividual *pop )
     if (sigma == 0)
          sigma = 1;
     K = sigma * (double) ctx->ga.PopSize;
-    PGADblHeapSort ( ctx, ctx->scratch.dblscratch,
-                  ctx->scratch.intscratch,
-                  ctx->ga.PopSize);
+    PGAPartialSort ( ctx, items, ctx->ga.PopSize, ctx->ga.PopSize );
+
+    /* the string in place i of the sorted array has rank i+1 */
 
     for( i=0; i<ctx->ga.PopSize; i++ )
-        (pop+i)->fitness = K - ( sigma *
-            (double) PGARank(ctx,i,ctx->scratch.intscratch,ctx->ga.PopSize) );
+        (pop+items[i].idx)->fitness = K - ( sigma * (double) (i+1) );
 
     PGADebugExited("PGAFitnessLinearNormal");
 }
@@ -578,6 +579,7 @@ void PGAFitnessLinearNormal ( PGAContext *ctx, PGAIndividual *pop )
 void PGAFitnessLinearRank ( PGAContext *ctx, PGAIndividual *pop )
 {
     double max, min, popsize, rpopsize;
+    PGASortItem *items = ctx->scratch.sortscratch;
     int i;
 
     PGADebugEntered("PGAFitnessLinearRank");
@@ -588,19 +590,18 @@ void PGAFitnessLinearRank ( PGAContext *ctx, PGAIndividual *pop )
     rpopsize = 1.0/popsize;
 
     for(i=0;i<ctx->ga.PopSize;i++) {
-        ctx->scratch.dblscratch[i] = (pop+i)->fitness;
-        ctx->scratch.intscratch[i] =                i;
+        items[i].key = (pop+i)->fitness;
+        items[i].idx = i;
     }
 
-    PGADblHeapSort ( ctx, ctx->scratch.dblscratch,
-                  ctx->scratch.intscratch,
-                  ctx->ga.PopSize);
+    PGAPartialSort ( ctx, items, ctx->ga.PopSize, ctx->ga.PopSize );
+
+    /* the string in place i of the sorted array has rank i+1 */
 
     for(i=0;i<ctx->ga.PopSize;i++) {
-        (pop+i)->fitness = rpopsize * ( max -
+        (pop+items[i].idx)->fitness = rpopsize * ( max -
         ( (max - min) *
-        ( ( (double) PGARank(ctx,i,ctx->scratch.intscratch,ctx->ga.PopSize)
-             - 1. ) / ( popsize - 1. ) ) ) );
+        ( (double) i / ( popsize - 1. ) ) ) );
 
     }
 
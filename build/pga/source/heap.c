@@ -213,3 +213,163 @@ void PGAIntHeapSort ( PGAContext *ctx, int *a, int *idx, int n )
 }
 
 
+/*  Whether item a goes before item b: the one with the larger key, or of
+ *  equal keys the one with the lower index.  No two items are equal, so
+ *  whatever order the items start in, they end up in the same order.
+ */
+#define PGASortBefore(a, b) \
+  ((a).key > (b).key || ((a).key == (b).key && (a).idx < (b).idx))
+
+#define PGASortSwap(a, i, j) {   \
+  PGASortItem t_ = (a)[i];       \
+  (a)[i] = (a)[j];               \
+  (a)[j] = t_;                   \
+}
+
+/*  Moves h[i] down the heap h[0..n-1], where no item goes after its
+ *  parent.  */
+static void SiftItem(PGASortItem *h, int i, int n)
+{
+  PGASortItem item = h[i];
+  int j;
+
+  for (j = 2*i+1; j < n; i = j, j = 2*i+1) {
+    if (j+1 < n && PGASortBefore(h[j], h[j+1]))
+      j++;
+    if (!PGASortBefore(item, h[j]))
+      break;
+    h[i] = h[j];
+  }
+  h[i] = item;
+}
+
+/*  Sorts a[0..n-1] by heapsort, for ranges quicksort does badly on.  */
+static void HeapSortItems(PGASortItem *a, int n)
+{
+  int i;
+
+  for (i = n/2-1; i >= 0; i--)
+    SiftItem(a, i, n);
+  for (i = n-1; i > 0; i--) {
+    PGASortSwap(a, 0, i);
+    SiftItem(a, 0, i);
+  }
+}
+
+static void InsertionSortItems(PGASortItem *a, int n)
+{
+  PGASortItem item;
+  int i, j;
+
+  for (i = 1; i < n; i++) {
+    item = a[i];
+    for (j = i; j > 0 && PGASortBefore(item, a[j-1]); j--)
+      a[j] = a[j-1];
+    a[j] = item;
+  }
+}
+
+/*  Partitions a[0..n-1], n > 3, around the median of its first, middle and
+ *  last items, and returns where that ends up.  */
+static int PartitionItems(PGASortItem *a, int n)
+{
+  PGASortItem pivot;
+  int mid = n/2, i, j;
+
+  if (PGASortBefore(a[mid], a[0]))
+    PGASortSwap(a, 0, mid);
+  if (PGASortBefore(a[n-1], a[mid])) {
+    PGASortSwap(a, mid, n-1);
+    if (PGASortBefore(a[mid], a[0]))
+      PGASortSwap(a, 0, mid);
+  }
+  /*  a[0] and a[n-1] now stop the scans below.  */
+  PGASortSwap(a, mid, n-2);
+  pivot = a[n-2];
+  i = 0;
+  j = n-2;
+  for (;;) {
+    do
+      i++;
+    while (PGASortBefore(a[i], pivot));
+    do
+      j--;
+    while (PGASortBefore(pivot, a[j]));
+    if (i >= j)
+      break;
+    PGASortSwap(a, i, j);
+  }
+  PGASortSwap(a, i, n-2);
+  return(i);
+}
+
+static void PartialSortItems(PGASortItem *a, int n, int k, int depth)
+{
+  int p;
+
+  while (n > 16 && k > 0) {
+    if (depth-- == 0) {
+      HeapSortItems(a, n);
+      return;
+    }
+    p = PartitionItems(a, n);
+    if (p+1 < k)
+      PartialSortItems(a+p+1, n-p-1, k-p-1, depth);
+    n = p;
+  }
+  if (k > 0)
+    InsertionSortItems(a, n);
+}
+
+
+/*I****************************************************************************
+   PGAPartialSort - Puts the k items of a with the largest keys first, in
+   decreasing order of key, and of index among items of the same key.  The
+   other items follow in no particular order.  Takes time proportional to
+   n + k log k, so that finding the best few of a large population is
+   cheaper than sorting it.  With k equal to n, sorts the whole array.  As
+   the index breaks ties, the result does not depend on the order the items
+   were in.
+
+   Category: Sorting
+
+   Inputs:
+       ctx      - context variable
+       a        - array of items, each a key and an index
+       n        - size of the array a
+       k        - how many of the items to put in order
+
+   Output:
+       The array a, with its first k items in order
+
+   Example:
+      The following code finds the ten strings of highest fitness
+
+      PGAContext *ctx;
+      PGASortItem *a;
+      int i, n;
+      :
+      n = PGAGetPopSize(ctx);
+      for(i=0;i<n;i++) {
+        a[i].key = PGAGetFitness(ctx, i, PGA_OLDPOP);
+        a[i].idx = i;
+      }
+      PGAPartialSort(ctx, a, n, 10);
+
+****************************************************************************I*/
+void PGAPartialSort(PGAContext *ctx, PGASortItem *a, int n, int k)
+{
+  int depth, i;
+
+    PGADebugEntered("PGAPartialSort");
+
+  /*  Give up on quicksort for heapsort past twice the depth it should
+   *  need, as introsort does.  */
+  for (depth = 0, i = n; i > 1; i /= 2)
+    depth += 2;
+  if (k > n)
+    k = n;
+  PartialSortItems(a, n, k, depth);
+
+    PGADebugExited("PGAPartialSort");
+}
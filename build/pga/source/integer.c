@@ -71,7 +71,7 @@ privately owned rights.
       PGASetIntegerAllele (ctx, p, PGA_NEWPOP, i, 64)
 
 ****************************************************************************U*/
-void PGASetIntegerAllele (PGAContext *ctx, int p, int pop, int i, int value)
+void (PGASetIntegerAllele) (PGAContext *ctx, int p, int pop, int i, int value)
 {
     PGAIndividual *ind;
     PGAInteger     *chrom;
@@ -110,7 +110,7 @@ void PGASetIntegerAllele (PGAContext *ctx, int p, int pop, int i, int value)
       k =  PGAGetIntegerAllele ( ctx, p, PGA_NEWPOP, i )
 
 ****************************************************************************U*/
-int PGAGetIntegerAllele (PGAContext *ctx, int p, int pop, int i)
+int (PGAGetIntegerAllele) (PGAContext *ctx, int p, int pop, int i)
 {
     PGAIndividual *ind;
     PGAInteger     *chrom;
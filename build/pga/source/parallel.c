@@ -43,10 +43,45 @@ privately owned rights.
 *              Brian P. Walenz
 ******************************************************************************/
 
+#include <pthread.h>
+
 #include "pgapack.h"
 
 #define DEBUG_EVAL 0
 
+/*  The pool of threads of PGAEvaluateThreads.  The thread calling
+ *  PGAEvaluate takes part as well, as thread 0.
+ */
+typedef struct PGAThreadPool PGAThreadPool;
+
+typedef struct {
+    PGAThreadPool   *pool;
+    int              index;       /* what PGAGetThreadIndex returns     */
+    pthread_t        id;
+} PGAThread;
+
+struct PGAThreadPool {
+    int              nthreads;
+    PGAThread       *thread;      /* [0] is the calling thread          */
+    pthread_mutex_t  lock;
+    pthread_cond_t   start, done;
+    int              job;         /* bumped for each population         */
+    int              busy;        /* threads still working on it        */
+    int              quit;        /* set by PGAStopThreads              */
+    PGAContext      *ctx;
+    int              pop;
+    double         (*f)(PGAContext *, int, int);
+    int              next;        /* next string to take                */
+};
+
+static pthread_key_t  ThreadKey;
+static pthread_once_t ThreadKeyOnce = PTHREAD_ONCE_INIT;
+
+static void MakeThreadKey(void)
+{
+    pthread_key_create(&ThreadKey, NULL);
+}
+
 /*U****************************************************************************
   PGARunGM - High-level routine to execute the genetic algorithm using the
   global model.  It is called after PGACreate and PGASetup have been called.
@@ -405,6 +440,117 @@ void PGAEvaluateSlave(PGAContext *ctx, int pop,
 }
 
 
+/*  Evaluates strings of the population the pool is working on until there
+ *  are none left.
+ */
+static void EvaluateSome(PGAThreadPool *pool)
+{
+    PGAContext *ctx = pool->ctx;
+    int         pop = pool->pop;
+    int         p, fp;
+    double      e;
+
+    for (;;) {
+	pthread_mutex_lock(&pool->lock);
+	p = pool->next++;
+	pthread_mutex_unlock(&pool->lock);
+	if (p >= ctx->ga.PopSize)
+	    break;
+
+	if (!PGAGetEvaluationUpToDateFlag(ctx, p, pop)) {
+	    if (ctx->sys.UserFortran == PGA_TRUE) {
+		fp = p + 1;
+		e = (*((double(*)(void *, void *, void *))pool->f))
+		    (&ctx, &fp, &pop);
+	    } else {
+		e = (*pool->f)(ctx, p, pop);
+	    }
+	    PGASetEvaluation(ctx, p, pop, e);
+	}
+    }
+}
+
+static void *PoolThread(void *arg)
+{
+    PGAThread     *self = (PGAThread *)arg;
+    PGAThreadPool *pool = self->pool;
+    int            job = 0;
+
+    pthread_setspecific(ThreadKey, self);
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+	while (pool->job == job && !pool->quit)
+	    pthread_cond_wait(&pool->start, &pool->lock);
+	if (pool->quit)
+	    break;
+	job = pool->job;
+	pthread_mutex_unlock(&pool->lock);
+
+	EvaluateSome(pool);
+
+	pthread_mutex_lock(&pool->lock);
+	if (--pool->busy == 0)
+	    pthread_cond_signal(&pool->done);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    return(NULL);
+}
+
+
+/*I****************************************************************************
+   PGAEvaluateThreads - Internal evaluation function.  Evaluates all strings
+   that need to be evaluated on the threads started by PGASetUp, see
+   PGASetNumThreads.  The calling thread evaluates strings too.  Each thread
+   takes the next string not taken yet until there are none left, so that a
+   slow evaluation does not hold up the others.  If there are no threads,
+   does what PGAEvaluateSeq does.
+
+   Category: Fitness & Evaluation
+
+   Inputs:
+      ctx  - context variable
+      pop  - symbolic constant of the population to be evaluated
+      f    - a pointer to a function to evaluate a string.
+
+   Outputs:
+
+   Example:
+
+****************************************************************************I*/
+void PGAEvaluateThreads(PGAContext *ctx, int pop,
+			double (*f)(PGAContext *, int, int))
+{
+    PGAThreadPool *pool = (PGAThreadPool *)ctx->par.ThreadPool;
+
+    PGADebugEntered("PGAEvaluateThreads");
+
+    if (pool == NULL) {
+	PGAEvaluateSeq(ctx, pop, f);
+    } else {
+	pthread_mutex_lock(&pool->lock);
+	pool->ctx  = ctx;
+	pool->pop  = pop;
+	pool->f    = f;
+	pool->next = 0;
+	pool->busy = pool->nthreads - 1;
+	pool->job++;
+	pthread_cond_broadcast(&pool->start);
+	pthread_mutex_unlock(&pool->lock);
+
+	EvaluateSome(pool);
+
+	pthread_mutex_lock(&pool->lock);
+	while (pool->busy > 0)
+	    pthread_cond_wait(&pool->done, &pool->lock);
+	pthread_mutex_unlock(&pool->lock);
+    }
+
+    PGADebugExited("PGAEvaluateThreads");
+}
+
+
 /*U****************************************************************************
    PGAEvaluate - Calls a user-specified function to return an evaluation of
    each string in the population. The user-specified function is only called
@@ -451,7 +597,9 @@ void PGAEvaluate(PGAContext *ctx, int pop,
     size = PGAGetNumProcs(ctx, comm);
 
     if (rank == 0) {
-	if (size == 1)
+	if (size == 1 && ctx->par.NumThreads > 1)
+	    PGAEvaluateThreads(ctx, pop, f);
+	else if (size == 1)
 	    PGAEvaluateSeq(ctx, pop, f);
 	if (size == 2)
 	    PGAEvaluateCoop(ctx, pop, f, comm);
@@ -638,8 +786,347 @@ void PGASendReceiveIndividual(PGAContext *ctx, int send_p, int send_pop,
 }
 
 
-/*I****************************************************************************
-  PGARunIM - Execute the island model genetic algorithm
+/*  The island model, run on threads.  Each island is a copy of the context
+ *  with populations, scratch space and a stream of random numbers of its
+ *  own, run on a thread of its own.  Migrants go through a link for each
+ *  pair of islands the topology joins.  At its n-th migration an island
+ *  first takes in what was sent to it at the (n-1)-th, then sends its best
+ *  strings for the n-th, so it only waits for an island more than a
+ *  migration behind it.  As what an island takes in does not depend on how
+ *  the threads ran, a run gives the same result every time.
+ */
+typedef struct PGAIsland PGAIsland;
+
+typedef struct {
+    PGAIsland       *from, *to;
+    PGAIndividual   *migrants[2]; /* for odd and even migrations        */
+    int              sent[2];     /* the migration they were sent at    */
+    int              taken[2];    /* the migration they were taken in at */
+} PGAMigrationLink;
+
+struct PGAIsland {
+    PGAContext         *ctx;
+    PGAThread           thread;   /* its index is the island's          */
+    double            (*f)(PGAContext *, int, int);
+    PGAMigrationLink  **in, **out;
+    int                 nin, nout;
+    int                 done;     /* set when its GA has stopped        */
+    pthread_mutex_t    *lock;     /* one for all the islands            */
+    pthread_cond_t     *changed;
+};
+
+
+/*  Copies string p of the array of individuals from to string q of the
+ *  array to, both of ctx's format, through a copy of ctx with them in place
+ *  of its populations, so that the user's copy function can be used.
+ */
+static void CopyAcross(PGAContext *ctx, PGAIndividual *from, int p,
+		       PGAIndividual *to, int q)
+{
+    PGAContext view = *ctx;
+
+    view.ga.oldpop = from;
+    view.ga.newpop = to;
+    PGACopyIndividual(&view, p, PGA_OLDPOP, q, PGA_NEWPOP);
+}
+
+/*  Allocates n individuals to hold migrants, which are not part of a
+ *  population, so are never in one block.
+ */
+static PGAIndividual *CreateMigrants(PGAContext *ctx, int n)
+{
+    PGAContext     view = *ctx;
+    PGAIndividual *ind;
+    int            m;
+
+    ind = (PGAIndividual *)malloc(n * sizeof(PGAIndividual));
+    if (ind == NULL)
+	PGAError(ctx, "PGARunIM: No room to allocate migrants",
+		 PGA_FATAL, PGA_VOID, NULL);
+    view.init.ContiguousPop = PGA_FALSE;
+    view.ga.newpop = ind;
+    for (m = 0; m < n; m++)
+	PGACreateIndividual(&view, m, PGA_NEWPOP, PGA_FALSE);
+
+    return(ind);
+}
+
+static void FreeMigrants(PGAIndividual *ind, int n)
+{
+    int m;
+
+    for (m = 0; m < n; m++)
+	free(ind[m].chrom);
+    free(ind);
+}
+
+/*  Makes island i out of ctx, allocating what PGASetUp allocates.  Island
+ *  0 carries on from ctx's population and random numbers, the others start
+ *  from populations of their own, created from a random number stream of
+ *  their own.  Only island 0 calls the user's end of generation function,
+ *  and no island keeps checkpoints or has threads of its own.
+ */
+static PGAContext *CreateIsland(PGAContext *ctx, int i)
+{
+    PGAContext *island;
+    int         p;
+
+    island = (PGAContext *)malloc(sizeof(PGAContext));
+    if (island == NULL)
+	PGAError(ctx, "PGARunIM: No room to allocate island",
+		 PGA_FATAL, PGA_INT, (void *) &i);
+    *island = *ctx;
+
+    island->par.NumThreads     = 1;
+    island->par.ThreadPool     = NULL;
+    island->rep.CheckpointFile = NULL;
+    island->init.ResumeFile    = NULL;
+    if (i > 0) {
+	island->cops.EndOfGen = NULL;
+	island->fops.EndOfGen = NULL;
+	PGARandomSubstream(ctx, i, &island->random);
+    } else
+	island->init.RandomInit = PGA_FALSE;
+
+    island->ga.selected = (int *)malloc(sizeof(int) * ctx->ga.PopSize);
+    island->ga.sorted   = (int *)malloc(sizeof(int) * ctx->ga.PopSize);
+    island->ga.dup.slot = (PGADuplicateSlot *)
+	calloc(ctx->ga.dup.size, sizeof(PGADuplicateSlot));
+    island->scratch.intscratch = (int *)malloc(sizeof(int) * ctx->ga.PopSize);
+    island->scratch.dblscratch =
+	(double *)malloc(sizeof(double) * ctx->ga.PopSize);
+    island->scratch.sortscratch =
+	(PGASortItem *)malloc(sizeof(PGASortItem) * ctx->ga.PopSize);
+    if (island->ga.selected == NULL || island->ga.sorted == NULL ||
+	island->ga.dup.slot == NULL || island->scratch.intscratch == NULL ||
+	island->scratch.dblscratch == NULL || island->scratch.sortscratch == NULL)
+	PGAError(ctx, "PGARunIM: No room to allocate island",
+		 PGA_FATAL, PGA_INT, (void *) &i);
+    island->ga.dup.stamp  = 0;
+    island->ga.dup.pop    = PGA_NEWPOP;
+    island->ga.dup.n      = 0;
+    island->ga.dup.usable = PGA_FALSE;
+
+    PGACreatePop(island, PGA_OLDPOP);
+    PGACreatePop(island, PGA_NEWPOP);
+
+    if (i == 0) {
+	for (p = 0; p < ctx->ga.PopSize; p++)
+	    CopyAcross(ctx, ctx->ga.oldpop, p, island->ga.oldpop, p);
+	island->init.RandomInit = ctx->init.RandomInit;
+    }
+
+    return(island);
+}
+
+static void DestroyIsland(PGAContext *island)
+{
+    int p;
+
+    if (island->init.ContiguousPop == PGA_TRUE) {
+	free(island->ga.oldpop[0].chrom);
+	free(island->ga.newpop[0].chrom);
+    } else
+	for (p = 0; p < island->ga.PopSize + 2; p++) {
+	    free(island->ga.oldpop[p].chrom);
+	    free(island->ga.newpop[p].chrom);
+	}
+    free(island->ga.oldpop);
+    free(island->ga.newpop);
+    free(island->scratch.intscratch);
+    free(island->scratch.dblscratch);
+    free(island->scratch.sortscratch);
+    free(island->ga.selected);
+    free(island->ga.sorted);
+    free(island->ga.dup.slot);
+    free(island);
+}
+
+/*  Puts in pick the indices of the n best strings of PGA_OLDPOP, or, if
+ *  worst is set, of the n worst, by evaluation.  Of strings evaluated the
+ *  same, the one with the lower index comes first.
+ */
+static void PickStrings(PGAContext *ctx, int n, int worst, int *pick)
+{
+    PGAIndividual *pop = ctx->ga.oldpop;
+    int           *taken = ctx->scratch.intscratch;
+    int            i, p, b, better;
+
+    for (p = 0; p < ctx->ga.PopSize; p++)
+	taken[p] = PGA_FALSE;
+
+    for (i = 0; i < n; i++) {
+	b = -1;
+	for (p = 0; p < ctx->ga.PopSize; p++) {
+	    if (taken[p])
+		continue;
+	    if (b < 0) {
+		b = p;
+		continue;
+	    }
+	    if (ctx->ga.optdir == PGA_MAXIMIZE)
+		better = pop[p].evalfunc > pop[b].evalfunc;
+	    else
+		better = pop[p].evalfunc < pop[b].evalfunc;
+	    if (worst)
+		better = !better && pop[p].evalfunc != pop[b].evalfunc;
+	    if (better)
+		b = p;
+	}
+	taken[b] = PGA_TRUE;
+	pick[i]  = b;
+    }
+}
+
+/*  The n-th migration of island me.  Takes in the migrants sent to it at
+ *  the (n-1)-th in place of its worst strings, then sends copies of its
+ *  best to the islands it sends to.  Neither waits for an island whose GA
+ *  has stopped.
+ */
+static void Migrate(PGAIsland *me, int n)
+{
+    PGAContext        *ctx = me->ctx;
+    PGAMigrationLink  *link;
+    int                nmig = ctx->par.NumMigrants;
+    int               *pick, i, j, k, b, ready;
+
+    pick = (int *)malloc(sizeof(int) * nmig * (me->nin > 1 ? me->nin : 1));
+    if (pick == NULL)
+	PGAError(ctx, "PGARunIM: No room to allocate migrants",
+		 PGA_FATAL, PGA_VOID, NULL);
+
+    /*  Take in the last migration's migrants.  */
+    if (n > 1) {
+	b = (n - 1) % 2;
+	PickStrings(ctx, nmig * me->nin, PGA_TRUE, pick);
+	k = 0;
+	for (i = 0; i < me->nin; i++) {
+	    link = me->in[i];
+	    pthread_mutex_lock(me->lock);
+	    while (link->sent[b] != n - 1 && !link->from->done)
+		pthread_cond_wait(me->changed, me->lock);
+	    ready = link->sent[b] == n - 1;
+	    pthread_mutex_unlock(me->lock);
+	    if (!ready)
+		continue;
+
+	    for (j = 0; j < nmig; j++) {
+		CopyAcross(ctx, link->migrants[b], j, ctx->ga.oldpop,
+			   PGA_TEMP1);
+		if (ctx->ga.NoDuplicates &&
+		    PGADuplicate(ctx, PGA_TEMP1, PGA_OLDPOP, PGA_OLDPOP,
+				 ctx->ga.PopSize))
+		    continue;
+		PGACopyIndividual(ctx, PGA_TEMP1, PGA_OLDPOP, pick[k++],
+				  PGA_OLDPOP);
+	    }
+
+	    pthread_mutex_lock(me->lock);
+	    link->taken[b] = n - 1;
+	    pthread_cond_broadcast(me->changed);
+	    pthread_mutex_unlock(me->lock);
+	}
+	if (k > 0)
+	    PGAFitness(ctx, PGA_OLDPOP);
+    }
+
+    /*  Send this one's, once the migrants sent two migrations ago have
+     *  been taken in.  */
+    b = n % 2;
+    PickStrings(ctx, nmig, PGA_FALSE, pick);
+    for (i = 0; i < me->nout; i++) {
+	link = me->out[i];
+	pthread_mutex_lock(me->lock);
+	while (link->sent[b] != link->taken[b] && !link->to->done)
+	    pthread_cond_wait(me->changed, me->lock);
+	ready = !link->to->done;
+	pthread_mutex_unlock(me->lock);
+	if (!ready)
+	    continue;
+
+	for (j = 0; j < nmig; j++)
+	    CopyAcross(ctx, ctx->ga.oldpop, pick[j], link->migrants[b], j);
+
+	pthread_mutex_lock(me->lock);
+	link->sent[b] = n;
+	pthread_cond_broadcast(me->changed);
+	pthread_mutex_unlock(me->lock);
+    }
+
+    free(pick);
+}
+
+/*  Runs the GA of an island, as PGARunGM does with one process, with a
+ *  migration every MigrationInterval generations.  Only island 0 prints
+ *  reports.
+ */
+static void *RunIsland(void *arg)
+{
+    PGAIsland  *me  = (PGAIsland *)arg;
+    PGAContext *ctx = me->ctx;
+    int         Restarted;
+    void      (*CreateNewGeneration)(PGAContext *, int, int);
+
+    if (me->thread.index > 0)
+	pthread_setspecific(ThreadKey, &me->thread);
+
+    PGAEvaluate(ctx, PGA_OLDPOP, me->f, NULL);
+    PGAFitness(ctx, PGA_OLDPOP);
+
+    if (PGAGetMutationOrCrossoverFlag(ctx))
+	CreateNewGeneration = PGARunMutationOrCrossover;
+    else
+	CreateNewGeneration = PGARunMutationAndCrossover;
+
+    while (!PGADone(ctx, NULL)) {
+	Restarted = PGA_FALSE;
+	if ((ctx->ga.restart == PGA_TRUE) &&
+	    (ctx->ga.ItersOfSame % ctx->ga.restartFreq == 0)) {
+	    ctx->ga.ItersOfSame++;
+	    Restarted = PGA_TRUE;
+	    PGARestart(ctx, PGA_OLDPOP, PGA_NEWPOP);
+	} else {
+	    PGASelect(ctx, PGA_OLDPOP);
+	    CreateNewGeneration(ctx, PGA_OLDPOP, PGA_NEWPOP);
+	}
+
+	PGAEvaluate(ctx, PGA_NEWPOP, me->f, NULL);
+	PGAFitness(ctx, PGA_NEWPOP);
+
+	if (!Restarted) {
+	    PGAUpdateGeneration(ctx, NULL);
+	    if (me->thread.index == 0)
+		PGAPrintReport(ctx, stdout, PGA_OLDPOP);
+	    if (ctx->ga.iter % ctx->par.MigrationInterval == 0)
+		Migrate(me, ctx->ga.iter / ctx->par.MigrationInterval);
+	}
+    }
+
+    pthread_mutex_lock(me->lock);
+    me->done = PGA_TRUE;
+    pthread_cond_broadcast(me->changed);
+    pthread_mutex_unlock(me->lock);
+
+    return(NULL);
+}
+
+
+/*U****************************************************************************
+  PGARunIM - Execute the island model genetic algorithm.  Called by PGARun
+  when PGASetNumIslands has set more than one island.  The islands are run
+  on threads of one process, each with its own population of PopSize
+  strings.  Island 0 starts from the population PGASetUp created, and the
+  others from populations of their own.  Every MigrationInterval
+  generations, each island sends copies of its NumMigrants best strings to
+  the islands the topology has it send to (see PGASetMigrationTopology),
+  and takes in, in place of its worst strings, the ones sent to it a
+  migration before.  Each island stops on its own stopping rule, and
+  PGARunIM returns when all have.  Only island 0 prints reports and calls
+  the user's end of generation function.  The evaluation function is called
+  from all the islands' threads at once, PGAGetThreadIndex telling them
+  apart.  At the end, the population of island 0, with the best string of
+  all the islands in place of its worst if it is not already there, is left
+  in PGA_OLDPOP of ctx.
 
   Category: Parallel
 
@@ -655,22 +1142,132 @@ void PGASendReceiveIndividual(PGAContext *ctx, int send_p, int send_pop,
   Example:
     PGAContext *ctx,
     double f(PGAContext *ctx, int p, int pop);
-    MPI_Comm comm;
     :
-    PGARunIM(ctx, f, comm);
+    ctx = PGACreate(&argc, argv, PGA_DATATYPE_BINARY, 100, PGA_MAXIMIZE);
+    PGASetNumIslands(ctx, 4);
+    PGASetUp(ctx);
+    PGARunIM(ctx, f, PGAGetCommunicator(ctx));
 
-****************************************************************************I*/
+****************************************************************************U*/
 void PGARunIM(PGAContext *ctx, double (*f)(PGAContext *c, int p, int pop),
               MPI_Comm tcomm)
 {
-    /* Based on ctx->par.topology this routine will need to create the
-       appropriate communicator out of tcomm
-    */
-    
-     PGADebugEntered("PGARunIM");
-     PGAError (ctx, "PGARunIM: Island model not implemented",
-               PGA_FATAL, PGA_VOID, NULL);
-     PGADebugExited("PGARunIM");
+    PGAIsland        *island;
+    PGAMigrationLink *link;
+    pthread_mutex_t   lock;
+    pthread_cond_t    changed;
+    int               n, nlinks, nmig, i, j, l, best_i, best_p, p;
+    double            e, best_e;
+
+    PGADebugEntered("PGARunIM");
+
+    n    = ctx->par.NumIslands;
+    nmig = ctx->par.NumMigrants;
+    if (ctx->par.Topology == PGA_TOPOLOGY_COMPLETE)
+	nlinks = n * (n - 1);
+    else
+	nlinks = n;
+
+    pthread_once(&ThreadKeyOnce, MakeThreadKey);
+    pthread_mutex_init(&lock, NULL);
+    pthread_cond_init(&changed, NULL);
+
+    island = (PGAIsland *)calloc(n, sizeof(PGAIsland));
+    link   = (PGAMigrationLink *)calloc(nlinks, sizeof(PGAMigrationLink));
+    if (island == NULL || link == NULL)
+	PGAError(ctx, "PGARunIM: No room to allocate islands",
+		 PGA_FATAL, PGA_VOID, NULL);
+    for (i = 0; i < n; i++) {
+	island[i].ctx          = CreateIsland(ctx, i);
+	island[i].thread.index = i;
+	island[i].f            = f;
+	island[i].lock         = &lock;
+	island[i].changed      = &changed;
+	island[i].in  = (PGAMigrationLink **)malloc(n * sizeof(PGAMigrationLink *));
+	island[i].out = (PGAMigrationLink **)malloc(n * sizeof(PGAMigrationLink *));
+	if (island[i].in == NULL || island[i].out == NULL)
+	    PGAError(ctx, "PGARunIM: No room to allocate islands",
+		     PGA_FATAL, PGA_VOID, NULL);
+    }
+
+    /*  Join the islands.  */
+    l = 0;
+    for (i = 0; i < n; i++)
+	for (j = 0; j < n; j++) {
+	    if (j == i)
+		continue;
+	    if (ctx->par.Topology != PGA_TOPOLOGY_COMPLETE && j != (i + 1) % n)
+		continue;
+	    link[l].from = &island[i];
+	    link[l].to   = &island[j];
+	    link[l].migrants[0] = CreateMigrants(ctx, nmig);
+	    link[l].migrants[1] = CreateMigrants(ctx, nmig);
+	    island[i].out[island[i].nout++] = &link[l];
+	    island[j].in[island[j].nin++]   = &link[l];
+	    l++;
+	}
+    nlinks = l;
+
+    /*  Island 0 is run by this thread, the others by threads of their own.  */
+    for (i = 1; i < n; i++)
+	if (pthread_create(&island[i].thread.id, NULL, RunIsland,
+			   &island[i]) != 0)
+	    PGAError(ctx, "PGARunIM: Cannot start thread for island",
+		     PGA_FATAL, PGA_INT, (void *) &i);
+    RunIsland(&island[0]);
+    for (i = 1; i < n; i++)
+	pthread_join(island[i].thread.id, NULL);
+
+    /*  Leave island 0's GA, and the best string found, in ctx.  */
+    best_i = 0;
+    best_p = PGAGetBestIndex(island[0].ctx, PGA_OLDPOP);
+    best_e = PGAGetEvaluation(island[0].ctx, best_p, PGA_OLDPOP);
+    for (i = 1; i < n; i++) {
+	p = PGAGetBestIndex(island[i].ctx, PGA_OLDPOP);
+	e = PGAGetEvaluation(island[i].ctx, p, PGA_OLDPOP);
+	if (ctx->ga.optdir == PGA_MAXIMIZE ? e > best_e : e < best_e) {
+	    best_i = i;
+	    best_p = p;
+	    best_e = e;
+	}
+    }
+    for (p = 0; p < ctx->ga.PopSize; p++)
+	CopyAcross(ctx, island[0].ctx->ga.oldpop, p, ctx->ga.oldpop, p);
+    if (best_i != 0)
+	CopyAcross(ctx, island[best_i].ctx->ga.oldpop, best_p, ctx->ga.oldpop,
+		   PGAGetWorstIndex(ctx, PGA_OLDPOP));
+    PGAFitness(ctx, PGA_OLDPOP);
+    ctx->ga.iter        = island[0].ctx->ga.iter;
+    ctx->ga.ItersOfSame = island[0].ctx->ga.ItersOfSame;
+    ctx->ga.PercentSame = island[0].ctx->ga.PercentSame;
+    ctx->rep.Online     = island[0].ctx->rep.Online;
+    ctx->rep.Offline    = island[0].ctx->rep.Offline;
+    ctx->rep.Best       = island[0].ctx->rep.Best;
+    ctx->rep.Average    = island[0].ctx->rep.Average;
+    ctx->random         = island[0].ctx->random;
+
+    for (l = 0; l < nlinks; l++) {
+	FreeMigrants(link[l].migrants[0], nmig);
+	FreeMigrants(link[l].migrants[1], nmig);
+    }
+    for (i = 0; i < n; i++) {
+	DestroyIsland(island[i].ctx);
+	free(island[i].in);
+	free(island[i].out);
+    }
+    free(link);
+    free(island);
+    pthread_cond_destroy(&changed);
+    pthread_mutex_destroy(&lock);
+
+    best_p = PGAGetBestIndex(ctx, PGA_OLDPOP);
+    printf("The Best Evaluation: %e.\n",
+	   PGAGetEvaluation(ctx, best_p, PGA_OLDPOP));
+    printf("The Best String:\n");
+    PGAPrintString(ctx, stdout, best_p, PGA_OLDPOP);
+    fflush(stdout);
+
+    PGADebugExited("PGARunIM");
 }
 
 
@@ -793,8 +1390,8 @@ int PGAGetNumProcs (PGAContext *ctx, MPI_Comm comm)
 
 /*I****************************************************************************
    PGASetNumIslands - Set the number of islands to use in an island model
-   GA. The default is one.  Currently must be the same as the number of
-   processes in the default communicator.  
+   GA. The default is one.  The islands are run on threads of one process,
+   see PGARunIM; the threads of PGASetNumThreads are not used.
 
    Category: Parallel
 
@@ -927,6 +1524,422 @@ int PGAGetNumDemes (PGAContext *ctx)
 }
 
 
+/*U****************************************************************************
+   PGASetMigrationInterval - Set how many generations an island of an island
+   model GA runs between migrations.  The default is 10.
+
+   Category: Parallel
+
+   Inputs:
+      ctx - context variable
+      n   - generations between migrations
+
+   Outputs:
+      None
+
+   Example:
+      PGAContext *ctx;
+      :
+      PGASetNumIslands(ctx, 4);
+      PGASetMigrationInterval(ctx, 25);
+
+****************************************************************************U*/
+void PGASetMigrationInterval( PGAContext *ctx, int n)
+{
+    PGADebugEntered("PGASetMigrationInterval");
+    PGAFailIfSetUp("PGASetMigrationInterval");
+
+    if ( n < 1 )
+        PGAError(ctx, "PGASetMigrationInterval: Invalid value of n:",
+                 PGA_FATAL, PGA_INT, (void *) &n);
+
+    ctx->par.MigrationInterval = n;
+
+    PGADebugExited("PGASetMigrationInterval");
+}
+
+
+/*U***************************************************************************
+   PGAGetMigrationInterval - Returns the number of generations an island
+   runs between migrations
+
+   Category: Parallel
+
+   Inputs:
+      ctx - context variable
+
+   Outputs:
+      The number of generations between migrations
+
+   Example:
+      PGAContext *ctx;
+      int interval;
+      :
+      interval = PGAGetMigrationInterval(ctx);
+
+***************************************************************************U*/
+int PGAGetMigrationInterval (PGAContext *ctx)
+{
+    PGADebugEntered("PGAGetMigrationInterval");
+    PGAFailIfNotSetUp("PGAGetMigrationInterval");
+
+    PGADebugExited("PGAGetMigrationInterval");
+
+    return(ctx->par.MigrationInterval);
+}
+
+
+/*U****************************************************************************
+   PGASetNumMigrants - Set how many of its best strings an island of an
+   island model GA sends to each island it sends to at a migration.  The
+   default is one.  What an island takes in at once must be fewer than
+   PopSize strings.
+
+   Category: Parallel
+
+   Inputs:
+      ctx - context variable
+      n   - number of strings sent
+
+   Outputs:
+      None
+
+   Example:
+      PGAContext *ctx;
+      :
+      PGASetNumIslands(ctx, 4);
+      PGASetNumMigrants(ctx, 2);
+
+****************************************************************************U*/
+void PGASetNumMigrants( PGAContext *ctx, int n)
+{
+    PGADebugEntered("PGASetNumMigrants");
+    PGAFailIfSetUp("PGASetNumMigrants");
+
+    if ( n < 1 )
+        PGAError(ctx, "PGASetNumMigrants: Invalid value of n:",
+                 PGA_FATAL, PGA_INT, (void *) &n);
+
+    ctx->par.NumMigrants = n;
+
+    PGADebugExited("PGASetNumMigrants");
+}
+
+
+/*U***************************************************************************
+   PGAGetNumMigrants - Returns the number of strings an island sends to each
+   island it sends to at a migration
+
+   Category: Parallel
+
+   Inputs:
+      ctx - context variable
+
+   Outputs:
+      The number of strings sent
+
+   Example:
+      PGAContext *ctx;
+      int nmig;
+      :
+      nmig = PGAGetNumMigrants(ctx);
+
+***************************************************************************U*/
+int PGAGetNumMigrants (PGAContext *ctx)
+{
+    PGADebugEntered("PGAGetNumMigrants");
+    PGAFailIfNotSetUp("PGAGetNumMigrants");
+
+    PGADebugExited("PGAGetNumMigrants");
+
+    return(ctx->par.NumMigrants);
+}
+
+
+/*U****************************************************************************
+   PGASetMigrationTopology - Set which islands of an island model GA send
+   migrants to which.  With PGA_TOPOLOGY_RING, the default, island i sends
+   to island i+1, and the last to island 0.  With PGA_TOPOLOGY_COMPLETE,
+   every island sends to every other.
+
+   Category: Parallel
+
+   Inputs:
+      ctx      - context variable
+      topology - symbolic constant of the topology
+
+   Outputs:
+      None
+
+   Example:
+      PGAContext *ctx;
+      :
+      PGASetNumIslands(ctx, 4);
+      PGASetMigrationTopology(ctx, PGA_TOPOLOGY_COMPLETE);
+
+****************************************************************************U*/
+void PGASetMigrationTopology( PGAContext *ctx, int topology)
+{
+    PGADebugEntered("PGASetMigrationTopology");
+    PGAFailIfSetUp("PGASetMigrationTopology");
+
+    switch (topology) {
+    case PGA_TOPOLOGY_RING:
+    case PGA_TOPOLOGY_COMPLETE:
+        ctx->par.Topology = topology;
+        break;
+    default:
+        PGAError(ctx, "PGASetMigrationTopology: Invalid value of topology:",
+                 PGA_FATAL, PGA_INT, (void *) &topology);
+        break;
+    }
+
+    PGADebugExited("PGASetMigrationTopology");
+}
+
+
+/*U***************************************************************************
+   PGAGetMigrationTopology - Returns which islands send migrants to which
+
+   Category: Parallel
+
+   Inputs:
+      ctx - context variable
+
+   Outputs:
+      The symbolic constant of the topology
+
+   Example:
+      PGAContext *ctx;
+      int topology;
+      :
+      topology = PGAGetMigrationTopology(ctx);
+
+***************************************************************************U*/
+int PGAGetMigrationTopology (PGAContext *ctx)
+{
+    PGADebugEntered("PGAGetMigrationTopology");
+    PGAFailIfNotSetUp("PGAGetMigrationTopology");
+
+    PGADebugExited("PGAGetMigrationTopology");
+
+    return(ctx->par.Topology);
+}
+
+
+/*U****************************************************************************
+   PGASetNumThreads - Set the number of threads PGAEvaluate evaluates the
+   strings of a population on, when there is a single process.  They are
+   started by PGASetUp and stopped by PGADestroy, and need no MPI.  The
+   evaluation function is then called from several threads at once, so it
+   must be safe to do so: it should keep any scratch space by thread (see
+   PGAGetThreadIndex), and get its random numbers from a stream of its own
+   (see PGARandomSubstream) rather than from PGARandom01.  The default is
+   one, which evaluates the strings one after the other.
+
+   Category: Parallel
+
+   Inputs:
+      ctx - context variable
+      n   - number of threads, counting the one calling PGAEvaluate
+
+   Outputs:
+      None
+
+   Example:
+      PGAContext *ctx,
+      double f(PGAContext *ctx, int p, int pop);
+      :
+      ctx = PGACreate(&argc, argv, PGA_DATATYPE_BINARY, 100, PGA_MAXIMIZE);
+      PGASetNumThreads(ctx, 8);
+      PGASetUp(ctx);
+      PGARun(ctx, f);
+      PGADestroy(ctx);
+
+****************************************************************************U*/
+void PGASetNumThreads( PGAContext *ctx, int n)
+{
+    PGADebugEntered("PGASetNumThreads");
+    PGAFailIfSetUp("PGASetNumThreads");
+
+    if ( n < 1 )
+        PGAError(ctx, "PGASetNumThreads: Invalid value of n:",
+                 PGA_FATAL, PGA_INT, (void *) &n);
+
+    ctx->par.NumThreads = n;
+
+    PGADebugExited("PGASetNumThreads");
+}
+
+
+/*U***************************************************************************
+   PGAGetNumThreads - Returns the number of threads strings are evaluated on
+
+   Category: Parallel
+
+   Inputs:
+      ctx - context variable
+
+   Outputs:
+      The number of threads strings are evaluated on
+
+   Example:
+      PGAContext *ctx;
+      int nthreads;
+      :
+      nthreads = PGAGetNumThreads(ctx);
+
+***************************************************************************U*/
+int PGAGetNumThreads (PGAContext *ctx)
+{
+    PGADebugEntered("PGAGetNumThreads");
+    PGAFailIfNotSetUp("PGAGetNumThreads");
+
+    PGADebugExited("PGAGetNumThreads");
+
+    return(ctx->par.NumThreads);
+}
+
+
+/*U***************************************************************************
+   PGAGetThreadIndex - Returns which of the threads set with
+   PGASetNumThreads the caller is, from zero, the thread calling
+   PGAEvaluate, to one less than their number.  In an island model, returns
+   the number of the island whose thread the caller is, from zero, the
+   thread calling PGARun.  Meant for the evaluation function, to pick
+   scratch space or a stream of random numbers of its own.
+
+   Category: Parallel
+
+   Inputs:
+      ctx - context variable
+
+   Outputs:
+      The index of the calling thread
+
+   Example:
+      double f(PGAContext *ctx, int p, int pop)
+      {
+          struct scratch *s = &scratch[PGAGetThreadIndex(ctx)];
+          :
+      }
+
+***************************************************************************U*/
+int PGAGetThreadIndex (PGAContext *ctx)
+{
+    PGAThread *self;
+
+    PGADebugEntered("PGAGetThreadIndex");
+
+    pthread_once(&ThreadKeyOnce, MakeThreadKey);
+    self = (PGAThread *)pthread_getspecific(ThreadKey);
+
+    PGADebugExited("PGAGetThreadIndex");
+
+    return(self == NULL ? 0 : self->index);
+}
+
+
+/*I****************************************************************************
+   PGAStartThreads - Starts the threads set with PGASetNumThreads, which wait
+   for PGAEvaluateThreads to give them strings to evaluate.  Called by
+   PGASetUp.  Starts none for an island model, whose islands are evaluated
+   on threads of their own.
+
+   Category: Parallel
+
+   Inputs:
+      ctx - context variable
+
+   Outputs:
+      None
+
+   Example:
+
+****************************************************************************I*/
+void PGAStartThreads(PGAContext *ctx)
+{
+    PGAThreadPool *pool;
+    int            i;
+
+    PGADebugEntered("PGAStartThreads");
+
+    if (ctx->par.NumThreads > 1 && ctx->par.NumIslands == 1 &&
+	ctx->par.ThreadPool == NULL) {
+	pthread_once(&ThreadKeyOnce, MakeThreadKey);
+
+	pool = (PGAThreadPool *)calloc(1, sizeof(PGAThreadPool));
+	if (pool != NULL)
+	    pool->thread = (PGAThread *)calloc(ctx->par.NumThreads,
+					       sizeof(PGAThread));
+	if (pool == NULL || pool->thread == NULL)
+	    PGAError(ctx, "PGAStartThreads: No room to allocate the pool",
+		     PGA_FATAL, PGA_VOID, NULL);
+
+	pool->nthreads = ctx->par.NumThreads;
+	pthread_mutex_init(&pool->lock, NULL);
+	pthread_cond_init(&pool->start, NULL);
+	pthread_cond_init(&pool->done, NULL);
+	for (i = 0; i < pool->nthreads; i++) {
+	    pool->thread[i].pool  = pool;
+	    pool->thread[i].index = i;
+	}
+	for (i = 1; i < pool->nthreads; i++)
+	    if (pthread_create(&pool->thread[i].id, NULL, PoolThread,
+			       &pool->thread[i]) != 0)
+		PGAError(ctx, "PGAStartThreads: Cannot start thread",
+			 PGA_FATAL, PGA_INT, (void *) &i);
+
+	ctx->par.ThreadPool = pool;
+    }
+
+    PGADebugExited("PGAStartThreads");
+}
+
+
+/*I****************************************************************************
+   PGAStopThreads - Stops the threads started by PGAStartThreads.  Called by
+   PGADestroy.
+
+   Category: Parallel
+
+   Inputs:
+      ctx - context variable
+
+   Outputs:
+      None
+
+   Example:
+
+****************************************************************************I*/
+void PGAStopThreads(PGAContext *ctx)
+{
+    PGAThreadPool *pool = (PGAThreadPool *)ctx->par.ThreadPool;
+    int            i;
+
+    PGADebugEntered("PGAStopThreads");
+
+    if (pool != NULL) {
+	pthread_mutex_lock(&pool->lock);
+	pool->quit = PGA_TRUE;
+	pthread_cond_broadcast(&pool->start);
+	pthread_mutex_unlock(&pool->lock);
+
+	for (i = 1; i < pool->nthreads; i++)
+	    pthread_join(pool->thread[i].id, NULL);
+
+	pthread_cond_destroy(&pool->done);
+	pthread_cond_destroy(&pool->start);
+	pthread_mutex_destroy(&pool->lock);
+	free(pool->thread);
+	free(pool);
+	ctx->par.ThreadPool = NULL;
+    }
+
+    PGADebugExited("PGAStopThreads");
+}
+
+
 /*U****************************************************************************
    PGASetCommunicator - Set the default communicator to use when PGARun is
    called.  Does not necessarily need to be the same as the number of
@@ -99,13 +99,10 @@ void PGARun(PGAContext *ctx, double (*evaluate)(PGAContext *c, int p, int pop))
      /*              Island model, > one island, one deme                  */
      /**********************************************************************/
      else if( (npops > 1) && (ndemes == 1) ) {
-         if ( nprocs == 1 )
-             PGAError (ctx, "PGARun: island model with one process",
-                       PGA_FATAL, PGA_VOID, (void *) &nprocs);
-         if ( nprocs != npops) {
-             PGAError (ctx, "PGARun: island model no. processes != no. pops",
-                       PGA_FATAL, PGA_VOID, (void *) &nprocs);
-         }
+         if ( nprocs != 1 )
+             PGAError (ctx, "PGARun: island model runs on threads of one "
+                       "process, not on processes:",
+                       PGA_FATAL, PGA_INT, (void *) &nprocs);
          PGARunIM(ctx,evaluate,comm);
      }
              
@@ -178,11 +175,13 @@ void PGARunMutationAndCrossover (PGAContext *ctx, int oldpop, int newpop)
     popsize = PGAGetPopSize(ctx);
     numreplace = PGAGetNumReplaceValue(ctx);
     /*** first, copy n best strings (sorted by fitness) to new pop ***/
-    PGASortPop( ctx, oldpop );
     n = popsize - numreplace;
+    PGAPartialSortPop( ctx, oldpop, n );
+    PGAClearDuplicateTable( ctx, newpop );
     for ( i=0; i < n; i++ ) {
         j = PGAGetSortedPopIndex( ctx, i );
         PGACopyIndividual ( ctx, j, oldpop, i, newpop );
+        PGAAddToDuplicateTable( ctx, i, newpop );
     }
     pc = PGAGetCrossoverProb(ctx);
     /*** reproduce to create the rest of the new population ***/
@@ -198,6 +197,7 @@ void PGARunMutationAndCrossover (PGAContext *ctx, int oldpop, int newpop)
               while (PGADuplicate( ctx, PGA_TEMP1, newpop, newpop, n))
                    PGAChange ( ctx, PGA_TEMP1, newpop );
               PGACopyIndividual ( ctx, PGA_TEMP1, newpop, n, newpop);
+              PGAAddToDuplicateTable( ctx, n, newpop );
               n++;
 
               if ( n < popsize ) {
@@ -206,19 +206,25 @@ void PGARunMutationAndCrossover (PGAContext *ctx, int oldpop, int newpop)
               while ( PGADuplicate( ctx, PGA_TEMP2, newpop, newpop, n))
                    PGAChange ( ctx, PGA_TEMP2, newpop );
               PGACopyIndividual ( ctx, PGA_TEMP2, newpop, n, newpop);
+              PGAAddToDuplicateTable( ctx, n, newpop );
               n++;
               }
          }
          else {
             PGACopyIndividual ( ctx, m1, oldpop, n, newpop );
+            PGAAddToDuplicateTable( ctx, n, newpop );
             n++;
             if ( n < ctx->ga.PopSize ) {
                 PGACopyIndividual ( ctx, m2, oldpop, n, newpop );
+                PGAAddToDuplicateTable( ctx, n, newpop );
                 n++;
             }
        }
     }
 
+    /*** the strings will change after this, so forget them ***/
+    PGAClearDuplicateTable( ctx, newpop );
+
     PGADebugExited("PGARunMutationAndCrossover");
 }
 
@@ -254,11 +260,13 @@ void PGARunMutationOrCrossover ( PGAContext *ctx, int oldpop, int newpop )
     popsize = PGAGetPopSize(ctx);
     numreplace = PGAGetNumReplaceValue(ctx);
     /*** first, copy n best strings (sorted by fitness) to new pop ***/
-    PGASortPop( ctx, oldpop );
     n = popsize - numreplace;
+    PGAPartialSortPop( ctx, oldpop, n );
+    PGAClearDuplicateTable( ctx, newpop );
     for ( i=0; i < n; i++ ) {
         j = PGAGetSortedPopIndex( ctx, i );
         PGACopyIndividual ( ctx, j, oldpop, i, newpop );
+        PGAAddToDuplicateTable( ctx, i, newpop );
     }
     pc = PGAGetCrossoverProb(ctx);
     /*** reproduce to create the rest of the new population ***/
@@ -273,6 +281,7 @@ void PGARunMutationOrCrossover ( PGAContext *ctx, int oldpop, int newpop )
             while (PGADuplicate(ctx, PGA_TEMP1, newpop,  newpop, n))
                 PGAChange ( ctx, PGA_TEMP1, newpop );
             PGACopyIndividual ( ctx, PGA_TEMP1, newpop, n, newpop);
+            PGAAddToDuplicateTable( ctx, n, newpop );
             n++;
 
             if ( n < popsize )
@@ -281,6 +290,7 @@ void PGARunMutationOrCrossover ( PGAContext *ctx, int oldpop, int newpop )
                  while (PGADuplicate(ctx, PGA_TEMP2, newpop,  newpop, n))
                       PGAChange ( ctx, PGA_TEMP2, newpop );
                  PGACopyIndividual ( ctx, PGA_TEMP2, newpop, n, newpop);
+                 PGAAddToDuplicateTable( ctx, n, newpop );
                  n++;
             }
         }
@@ -291,6 +301,7 @@ void PGARunMutationOrCrossover ( PGAContext *ctx, int oldpop, int newpop )
              while (PGADuplicate(ctx, PGA_TEMP1, newpop, newpop, n ))
                   PGAChange ( ctx, PGA_TEMP1, newpop );
              PGACopyIndividual ( ctx, PGA_TEMP1, newpop, n, newpop);
+             PGAAddToDuplicateTable( ctx, n, newpop );
              n++;
 
              if ( n < popsize ) {
@@ -299,11 +310,15 @@ void PGARunMutationOrCrossover ( PGAContext *ctx, int oldpop, int newpop )
                   while (PGADuplicate(ctx, PGA_TEMP2, newpop, newpop, n ))
                        PGAChange ( ctx, PGA_TEMP2, newpop );
                   PGACopyIndividual ( ctx, PGA_TEMP2, newpop, n, newpop);
+                  PGAAddToDuplicateTable( ctx, n, newpop );
                   n++;
              }
         }
     }
 
+    /*** the strings will change after this, so forget them ***/
+    PGAClearDuplicateTable( ctx, newpop );
+
     PGADebugExited("PGARunMutationOrCrossover");
 }
 
@@ -377,6 +392,10 @@ void PGAUpdateGeneration(PGAContext *ctx, MPI_Comm comm)
 	temp           = ctx->ga.oldpop;
 	ctx->ga.oldpop = ctx->ga.newpop;
 	ctx->ga.newpop = temp;
+
+	if (ctx->rep.CheckpointFile &&
+	    ctx->ga.iter % ctx->rep.CheckpointFreq == 0)
+	    PGAWriteCheckpoint(ctx, ctx->rep.CheckpointFile);
     }
 
     PGADebugExited("PGAUpdateGeneration");
@@ -419,7 +438,7 @@ void PGAUpdateGeneration(PGAContext *ctx, MPI_Comm comm)
       }
 
 ***************************************************************************U*/
-int PGAGetDataType (PGAContext *ctx)
+int (PGAGetDataType) (PGAContext *ctx)
 {
     PGADebugEntered("PGAGetDataType");
 
@@ -456,7 +475,7 @@ int PGAGetDataType (PGAContext *ctx)
       }
 
 ***************************************************************************U*/
-int PGAGetOptDirFlag (PGAContext *ctx)
+int (PGAGetOptDirFlag) (PGAContext *ctx)
 {
     PGADebugEntered("PGAGetOptDirFlag");
 
@@ -483,7 +502,7 @@ int PGAGetOptDirFlag (PGAContext *ctx)
       stringlen = PGAGetStringLength(ctx);
 
 ***************************************************************************U*/
-int PGAGetStringLength (PGAContext *ctx)
+int (PGAGetStringLength) (PGAContext *ctx)
 {
     PGADebugEntered("PGAGetStringLength");
 
@@ -548,7 +567,7 @@ int PGAGetVariableStringLength (PGAContext *ctx, int p, int pop)
       g = PGAGetGAIterValue(ctx);
 
 ***************************************************************************U*/
-int PGAGetGAIterValue (PGAContext *ctx)
+int (PGAGetGAIterValue) (PGAContext *ctx)
 {
     PGADebugEntered("PGAGetGAIterValue");
     PGAFailIfNotSetUp("PGAGetGAIterValue");
@@ -89,24 +89,62 @@ privately owned rights.
 ****************************************************************************U*/
 void PGASortPop ( PGAContext *ctx, int pop )
 {
-    int i,j;
     PGADebugEntered("PGASortPop");
+    PGAPartialSortPop ( ctx, pop, ctx->ga.PopSize );
+    PGADebugExited("PGASortPop");
+}
+
+
+/*U****************************************************************************
+   PGAPartialSortPop - Does what PGASortPop does, but when PGA_POPREPL_BEST
+   is used, puts only the n most fit strings in order, most fit first, in
+   time proportional to the population size plus n log n.  The rest of the
+   array holds the other strings' indices in no particular order.  Strings
+   of equal fitness are ordered by index.  Population replacement uses this
+   to find the strings it keeps without sorting the whole population.
+
+   Category: Generation
+
+   Inputs:
+       ctx      - context variable
+       popindex - symbolic constant of the population from which to create
+                  the sorted array.
+       n        - how many of the most fit strings are wanted in order
+
+   Output:
+      An internal array of indices, the first n in order of fitness.
+
+   Example:
+      Copy the five best strings from the old population into the new
+      population.
+
+      PGAContext *ctx;
+      int i,j;
+      :
+      PGAPartialSortPop(ctx, PGA_OLDPOP, 5);
+      for ( i=0; i < 5; i++) {
+          j = PGAGetSortedPopIndex(ctx, i);
+          PGACopyIndividual (ctx, j, PGA_OLDPOP, i, PGA_NEWPOP);
+      }
+
+****************************************************************************U*/
+void PGAPartialSortPop ( PGAContext *ctx, int pop, int n )
+{
+    PGAIndividual *ind;
+    PGASortItem *items;
+    int i,j;
+    PGADebugEntered("PGAPartialSortPop");
     switch (ctx->ga.PopReplace) {
     case PGA_POPREPL_BEST:
             switch ( pop ) {
             case PGA_OLDPOP:
-                for (i = 0 ; i < ctx->ga.PopSize ; i++ ) {
-                    ctx->ga.sorted[i] = i;
-                    ctx->scratch.dblscratch[i] = ctx->ga.oldpop[i].fitness;
-                };
+                ind = ctx->ga.oldpop;
                 break;
             case PGA_NEWPOP:
-                for (i = 0 ; i < ctx->ga.PopSize ; i++ ) {
-                    ctx->ga.sorted[i] = i;
-                    ctx->scratch.dblscratch[i] = ctx->ga.newpop[i].fitness;
-                };
+                ind = ctx->ga.newpop;
                 break;
             default:
+                ind = NULL;
                 PGAError( ctx,
                          "PGASort: Invalid value of pop:",
                          PGA_FATAL,
@@ -114,8 +152,14 @@ void PGASortPop ( PGAContext *ctx, int pop )
                          (void *) &pop );
                 break;
             };
-            PGADblHeapSort ( ctx, ctx->scratch.dblscratch, ctx->ga.sorted,
-                            ctx->ga.PopSize );
+            items = ctx->scratch.sortscratch;
+            for (i = 0 ; i < ctx->ga.PopSize ; i++ ) {
+                items[i].key = ind[i].fitness;
+                items[i].idx = i;
+            };
+            PGAPartialSort ( ctx, items, ctx->ga.PopSize, n );
+            for (i = 0 ; i < ctx->ga.PopSize ; i++ )
+                ctx->ga.sorted[i] = items[i].idx;
             break;
     case PGA_POPREPL_RANDOM_REP:
         if ((pop != PGA_OLDPOP) && (pop != PGA_NEWPOP))
@@ -150,7 +194,7 @@ void PGASortPop ( PGAContext *ctx, int pop )
         };
         break;
     }
-    PGADebugExited("PGASortPop");
+    PGADebugExited("PGAPartialSortPop");
 }
 
 
@@ -172,7 +216,7 @@ void PGASortPop ( PGAContext *ctx, int pop )
       popsize = PGAGetPopSize(ctx);
 
 ***************************************************************************U*/
-int PGAGetPopSize (PGAContext *ctx)
+int (PGAGetPopSize) (PGAContext *ctx)
 {
     PGADebugEntered("PGAGetPopSize");
     PGAFailIfNotSetUp("PGAGetPopSize");
@@ -201,7 +245,7 @@ int PGAGetPopSize (PGAContext *ctx)
       numreplace = PGAGetNumReplaceValue(ctx);
 
 ***************************************************************************U*/
-int PGAGetNumReplaceValue (PGAContext *ctx)
+int (PGAGetNumReplaceValue) (PGAContext *ctx)
 {
     PGADebugEntered("PGAGetNumReplaceValue");
     PGAFailIfNotSetUp("PGAGetNumReplaceValue");
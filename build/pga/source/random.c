@@ -117,9 +117,17 @@ int PGARandomInterval( PGAContext *ctx, int start, int end)
 
 
 /*****************************************************************************
-*  This is a C language implementation of the universal random number        *
-*  generator proposed by G. Marsaglia and A. Zaman and translated from       *
-*  F. James' version.                                                        *
+*  By default the random numbers come from xoshiro256** by D. Blackman and   *
+*  S. Vigna (http://prng.di.unimi.it/), which has a period of 2^256 - 1 and  *
+*  gives doubles with a full 53-bit mantissa.  Its state is seeded from the  *
+*  integer seed with splitmix64.  Its jump function advances the state by    *
+*  2^128 steps, which is what PGARandomSubstream uses to give threads        *
+*  streams of their own that do not overlap.                                 *
+*                                                                            *
+*  The generator PGAPack used to have, selected with PGASetRandomGenerator,  *
+*  is kept so that old runs can be reproduced.  It is a C language           *
+*  implementation of the universal random number generator proposed by      *
+*  G. Marsaglia and A. Zaman and translated from F. James' version.          *
 *                                                                            *
 *  F. James                                                                  *
 *  A review of pseudorandom number generators                                *
@@ -139,12 +147,131 @@ int PGARandomInterval( PGAContext *ctx, int start, int end)
 *  be portable and provides bit-identical results on all machines with at    *
 *  least 24-bit mantissas.                                                   *
 *                                                                            *
-*  PGARandom01 should be initialized with a 32-bit integer seed such that    *
+*  It should be initialized with a 32-bit integer seed such that             *
 *  0 <= seed <= 900,000,000.  Each of these 900,000,000 values gives rise    *
 *  to an independent sequence of ~ 10^30.                                    *
 *                                                                            *
-*  warning on use of static storage class on thread shared memory machines   *
+*  The state of either lives in a PGARandomStream, the one PGARandom01 uses  *
+*  in the context, so contexts and threads do not share any.                 *
 *****************************************************************************/
+
+static unsigned long long rotl(unsigned long long x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+static unsigned long long xoshiro_next(unsigned long long *s)
+{
+    unsigned long long result = rotl(s[1] * 5, 7) * 9;
+    unsigned long long t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+
+    return result;
+}
+
+/* Advances the state by 2^128 steps. */
+static void xoshiro_jump(unsigned long long *s)
+{
+    static const unsigned long long jump[] = {
+        0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+        0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+    unsigned long long t[4] = { 0, 0, 0, 0 };
+    int i, b;
+
+    for (i = 0; i < 4; i++)
+        for (b = 0; b < 64; b++) {
+            if (jump[i] & (1ULL << b)) {
+                t[0] ^= s[0];
+                t[1] ^= s[1];
+                t[2] ^= s[2];
+                t[3] ^= s[3];
+            }
+            xoshiro_next(s);
+        }
+    for (i = 0; i < 4; i++)
+        s[i] = t[i];
+}
+
+static void xoshiro_seed(unsigned long long *s, int seed)
+{
+    unsigned long long x = (unsigned long long) seed;
+    int i;
+
+    /* splitmix64, which never leaves the state all zero */
+    for (i = 0; i < 4; i++) {
+        unsigned long long z = (x += 0x9e3779b97f4a7c15ULL);
+
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        s[i] = z ^ (z >> 31);
+    }
+}
+
+static void marsaglia_seed(PGARandomStream *rs, int newseed)
+{
+    int ij, kl, i, j, k, l, m, ii, jj, seed;
+    float s, t;
+
+    seed = newseed % 900000000;
+    ij   = seed / 30082;
+    kl   = seed - 30082 * ij;
+    i    = ( (ij/177) % 177 ) + 2;
+    j    = (  ij      % 177 ) + 2;
+    k    = ( (kl/169) % 178 ) + 1;
+    l    = (  kl      % 169 );
+
+    for ( ii=0; ii<97; ii++ ) {
+
+        s = 0.0;
+        t = 0.5;
+
+        for ( jj=0; jj<24; jj++ ) {
+
+            m = ( ((i*j) % 179) * k ) % 179;
+            i = j;
+            j = k;
+            k = m;
+            l = ( (53*l) + 1 ) % 169;
+            if ( ( (l*m) % 64 ) >= 32 )
+                s += t;
+            t *= .5;
+        }
+
+        rs->u[ii] = s;
+    }
+
+    rs->c   = 362436.  /16777216.;
+    rs->cd  = 7654321. /16777216.;
+    rs->cm  = 16777213./16777216.;
+    rs->i96 = 96;
+    rs->j96 = 32;
+}
+
+static double marsaglia_next(PGARandomStream *rs)
+{
+    float uni;
+
+    uni = rs->u[rs->i96] - rs->u[rs->j96];
+    if ( uni < 0. ) uni += 1.0;
+    rs->u[rs->i96] = uni;
+    rs->i96--;
+    if ( rs->i96 < 0  ) rs->i96 = 96;
+    rs->j96--;
+    if ( rs->j96 < 0  ) rs->j96 = 96;
+    rs->c   -= rs->cd;
+    if ( rs->c   < 0. ) rs->c += rs->cm;
+    uni -= rs->c;
+    if ( uni < 0. ) uni += 1.0;
+
+    return( (double) uni);
+}
+
 /*U****************************************************************************
    PGARandom01 - generates a uniform random number on the interval [0,1)
    If the second argument is 0 it returns the next random number in the
@@ -171,74 +298,129 @@ int PGARandomInterval( PGAContext *ctx, int start, int end)
 ****************************************************************************U*/
 double PGARandom01( PGAContext *ctx, int newseed )
 {
+    double r;
 
-    /* initialization variables */
-    int ij, kl, i, j, k, l, m, ii, jj;
-    float s, t;
+    PGADebugEntered("PGARandom01");
 
-    /* random number variables */
-    static int seed=1;      /* default seed if none specified */
-    static int i96, j96;
-    static float u[97], uni, c, cd, cm;
+    if ( newseed != 0 )
+        PGARandomSeedStream(ctx, &ctx->random, newseed);
+    r = PGARandomStream01(&ctx->random);
 
+    PGADebugExited("PGARandom01");
+    return(r);
+}
 
-    PGADebugEntered("PGARandom01");
+/*U****************************************************************************
+   PGARandomStream01 - generates a uniform random number on the interval
+   [0,1) from a stream of random numbers set up by PGARandomSeedStream or
+   PGARandomSubstream.  A thread drawing on a stream of its own needs no
+   locking and gets the same numbers on every run.
 
-    /* initialization */
-/*     printf("i96 = %d\tj96 = %d\n", i96, j96); */
+   Category: Utility
 
-    if ( newseed != 0 ) {
+   Inputs:
+      rs - the stream
 
-        seed = newseed % 900000000;
-        ij   = seed / 30082;
-        kl   = seed - 30082 * ij;
-        i    = ( (ij/177) % 177 ) + 2;
-        j    = (  ij      % 177 ) + 2;
-        k    = ( (kl/169) % 178 ) + 1;
-        l    = (  kl      % 169 );
+   Outputs:
+      A random number on the interval [0,1)
 
-        for ( ii=0; ii<97; ii++ ) {
+   Example:
+      PGAContext *ctx;
+      PGARandomStream rs;
+      double r;
+      :
+      PGARandomSubstream(ctx, thread + 1, &rs);
+      r = PGARandomStream01(&rs);
 
-            s = 0.0;
-            t = 0.5;
+****************************************************************************U*/
+double PGARandomStream01(PGARandomStream *rs)
+{
+    if (rs->Generator == PGA_RANDOM_MARSAGLIA)
+        return(marsaglia_next(rs));
 
-            for ( jj=0; jj<24; jj++ ) {
+    return((double)(xoshiro_next(rs->s) >> 11) * (1.0 / 9007199254740992.0));
+}
 
-                m = ( ((i*j) % 179) * k ) % 179;
-                i = j;
-                j = k;
-                k = m;
-                l = ( (53*l) + 1 ) % 169;
-                if ( ( (l*m) % 64 ) >= 32 )
-                    s += t;
-                t *= .5;
-            }
+/*U****************************************************************************
+   PGARandomSeedStream - seeds a stream of random numbers, with the generator
+   chosen for the context.  PGASetUp seeds the one of the context, which
+   PGARandom01 draws on, with the seed from PGASetRandomSeed.
 
-            u[ii] = s;
-        }
+   Category: Utility
 
-        c   = 362436.  /16777216.;
-        cd  = 7654321. /16777216.;
-        cm  = 16777213./16777216.;
-        i96 = 96;
-        j96 = 32;
-    }
+   Inputs:
+      ctx  - context variable
+      rs   - the stream
+      seed - seed for it
 
-    /* random number generation */
-    uni = u[i96] - u[j96];
-    if ( uni < 0. ) uni += 1.0;
-    u[i96] = uni;
-    i96--;
-    if ( i96 < 0  ) i96 = 96;
-    j96--;
-    if ( j96 < 0  ) j96 = 96;
-    c   -= cd;
-    if ( c   < 0. ) c += cm;
-    uni -= c;
-    if ( uni < 0. ) uni += 1.0;
+   Outputs:
+      None
 
-    PGADebugExited("PGARandom01");
-    return( (double) uni);
+   Example:
+      PGAContext *ctx;
+      PGARandomStream rs;
+      :
+      PGARandomSeedStream(ctx, &rs, 42);
+
+****************************************************************************U*/
+void PGARandomSeedStream(PGAContext *ctx, PGARandomStream *rs, int seed)
+{
+    PGADebugEntered("PGARandomSeedStream");
+
+    rs->Generator = ctx->init.RandomGenerator;
+    if (rs->Generator == PGA_RANDOM_MARSAGLIA)
+        marsaglia_seed(rs, seed);
+    else
+        xoshiro_seed(rs->s, seed);
+
+    PGADebugExited("PGARandomSeedStream");
+}
+
+/*U****************************************************************************
+   PGARandomSubstream - sets up substream n of the random numbers of the
+   context, for a thread to draw on.  Substream 0 starts where the stream of
+   the context started when PGASetUp seeded it; with xoshiro256**, substream
+   n starts n * 2^128 numbers further on, so that the substreams never
+   overlap.  With the Marsaglia-Zaman generator, it is seeded with the seed
+   of the context plus n instead, as processes used to be.  Must be called
+   after PGASetUp.
+
+   Category: Utility
+
+   Inputs:
+      ctx - context variable
+      n   - number of the substream
+      rs  - where to set it up
+
+   Outputs:
+      None
+
+   Example:
+      Give each of nthreads threads its own random numbers, apart from the
+      ones of the context
+
+      PGAContext *ctx;
+      PGARandomStream *rs;
+      int t;
+      :
+      for (t = 0; t < nthreads; t++)
+          PGARandomSubstream(ctx, t + 1, &rs[t]);
+
+****************************************************************************U*/
+void PGARandomSubstream(PGAContext *ctx, int n, PGARandomStream *rs)
+{
+    PGADebugEntered("PGARandomSubstream");
+    PGAFailIfNotSetUp("PGARandomSubstream");
+
+    if (ctx->init.RandomGenerator == PGA_RANDOM_MARSAGLIA)
+        PGARandomSeedStream(ctx, rs, ctx->init.RandomSeed + n);
+    else {
+        PGARandomSeedStream(ctx, rs, ctx->init.RandomSeed);
+        while (n-- > 0)
+            xoshiro_jump(rs->s);
+    }
+
+    PGADebugExited("PGARandomSubstream");
 }
 
 /*U****************************************************************************
@@ -378,3 +560,72 @@ void PGASetRandomSeed(PGAContext *ctx, int seed)
     
     PGADebugExited("PGASetRandomSeed");
 }
+
+/*U***************************************************************************
+   PGAGetRandomGenerator - returns the random number generator in use
+
+   Category: Utility
+
+   Inputs:
+      ctx - context variable
+
+   Outputs:
+      PGA_RANDOM_XOSHIRO or PGA_RANDOM_MARSAGLIA
+
+   Example:
+      PGAContext *ctx;
+      int gen;
+      :
+      gen = PGAGetRandomGenerator(ctx);
+
+***************************************************************************U*/
+int PGAGetRandomGenerator(PGAContext *ctx)
+{
+    PGADebugEntered("PGAGetRandomGenerator");
+    PGAFailIfNotSetUp("PGAGetRandomGenerator");
+
+    PGADebugExited("PGAGetRandomGenerator");
+
+    return(ctx->init.RandomGenerator);
+}
+
+/*U****************************************************************************
+   PGASetRandomGenerator - set the random number generator.  The default,
+   PGA_RANDOM_XOSHIRO, is xoshiro256**.  PGA_RANDOM_MARSAGLIA is the
+   Marsaglia-Zaman generator of earlier versions, which gives the same
+   numbers as they did for a given seed, to reproduce old runs.
+
+   Category: Utility
+
+   Inputs:
+      ctx       - context variable
+      generator - PGA_RANDOM_XOSHIRO or PGA_RANDOM_MARSAGLIA
+
+   Outputs:
+      None
+
+   Example:
+      PGAContext *ctx;
+      :
+      PGASetRandomGenerator(ctx, PGA_RANDOM_MARSAGLIA);
+
+****************************************************************************U*/
+void PGASetRandomGenerator(PGAContext *ctx, int generator)
+{
+    PGADebugEntered("PGASetRandomGenerator");
+    PGAFailIfSetUp("PGASetRandomGenerator");
+
+    switch (generator)
+    {
+    case PGA_RANDOM_XOSHIRO:
+    case PGA_RANDOM_MARSAGLIA:
+        ctx->init.RandomGenerator = generator;
+        break;
+    default:
+	PGAError ( ctx, "PGASetRandomGenerator: Invalid value of generator:",
+		  PGA_FATAL, PGA_INT, (void *) &generator);
+        break;
+    }
+
+    PGADebugExited("PGASetRandomGenerator");
+}
@@ -73,7 +73,7 @@ privately owned rights.
       PGASetRealAllele ( ctx, p, PGA_NEWPOP, i, 1.57)
 
 ****************************************************************************U*/
-void PGASetRealAllele (PGAContext *ctx, int p, int pop, int i, double value)
+void (PGASetRealAllele) (PGAContext *ctx, int p, int pop, int i, double value)
 {
     PGAIndividual *ind;
     PGAReal      *chrom;
@@ -112,7 +112,7 @@ void PGASetRealAllele (PGAContext *ctx, int p, int pop, int i, double value)
       r =  PGAGetRealAllele (ctx, p, PGA_NEWPOP, i)
 
 ****************************************************************************U*/
-double PGAGetRealAllele (PGAContext *ctx, int p, int pop, int i)
+double (PGAGetRealAllele) (PGAContext *ctx, int p, int pop, int i)
 {
     PGAIndividual *ind;
     PGAReal      *chrom;
@@ -128,6 +128,51 @@ double PGAGetRealAllele (PGAContext *ctx, int p, int pop, int i)
     return( (double) chrom[i] );
 }
 
+/*U****************************************************************************
+   PGAGetRealRow - returns a pointer to the alleles of string p in population
+   pop, so that they can be read or written as an array of StringLen values.
+   If PGASetContiguousPopFlag was used, the strings of a population are rows
+   of one PopSize by StringLen block, in order, and PGAGetRealRow(ctx, 0, pop)
+   is the start of that block.
+
+   Category: Fitness & Evaluation
+
+   Inputs:
+      ctx - context variable
+      p   - string index
+      pop - symbolic constant of the population the string is in
+
+   Outputs:
+      A pointer to allele 0 of string p
+
+   Example:
+      Sum the alleles of string p in population PGA_NEWPOP
+
+      PGAContext *ctx;
+      PGAReal *row;
+      double sum = 0.0;
+      int p, i, len;
+      :
+      row = PGAGetRealRow (ctx, p, PGA_NEWPOP);
+      len = PGAGetStringLength (ctx);
+      for (i = 0; i < len; i++)
+          sum += row[i];
+
+****************************************************************************U*/
+PGAReal *(PGAGetRealRow) (PGAContext *ctx, int p, int pop)
+{
+    PGAReal      *chrom;
+
+    PGADebugEntered("PGAGetRealRow");
+    PGACheckDataType("PGAGetRealRow", PGA_DATATYPE_REAL);
+
+    chrom = (PGAReal *)PGAGetIndividual ( ctx, p, pop )->chrom;
+
+    PGADebugExited("PGAGetRealRow");
+
+    return( chrom );
+}
+
 /*U****************************************************************************
   PGASetRealInitPercent - sets the upper and lower bounds for randomly
   initializing real-valued genes.  For each gene these bounds define an
@@ -389,10 +434,13 @@ void PGARealCreateString (PGAContext *ctx, int p, int pop, int initflag)
     
     PGADebugEntered("PGARealCreateString");
     
-    new->chrom = (void *) malloc (ctx->ga.StringLen * sizeof(PGAReal));
-    if (new->chrom == NULL)
-	PGAError(ctx, "PGARealCreateString: No room to allocate new->chrom",
-		 PGA_FATAL, PGA_VOID, NULL);
+    /*  With contiguous populations, PGACreatePop has set chrom to the row  */
+    if (ctx->init.ContiguousPop == PGA_FALSE) {
+	new->chrom = (void *) malloc (ctx->ga.StringLen * sizeof(PGAReal));
+	if (new->chrom == NULL)
+	    PGAError(ctx, "PGARealCreateString: No room to allocate new->chrom",
+		     PGA_FATAL, PGA_VOID, NULL);
+    }
     c = (PGAReal *)new->chrom;
     if (initflag)
 	if (ctx->fops.InitString) {
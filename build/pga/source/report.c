@@ -915,6 +915,23 @@ void PGAPrintContextVariable ( PGAContext *ctx, FILE *fp )
           break;
      };
 
+     fprintf( fp,"    Contiguous Populations         : ");
+     switch(ctx->init.ContiguousPop)
+     {
+     case PGA_TRUE:
+          fprintf( fp,"On\n");
+          break;
+     case PGA_FALSE:
+          fprintf( fp,"Off\n");
+          break;
+     case PGA_UNINITIALIZED_INT:
+          fprintf( fp,"*UNINITIALIZED*\n");
+          break;
+     default:
+          fprintf( fp,"!ERROR!  =(%d)?\n", ctx->init.ContiguousPop);
+          break;
+     };
+
      fprintf( fp,"    Initialization Binary Prob     : ");
      if (ctx->init.BinaryProbability == PGA_UNINITIALIZED_DOUBLE)
           fprintf( fp,"*UNINITIALIZED*\n");
@@ -987,6 +1004,23 @@ void PGAPrintContextVariable ( PGAContext *ctx, FILE *fp )
           break;
      };
 
+     fprintf( fp,"    Random Number Generator        : ");
+     switch(ctx->init.RandomGenerator)
+     {
+     case PGA_RANDOM_XOSHIRO:
+          fprintf( fp,"xoshiro256**\n");
+          break;
+     case PGA_RANDOM_MARSAGLIA:
+          fprintf( fp,"Marsaglia-Zaman\n");
+          break;
+     case PGA_UNINITIALIZED_INT:
+          fprintf( fp,"*UNINITIALIZED*\n");
+          break;
+     default:
+          fprintf( fp,"!ERROR!  =(%d)?\n", ctx->init.RandomGenerator);
+          break;
+     };
+
      PGADebugExited("PGAPrintContextVariable");
 
 
@@ -1025,7 +1059,7 @@ void PGAPrintContextVariable ( PGAContext *ctx, FILE *fp )
           break;
      };
 
-     /*fprintf(fp, "    Number Islands                 : ");
+     fprintf(fp, "    Number Islands                 : ");
      switch(ctx->par.NumIslands)
      {
      case PGA_UNINITIALIZED_INT:
@@ -1036,7 +1070,46 @@ void PGAPrintContextVariable ( PGAContext *ctx, FILE *fp )
           break;
      }
 
-     fprintf(fp, "    Number Demes                   : ");
+     fprintf(fp, "    Migration Interval             : ");
+     switch(ctx->par.MigrationInterval)
+     {
+     case PGA_UNINITIALIZED_INT:
+          fprintf(fp, "*UNINITIALIZED*\n");
+          break;
+     default:
+          fprintf(fp, "%d\n", ctx->par.MigrationInterval);
+          break;
+     }
+
+     fprintf(fp, "    Number Migrants                : ");
+     switch(ctx->par.NumMigrants)
+     {
+     case PGA_UNINITIALIZED_INT:
+          fprintf(fp, "*UNINITIALIZED*\n");
+          break;
+     default:
+          fprintf(fp, "%d\n", ctx->par.NumMigrants);
+          break;
+     }
+
+     fprintf(fp, "    Migration Topology             : ");
+     switch(ctx->par.Topology)
+     {
+     case PGA_TOPOLOGY_RING:
+          fprintf(fp, "PGA_TOPOLOGY_RING\n");
+          break;
+     case PGA_TOPOLOGY_COMPLETE:
+          fprintf(fp, "PGA_TOPOLOGY_COMPLETE\n");
+          break;
+     case PGA_UNINITIALIZED_INT:
+          fprintf(fp, "*UNINITIALIZED*\n");
+          break;
+     default:
+          fprintf(fp, "!ERROR!  =(%d)?\n", ctx->par.Topology);
+          break;
+     }
+
+     /*fprintf(fp, "    Number Demes                   : ");
      switch(ctx->par.NumDemes)
      {
      case PGA_UNINITIALIZED_INT:
@@ -1047,6 +1120,17 @@ void PGAPrintContextVariable ( PGAContext *ctx, FILE *fp )
           break;
      }*/
 
+     fprintf(fp, "    Number Threads                 : ");
+     switch(ctx->par.NumThreads)
+     {
+     case PGA_UNINITIALIZED_INT:
+          fprintf(fp, "*UNINITIALIZED*\n");
+          break;
+     default:
+          fprintf(fp, "%d\n", ctx->par.NumThreads);
+          break;
+     }
+
      fprintf(fp, "    Default Communicator           : ");
      if (ctx->par.DefaultComm == NULL) 
 	 fprintf(fp, "NULL\n");
@@ -1071,6 +1155,23 @@ void PGAPrintContextVariable ( PGAContext *ctx, FILE *fp )
           break;
      };
 
+     fprintf( fp,"    Checkpoint File                : ");
+     if (ctx->rep.CheckpointFile == NULL)
+          fprintf( fp,"None\n");
+     else
+          fprintf( fp,"%s\n",ctx->rep.CheckpointFile);
+
+     fprintf( fp,"    Checkpoint Frequency           : ");
+     switch(ctx->rep.CheckpointFreq)
+     {
+     case PGA_UNINITIALIZED_INT:
+          fprintf( fp,"*UNINITIALIZED*\n");
+          break;
+     default:
+          fprintf( fp,"%d\n",ctx->rep.CheckpointFreq);
+          break;
+     };
+
      fprintf( fp,"    Print Worst Evaluation         : ");
      if ((ctx->rep.PrintOptions & PGA_REPORT_WORST) == PGA_REPORT_WORST)
          fprintf( fp,"On\n");
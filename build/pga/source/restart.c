@@ -39,7 +39,8 @@ privately owned rights.
 
 /*****************************************************************************
 *     FILE: restart.c: This file contains the routines needed to handle
-*                      the restart operator, and restarting the GA.
+*                      the restart operator, and restarting the GA,
+*                      including from a checkpoint file.
 *
 *     Authors: David M. Levine, Philip L. Hallstrom, David M. Noelle,
 *              Brian P. Walenz
@@ -304,3 +305,467 @@ double PGAGetRestartAlleleChangeProb(PGAContext *ctx)
     return (ctx->ga.restartAlleleProb);
 }
 
+
+
+/*  A checkpoint file is written in a fixed layout, independent of the
+ *  machine: integers and the bit patterns of doubles and floats are
+ *  little-endian, binary strings are packed eight alleles to a byte.
+ */
+#define PGA_CHECKPOINT_MAGIC    "PGACKPT"
+#define PGA_CHECKPOINT_VERSION  1
+
+static void PutUnsigned(FILE *fp, unsigned long long v, int nbytes)
+{
+    int i;
+
+    for (i = 0; i < nbytes; i++)
+	putc((int)((v >> (8*i)) & 0xff), fp);
+}
+
+static unsigned long long GetUnsigned(FILE *fp, int nbytes)
+{
+    unsigned long long v = 0;
+    int i, c;
+
+    for (i = 0; i < nbytes; i++) {
+	if ((c = getc(fp)) == EOF)
+	    return 0;
+	v |= (unsigned long long)c << (8*i);
+    }
+    return v;
+}
+
+static void PutDouble(FILE *fp, double d)
+{
+    unsigned long long v;
+
+    memcpy(&v, &d, sizeof(v));
+    PutUnsigned(fp, v, 8);
+}
+
+static double GetDouble(FILE *fp)
+{
+    unsigned long long v = GetUnsigned(fp, 8);
+    double d;
+
+    memcpy(&d, &v, sizeof(d));
+    return d;
+}
+
+static void PutFloat(FILE *fp, float f)
+{
+    unsigned int v;
+
+    memcpy(&v, &f, sizeof(v));
+    PutUnsigned(fp, v, 4);
+}
+
+static float GetFloat(FILE *fp)
+{
+    unsigned int v = (unsigned int)GetUnsigned(fp, 4);
+    float f;
+
+    memcpy(&f, &v, sizeof(f));
+    return f;
+}
+
+#define PutInt(fp, i)   PutUnsigned(fp, (unsigned long long)(i), 4)
+#define GetInt(fp)      ((int)(unsigned int)GetUnsigned(fp, 4))
+
+/*  Writes (or reads) string p of population pop  */
+static void PutString(PGAContext *ctx, FILE *fp, int p, int pop)
+{
+    int i, b, len = ctx->ga.StringLen;
+
+    switch (ctx->ga.datatype) {
+    case PGA_DATATYPE_BINARY:
+	for (i = 0; i < len; i += 8) {
+	    int byte = 0;
+	    for (b = 0; b < 8 && i+b < len; b++)
+		if (PGAGetBinaryAllele(ctx, p, pop, i+b))
+		    byte |= 1 << b;
+	    putc(byte, fp);
+	}
+	break;
+    case PGA_DATATYPE_INTEGER:
+	for (i = 0; i < len; i++)
+	    PutUnsigned(fp, (unsigned long long)
+			((PGAInteger *)PGAGetIndividual(ctx, p, pop)->chrom)[i], 8);
+	break;
+    case PGA_DATATYPE_REAL:
+	for (i = 0; i < len; i++)
+	    PutDouble(fp, PGAGetRealAllele(ctx, p, pop, i));
+	break;
+    case PGA_DATATYPE_CHARACTER:
+	for (i = 0; i < len; i++)
+	    putc((unsigned char)PGAGetCharacterAllele(ctx, p, pop, i), fp);
+	break;
+    }
+}
+
+static void GetString(PGAContext *ctx, FILE *fp, int p, int pop)
+{
+    int i, b, len = ctx->ga.StringLen;
+
+    switch (ctx->ga.datatype) {
+    case PGA_DATATYPE_BINARY:
+	for (i = 0; i < len; i += 8) {
+	    int byte = getc(fp);
+	    for (b = 0; b < 8 && i+b < len; b++)
+		PGASetBinaryAllele(ctx, p, pop, i+b, (byte >> b) & 1);
+	}
+	break;
+    case PGA_DATATYPE_INTEGER:
+	for (i = 0; i < len; i++)
+	    ((PGAInteger *)PGAGetIndividual(ctx, p, pop)->chrom)[i] =
+		(PGAInteger)(long long)GetUnsigned(fp, 8);
+	break;
+    case PGA_DATATYPE_REAL:
+	for (i = 0; i < len; i++)
+	    PGASetRealAllele(ctx, p, pop, i, GetDouble(fp));
+	break;
+    case PGA_DATATYPE_CHARACTER:
+	for (i = 0; i < len; i++)
+	    PGASetCharacterAllele(ctx, p, pop, i, (char)getc(fp));
+	break;
+    }
+}
+
+/*U****************************************************************************
+   PGAWriteCheckpoint - writes the state of the GA to a file, from which
+   PGAReadCheckpoint, or PGASetUp after PGASetResumeFile, can carry on with
+   it later, possibly on another machine.  The state is the current
+   population (PGA_OLDPOP, with evaluations and fitness), the random number
+   generator, the iteration count, and what the stopping rules and the
+   reports keep from one generation to the next.  The file is written under
+   a temporary name and renamed, so that a crash while writing leaves the
+   previous checkpoint in place.  User defined data types cannot be
+   checkpointed.
+
+   Category: Generation
+
+   Inputs:
+      ctx      - context variable
+      filename - name of the checkpoint file
+
+   Outputs:
+      None.  A warning is printed if the file cannot be written.
+
+   Example:
+      PGAContext *ctx;
+      :
+      PGAWriteCheckpoint(ctx, "run.ckpt");
+
+****************************************************************************U*/
+void PGAWriteCheckpoint(PGAContext *ctx, char *filename)
+{
+    PGARandomStream *rs = &ctx->random;
+    char *tmpname;
+    FILE *fp;
+    int i, p, ok;
+
+    PGADebugEntered("PGAWriteCheckpoint");
+    PGAFailIfNotSetUp("PGAWriteCheckpoint");
+
+    if (ctx->ga.datatype == PGA_DATATYPE_USER)
+	PGAError(ctx, "PGAWriteCheckpoint: Cannot checkpoint a user datatype",
+		 PGA_FATAL, PGA_VOID, NULL);
+
+    tmpname = (char *)malloc(strlen(filename) + 5);
+    if (tmpname == NULL)
+	PGAError(ctx, "PGAWriteCheckpoint: No room to allocate tmpname",
+		 PGA_FATAL, PGA_VOID, NULL);
+    sprintf(tmpname, "%s.tmp", filename);
+
+    fp = fopen(tmpname, "wb");
+    if (fp == NULL) {
+	PGAError(ctx, "PGAWriteCheckpoint: Could not open file:",
+		 PGA_WARNING, PGA_CHAR, (void *) tmpname);
+	free(tmpname);
+	PGADebugExited("PGAWriteCheckpoint");
+	return;
+    }
+
+    fwrite(PGA_CHECKPOINT_MAGIC, 1, 8, fp);
+    PutInt(fp, PGA_CHECKPOINT_VERSION);
+    PutInt(fp, ctx->ga.datatype);
+    PutInt(fp, ctx->ga.StringLen);
+    PutInt(fp, ctx->ga.PopSize);
+
+    PutInt(fp, ctx->ga.iter);
+    PutInt(fp, ctx->ga.ItersOfSame);
+    PutInt(fp, ctx->ga.PercentSame);
+    PutDouble(fp, ctx->rep.Best);
+    PutDouble(fp, ctx->rep.Online);
+    PutDouble(fp, ctx->rep.Offline);
+    PutDouble(fp, ctx->rep.Average);
+
+    PutInt(fp, ctx->init.RandomSeed);
+    PutInt(fp, rs->Generator);
+    for (i = 0; i < 4; i++)
+	PutUnsigned(fp, rs->s[i], 8);
+    PutInt(fp, rs->i96);
+    PutInt(fp, rs->j96);
+    for (i = 0; i < 97; i++)
+	PutFloat(fp, rs->u[i]);
+    PutFloat(fp, rs->c);
+    PutFloat(fp, rs->cd);
+    PutFloat(fp, rs->cm);
+
+    for (p = 0; p < ctx->ga.PopSize; p++) {
+	PGAIndividual *ind = PGAGetIndividual(ctx, p, PGA_OLDPOP);
+
+	PutDouble(fp, ind->evalfunc);
+	PutDouble(fp, ind->fitness);
+	putc(ind->evaluptodate == PGA_TRUE, fp);
+	PutString(ctx, fp, p, PGA_OLDPOP);
+    }
+    fwrite(PGA_CHECKPOINT_MAGIC, 1, 8, fp);
+
+    ok = !ferror(fp);
+    if (fclose(fp) != 0)
+	ok = 0;
+    if (ok && rename(tmpname, filename) != 0)
+	ok = 0;
+    if (!ok) {
+	PGAError(ctx, "PGAWriteCheckpoint: Could not write file:",
+		 PGA_WARNING, PGA_CHAR, (void *) filename);
+	remove(tmpname);
+    }
+    free(tmpname);
+
+    PGADebugExited("PGAWriteCheckpoint");
+}
+
+/*U****************************************************************************
+   PGAReadCheckpoint - restores the state of the GA from a file written by
+   PGAWriteCheckpoint.  The file must have been written by a GA with the same
+   data type, string length and population size.  The strings go into
+   PGA_OLDPOP, and the random number generator carries on where it was, so
+   that a run resumed with PGARun continues just as it would have without
+   the interruption.  PGASetResumeFile has PGASetUp call this.
+
+   Category: Generation
+
+   Inputs:
+      ctx      - context variable
+      filename - name of the checkpoint file
+
+   Outputs:
+      None
+
+   Example:
+      PGAContext *ctx;
+      :
+      PGASetUp(ctx);
+      PGAReadCheckpoint(ctx, "run.ckpt");
+      PGARun(ctx, evaluate);
+
+****************************************************************************U*/
+void PGAReadCheckpoint(PGAContext *ctx, char *filename)
+{
+    PGARandomStream *rs = &ctx->random;
+    char magic[8];
+    FILE *fp;
+    int i, p, v;
+
+    PGADebugEntered("PGAReadCheckpoint");
+    PGAFailIfNotSetUp("PGAReadCheckpoint");
+
+    fp = fopen(filename, "rb");
+    if (fp == NULL)
+	PGAError(ctx, "PGAReadCheckpoint: Could not open file:",
+		 PGA_FATAL, PGA_CHAR, (void *) filename);
+
+    if (fread(magic, 1, 8, fp) != 8 ||
+	memcmp(magic, PGA_CHECKPOINT_MAGIC, 8) != 0)
+	PGAError(ctx, "PGAReadCheckpoint: Not a checkpoint file:",
+		 PGA_FATAL, PGA_CHAR, (void *) filename);
+    if ((v = GetInt(fp)) != PGA_CHECKPOINT_VERSION)
+	PGAError(ctx, "PGAReadCheckpoint: Unknown checkpoint version:",
+		 PGA_FATAL, PGA_INT, (void *) &v);
+    if ((v = GetInt(fp)) != ctx->ga.datatype)
+	PGAError(ctx, "PGAReadCheckpoint: Checkpoint has datatype:",
+		 PGA_FATAL, PGA_INT, (void *) &v);
+    if ((v = GetInt(fp)) != ctx->ga.StringLen)
+	PGAError(ctx, "PGAReadCheckpoint: Checkpoint has string length:",
+		 PGA_FATAL, PGA_INT, (void *) &v);
+    if ((v = GetInt(fp)) != ctx->ga.PopSize)
+	PGAError(ctx, "PGAReadCheckpoint: Checkpoint has population size:",
+		 PGA_FATAL, PGA_INT, (void *) &v);
+
+    ctx->ga.iter        = GetInt(fp);
+    ctx->ga.ItersOfSame = GetInt(fp);
+    ctx->ga.PercentSame = GetInt(fp);
+    ctx->rep.Best       = GetDouble(fp);
+    ctx->rep.Online     = GetDouble(fp);
+    ctx->rep.Offline    = GetDouble(fp);
+    ctx->rep.Average    = GetDouble(fp);
+
+    ctx->init.RandomSeed = GetInt(fp);
+    rs->Generator = GetInt(fp);
+    for (i = 0; i < 4; i++)
+	rs->s[i] = GetUnsigned(fp, 8);
+    rs->i96 = GetInt(fp);
+    rs->j96 = GetInt(fp);
+    for (i = 0; i < 97; i++)
+	rs->u[i] = GetFloat(fp);
+    rs->c  = GetFloat(fp);
+    rs->cd = GetFloat(fp);
+    rs->cm = GetFloat(fp);
+    ctx->init.RandomGenerator = rs->Generator;
+
+    for (p = 0; p < ctx->ga.PopSize; p++) {
+	PGAIndividual *ind = PGAGetIndividual(ctx, p, PGA_OLDPOP);
+
+	ind->evalfunc     = GetDouble(fp);
+	ind->fitness      = GetDouble(fp);
+	ind->evaluptodate = (getc(fp) == 1) ? PGA_TRUE : PGA_FALSE;
+	GetString(ctx, fp, p, PGA_OLDPOP);
+    }
+
+    if (fread(magic, 1, 8, fp) != 8 ||
+	memcmp(magic, PGA_CHECKPOINT_MAGIC, 8) != 0)
+	PGAError(ctx, "PGAReadCheckpoint: Checkpoint file is truncated:",
+		 PGA_FATAL, PGA_CHAR, (void *) filename);
+    fclose(fp);
+
+    PGADebugExited("PGAReadCheckpoint");
+}
+
+/*U****************************************************************************
+   PGASetCheckpointFile - names the file that PGAUpdateGeneration writes a
+   checkpoint to (see PGAWriteCheckpoint), every so many generations as set
+   by PGASetCheckpointFrequencyValue.  By default no checkpoints are written.
+
+   Category: Generation
+
+   Inputs:
+      ctx      - context variable
+      filename - name of the checkpoint file
+
+   Outputs:
+      None
+
+   Example:
+      PGAContext *ctx;
+      :
+      PGASetCheckpointFile(ctx, "run.ckpt");
+
+****************************************************************************U*/
+void PGASetCheckpointFile(PGAContext *ctx, char *filename)
+{
+    PGADebugEntered("PGASetCheckpointFile");
+    PGAFailIfSetUp("PGASetCheckpointFile");
+
+    free(ctx->rep.CheckpointFile);
+    ctx->rep.CheckpointFile = (char *)malloc(strlen(filename) + 1);
+    if (ctx->rep.CheckpointFile == NULL)
+	PGAError(ctx, "PGASetCheckpointFile: No room to allocate "
+		 "ctx->rep.CheckpointFile", PGA_FATAL, PGA_VOID, NULL);
+    strcpy(ctx->rep.CheckpointFile, filename);
+
+    PGADebugExited("PGASetCheckpointFile");
+}
+
+/*U****************************************************************************
+   PGASetCheckpointFrequencyValue - specifies how many generations apart
+   checkpoints are written, if PGASetCheckpointFile named a file.  The
+   default is every 100 generations.
+
+   Category: Generation
+
+   Inputs:
+      ctx  - context variable
+      freq - generations between checkpoints
+
+   Outputs:
+      None
+
+   Example:
+      PGAContext *ctx;
+      :
+      PGASetCheckpointFrequencyValue(ctx, 500);
+
+****************************************************************************U*/
+void PGASetCheckpointFrequencyValue(PGAContext *ctx, int freq)
+{
+    PGADebugEntered("PGASetCheckpointFrequencyValue");
+
+    if (freq <= 0)
+	PGAError(ctx, "PGASetCheckpointFrequencyValue: Invalid value of freq:",
+		 PGA_FATAL, PGA_INT, (void *) &freq);
+    else
+	ctx->rep.CheckpointFreq = freq;
+
+    PGADebugExited("PGASetCheckpointFrequencyValue");
+}
+
+/*U****************************************************************************
+   PGAGetCheckpointFrequencyValue - returns how many generations apart
+   checkpoints are written
+
+   Category: Generation
+
+   Inputs:
+      ctx - context variable
+
+   Outputs:
+      The number of generations between checkpoints
+
+   Example:
+      PGAContext *ctx;
+      int freq;
+      :
+      freq = PGAGetCheckpointFrequencyValue(ctx);
+
+****************************************************************************U*/
+int PGAGetCheckpointFrequencyValue(PGAContext *ctx)
+{
+    PGADebugEntered("PGAGetCheckpointFrequencyValue");
+    PGAFailIfNotSetUp("PGAGetCheckpointFrequencyValue");
+
+    PGADebugExited("PGAGetCheckpointFrequencyValue");
+
+    return(ctx->rep.CheckpointFreq);
+}
+
+/*U****************************************************************************
+   PGASetResumeFile - names a checkpoint file that PGASetUp reads (see
+   PGAReadCheckpoint) after creating the populations, so that the GA resumes
+   where the checkpoint was written instead of starting over.
+
+   Category: Generation
+
+   Inputs:
+      ctx      - context variable
+      filename - name of the checkpoint file
+
+   Outputs:
+      None
+
+   Example:
+      Carry on with a run that wrote checkpoints to run.ckpt
+
+      PGAContext *ctx;
+      :
+      PGASetCheckpointFile(ctx, "run.ckpt");
+      PGASetResumeFile(ctx, "run.ckpt");
+      PGASetUp(ctx);
+      PGARun(ctx, evaluate);
+
+****************************************************************************U*/
+void PGASetResumeFile(PGAContext *ctx, char *filename)
+{
+    PGADebugEntered("PGASetResumeFile");
+    PGAFailIfSetUp("PGASetResumeFile");
+
+    free(ctx->init.ResumeFile);
+    ctx->init.ResumeFile = (char *)malloc(strlen(filename) + 1);
+    if (ctx->init.ResumeFile == NULL)
+	PGAError(ctx, "PGASetResumeFile: No room to allocate "
+		 "ctx->init.ResumeFile", PGA_FATAL, PGA_VOID, NULL);
+    strcpy(ctx->init.ResumeFile, filename);
+
+    PGADebugExited("PGASetResumeFile");
+}
@@ -133,20 +133,32 @@ void PGADestroy (PGAContext *ctx)
      */
     if (ctx->sys.SetUpCalled == PGA_TRUE) {
       /*  Free the population...fly little birdies!  You're FREE!!!  */
-      for ( i = 0; i < ctx->ga.PopSize + 2; i++ ) {
-        free ( ctx->ga.oldpop[i].chrom );
-        free ( ctx->ga.newpop[i].chrom );
-      }
+      if ( ctx->init.ContiguousPop == PGA_TRUE ) {
+        free ( ctx->ga.oldpop[0].chrom );
+        free ( ctx->ga.newpop[0].chrom );
+      } else
+        for ( i = 0; i < ctx->ga.PopSize + 2; i++ ) {
+          free ( ctx->ga.oldpop[i].chrom );
+          free ( ctx->ga.newpop[i].chrom );
+        }
       free ( ctx->ga.oldpop );
       free ( ctx->ga.newpop );
 
       /*  Free the scratch space.  */
       free ( ctx->scratch.intscratch );
       free ( ctx->scratch.dblscratch );
+      free ( ctx->scratch.sortscratch );
       free ( ctx->ga.selected );
       free ( ctx->ga.sorted );
+      free ( ctx->ga.dup.slot );
+
+      PGAStopThreads(ctx);
     }
 
+    /*  These are allocated before PGASetUp, if at all  */
+    free ( ctx->rep.CheckpointFile );
+    free ( ctx->init.ResumeFile );
+
     /*  These are allocated by PGACreate  */
     if (ctx->ga.datatype == PGA_DATATYPE_REAL)
       {
@@ -409,7 +409,7 @@ int PGAGetBestIndex(PGAContext *ctx, int pop)
     source = PGAGetIndividual ( ctx, p, PGA_NEWPOP );
 
 ****************************************************************************I*/
-PGAIndividual *PGAGetIndividual ( PGAContext *ctx, int p, int pop)
+PGAIndividual *(PGAGetIndividual) ( PGAContext *ctx, int p, int pop)
 {
     PGAIndividual *ind;
 
@@ -432,7 +432,7 @@ PGAIndividual *PGAGetIndividual ( PGAContext *ctx, int p, int pop)
         PGAError(ctx, "PGAGetIndividual: Invalid value of pop:",
 		 PGA_FATAL, PGA_INT, (void *) &pop );
 
-    if (p>0 && p<ctx->ga.PopSize)
+    if (p>=0 && p<ctx->ga.PopSize)
       ind += p;
     else
       if (p == PGA_TEMP1)
@@ -342,6 +342,19 @@ false.
 NOTE: The skip_prng_reseeding feature is implemented in spamd as of 3.4.0
 which allows spamd to call srand() right after forking a child process.
 
+=item async_idle_callback
+
+A code reference which is called by C<Mail::SpamAssassin::AsyncLoop> when a
+scan is about to sleep waiting for responses to asynchronous lookups (such as
+DNS blocklist queries).  It is called with the intended waiting time in
+seconds as its only argument, and the time spent in the callback is
+subtracted from that wait.  The callback may perform unrelated work in the
+meantime, including running a nested C<check()> on another message; a
+nested scan leaves the DNS responses of the outer scan alone.  Note that any
+work done here adds to the latency of the waiting scan.  (default: none)
+
+NOTE: spamd uses this for its B<--child-concurrency> option as of 4.0.2.
+
 =back
 
 If none of C<rules_filename>, C<site_rules_filename>, C<userprefs_filename>, or
@@ -569,6 +569,17 @@ sub complete_lookups {
   # thrown die()s before (bug 3794).
   eval {
 
+    # let the caller do other work instead of sleeping in 'select',
+    # see async_idle_callback in Mail::SpamAssassin
+    my $idle_cb = $self->{main}->{async_idle_callback};
+    if ($idle_cb && %$pending && defined $timeout && $timeout > 0) {
+      $idle_cb->($timeout);
+      my $spent = time - $now;
+      dbg("async: idle callback took %.3f s", $spent);
+      $timeout = $spent >= $timeout ? 0 : $timeout - $spent;
+      $now = time;
+    }
+
     if (%$pending) {  # any outstanding requests still?
       $self->{last_poll_responses_time} = $now;
       my ($nfound, $ncb) = $self->{main}->{resolver}->poll_responses($timeout);
@@ -706,7 +717,13 @@ sub abort_remaining_lookups {
 
   dbg("async: aborted %d remaining lookups", $foundcnt)  if $foundcnt > 0;
   delete $self->{last_poll_responses_time};
-  $self->{main}->{resolver}->bgabort();
+  if (($self->{main}->{scan_nesting} || 0) > 1) {
+    # an outer scan shares the resolver, only drop our own callbacks
+    $self->{main}->{resolver}->bgabort(
+      grep { defined } map { $_->{id} } values %{$self->{all_lookups}});
+  } else {
+    $self->{main}->{resolver}->bgabort();
+  }
   1;
 }
 
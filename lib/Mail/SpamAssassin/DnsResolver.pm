@@ -955,17 +955,25 @@ sub flush_responses {
 
 ###########################################################################
 
-=item $res-E<gt>bgabort()
+=item $res-E<gt>bgabort( [ @ids ] )
 
 Call this to release pending requests from memory, when aborting backgrounded
 requests, or when the scan is complete.
 C<Mail::SpamAssassin::PerMsgStatus::check> calls this before returning.
 
+If a list of query ids (as returned by C<bgsend>) is given, only the
+callbacks for these queries are released.  This is used by a nested scan,
+which must not discard the pending requests of an outer scan.
+
 =cut
 
 sub bgabort {
-  my ($self) = @_;
-  $self->{id_to_callback} = {};
+  my ($self, @ids) = @_;
+  if (@ids) {
+    delete @{$self->{id_to_callback}}{@ids};
+  } else {
+    $self->{id_to_callback} = {};
+  }
 }
 
 ###########################################################################
@@ -368,6 +368,8 @@ Runs the SpamAssassin rules against the message pointed to by the object.
 
 sub check {
   my ($self) = shift;
+  # count scans in progress, a caller may nest them from an async idle callback
+  local $self->{main}->{scan_nesting} = ($self->{main}->{scan_nesting} || 0) + 1;
   my $master_deadline = $self->{master_deadline};
   if (!$master_deadline) {
     $self->check_timed(@_);
@@ -390,8 +392,9 @@ sub check_timed {
   $self->{head_only_points} = 0;
   $self->{score} = 0;
 
-  # flush any old stale DNS responses
-  $self->{main}->{resolver}->flush_responses();
+  # flush any old stale DNS responses, unless an outer scan still awaits them
+  $self->{main}->{resolver}->flush_responses()
+    if $self->{main}->{scan_nesting} <= 1;
 
   # clear NetSet cache before every check to prevent it growing too large
   foreach my $nset_name (qw(internal_networks trusted_networks msa_networks)) {
@@ -452,7 +455,7 @@ sub check_timed {
   dbg("check: subtests=".$self->get_names_of_subtests_hit("dbg"));
   $self->{is_spam} = $self->is_spam();
 
-  $self->{main}->{resolver}->bgabort();
+  $self->{main}->{resolver}->bgabort()  if $self->{main}->{scan_nesting} <= 1;
   $self->{main}->call_plugins ("check_end", { permsgstatus => $self });
 
   1;
@@ -273,16 +273,18 @@ NEXT_RULE:
   dbg("zoom: $ruletype: found ".(scalar @good_bases).
       " usable base strings in $yes rules, skipped $no rules");
 
-  # NOTE: re2c will attempt to provide the longest pattern that matched; e.g.
-  # ("food" =~ "foo" / "food") will return "food".  So therefore if a pattern
-  # subsumes other patterns, we need to return hits for all of them.  We also
-  # need to take care of the case where multiple regexps wind up sharing the
-  # same base.   
+  # NOTE: the compiled scanner reports every base it finds, including those
+  # inside longer ones; e.g. ("food" =~ "foo" / "food") will return both.
+  # Scanners built with re2c only returned the longest pattern that matched,
+  # "food", so if a pattern subsumes other patterns, we still return hits
+  # for all of them from it, which costs nothing beyond duplicate hits.  We
+  # also need to take care of the case where multiple regexps wind up
+  # sharing the same base.
   #
   # Another gotcha, an exception to the subsumption rule; if one pattern isn't
   # entirely subsumed (e.g. "food" =~ "foo" / "ood"), then they will be
   # returned as two hits, correctly.  So we only have to be smart about the
-  # full-subsumption case; overlapping is taken care of for us, by re2c.
+  # full-subsumption case; overlapping is taken care of for us by the scanner.
   #
   # TODO: there's a bug here.  Since the code in extract_hints() has been
   # modified to support more complex regexps, we can no longer simply assume
@@ -1149,4 +1151,38 @@ sub fixup_re {
   return $output;
 }
 
+=over 4
+
+=item my $bytes = base_bytes($regexp);
+
+Returns the octets a base string matches, reading its escapes the way
+fixup_re() does, for scanners which search for it as a plain string.
+
+=back
+
+=cut
+
+sub base_bytes {
+  my $re = shift;
+
+  my $output = "";
+  local ($1);
+  while ($re =~ /\G([^\\]*)\\/gcs) {
+    $output .= $1;
+    $re =~ /\G(x\{[^\}]+\}|[0-7]{1,3}|.)/gcs or die "\\ at end of string!";
+    my $esc = $1;
+    if ($esc =~ /^x\{(\S+)\}\z/) {
+      $output .= chr(hex($1));
+    } elsif ($esc =~ /^[0-7]{1,3}\z/) {
+      $output .= chr(oct($esc));
+    } else {
+      $output .= $esc;
+    }
+  }
+  $output .= substr($re, pos($re) || 0);
+
+  utf8::encode($output)  if utf8::is_utf8($output); # force octets
+  return $output;
+}
+
 1;
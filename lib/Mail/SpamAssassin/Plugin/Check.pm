@@ -201,7 +201,9 @@ sub check_main {
     $pms->harvest_dnsbl_queries();
     $pms->rbl_finish();
     $self->{main}->call_plugins ("check_post_dnsbl", { permsgstatus => $pms });
-    $pms->{resolver}->finish_socket() if $pms->{resolver};
+    # keep the socket open for an outer scan still waiting for responses
+    $pms->{resolver}->finish_socket()
+      if $pms->{resolver} && ($self->{main}->{scan_nesting} || 0) <= 1;
   }
 
   if ($pms->{deadline_exceeded}) {
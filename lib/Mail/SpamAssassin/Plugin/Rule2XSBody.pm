@@ -28,7 +28,7 @@ This plugin will use native-code object files representing the ruleset,
 in order to provide significant speedups in rule evaluation.
 
 Note that C<sa-compile> must be run in advance, in order to compile the
-ruleset using C<re2c> and the C compiler.  See the C<sa-compile>
+ruleset using the C compiler.  See the C<sa-compile>
 documentation for more details.
 
 =cut
@@ -94,9 +94,10 @@ sub setup_test_set_pri {
 
   my $modname = "Mail::SpamAssassin::CompiledRegexps::".$ruletype;
   my $modpath = "Mail/SpamAssassin/CompiledRegexps/".$ruletype.".pm";
-  my $hasrules;
+  my ($hasrules, $foldscase);
 
-  if (!eval qq{ use $modname; \$hasrules = \$${modname}::HAS_RULES; 1; }) {
+  if (!eval qq{ use $modname; \$hasrules = \$${modname}::HAS_RULES;
+                \$foldscase = \$${modname}::FOLDS_CASE; 1; }) {
     # the module isn't available, so no rules will be either
     dbg "zoom: no compiled ruleset found for $modname";
     return 0;
@@ -185,6 +186,11 @@ sub setup_test_set_pri {
 
     $conf->{zoom_ruletypes_available} ||= { };
     $conf->{zoom_ruletypes_available}->{$ruletype} = 1;
+
+    # modules built by older versions of sa-compile must be given
+    # lowercased lines
+    $conf->{zoom_folds_case} ||= { };
+    $conf->{zoom_folds_case}->{$ruletype} = $foldscase ? 1 : 0;
     return 1;
   }
   else {
@@ -231,17 +237,19 @@ sub run_body_fast_scan {
 
   my $scoresptr = $conf->{scores};
   my $modname = "Mail::SpamAssassin::CompiledRegexps::".$ruletype;
+  my $foldscase = $conf->{zoom_folds_case}->{$ruletype};
 
   {
     no strict "refs";
+    my $scan = \&{$modname.'::scan'};
     my $lineidx;
     foreach my $line (@{$params->{lines}})
     {
       $lineidx++;
 
-      # unfortunately, calling lc() here seems to be the fastest
-      # way to support this and still work with UTF-8 ok
-      my $results = &{$modname.'::scan'}(lc $line);
+      # the compiled scanner folds case itself, reading the line where
+      # it is; only modules from an older sa-compile need an lc() copy
+      my $results = $foldscase ? $scan->($line) : $scan->(lc $line);
 
       my %alreadydone;
       foreach my $ruleandflags (@{$results})
@@ -261,7 +269,7 @@ sub run_body_fast_scan {
           next;
         }
 
-        # non-lossy rules; the re2c version matches exactly what
+        # non-lossy rules; the compiled version matches exactly what
         # the perl regexp matches, so we don't need to perform
         # a validation match to follow up; it's a hit!
         if ($flags =~ /\bl=0/) {
@@ -0,0 +1,243 @@
+# spamd child CPU and NUMA affinity
+#
+# <@LICENSE>
+# Licensed to the Apache Software Foundation (ASF) under one or more
+# contributor license agreements.  See the NOTICE file distributed with
+# this work for additional information regarding copyright ownership.
+# The ASF licenses this file to you under the Apache License, Version 2.0
+# (the "License"); you may not use this file except in compliance with
+# the License.  You may obtain a copy of the License at:
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# </@LICENSE>
+
+package Mail::SpamAssassin::SpamdAffinity;
+
+use strict;
+use warnings;
+# use bytes;
+use re 'taint';
+
+use Config;
+
+use Mail::SpamAssassin::Logger;
+
+our @ISA = qw();
+
+###########################################################################
+
+# Pins spamd children to sets of CPUs.  The parent picks a set for each new
+# child, the least used one, in turn, and the child applies it right after
+# the fork.  When a set lies within a single NUMA node, the child also
+# prefers that node for its memory allocations, so that the pages it touches
+# from then on (Bayes database, per-message data, copies of shared pages it
+# writes to) are local to the CPUs it runs on.
+#
+# Linux only: uses sched_setaffinity(2) and set_mempolicy(2) through
+# syscall(), there is no libnuma binding in core perl.
+
+use constant SYSFS_CPU  => '/sys/devices/system/cpu';
+use constant SYSFS_NODE => '/sys/devices/system/node';
+
+use constant MPOL_PREFERRED => 1;
+
+# size of the CPU and node masks passed to the kernel, in bits
+use constant MASK_BITS => 1024;
+
+# syscall numbers, for when syscall.ph is not installed
+our %SYSCALLS = (
+  'x86_64'  => { sched_setaffinity => 203, set_mempolicy => 238 },
+  'i386'    => { sched_setaffinity => 241, set_mempolicy => 276 },
+  'i686'    => { sched_setaffinity => 241, set_mempolicy => 276 },
+  'aarch64' => { sched_setaffinity => 122, set_mempolicy => 237 },
+  'riscv64' => { sched_setaffinity => 122, set_mempolicy => 237 },
+);
+
+###########################################################################
+
+# $spec is "cpu" (one set per CPU), "numa" (one set per NUMA node), or CPU
+# lists separated by colons, e.g. "0-7,16-23:8-15,24-31".  Dies on errors.
+sub new {
+  my $class = shift;
+  $class = ref($class) || $class;
+
+  my ($spec) = @_;
+  my $self = {
+    sets => [ ],          # [ { cpus => [...], node => $n or undef } ]
+    kids => { },          # pid => set index
+    next => 0,
+  };
+  bless ($self, $class);
+
+  $^O eq 'linux'
+    or die "spamd: cpu-affinity is only supported on Linux\n";
+  $self->{syscalls} = _syscall_numbers();
+
+  my %node_of_cpu = _read_cpu_nodes();
+  my @cpus;
+  if ($spec eq 'cpu') {
+    @cpus = map { [ $_ ] } _parse_cpu_list(_read_sysfs(SYSFS_CPU.'/online'));
+  } elsif ($spec eq 'numa') {
+    my %cpus_of_node;
+    push(@{$cpus_of_node{$node_of_cpu{$_}}}, $_)  for keys %node_of_cpu;
+    @cpus = map { [ sort { $a <=> $b } @{$cpus_of_node{$_}} ] }
+              sort { $a <=> $b } keys %cpus_of_node;
+    @cpus or die "spamd: cpu-affinity: no NUMA nodes found in ".SYSFS_NODE."\n";
+  } else {
+    @cpus = map { [ _parse_cpu_list($_) ] } split(/:/, $spec);
+  }
+
+  foreach my $set (@cpus) {
+    @$set or die "spamd: cpu-affinity: empty CPU set in '$spec'\n";
+    my %nodes;
+    $nodes{defined $node_of_cpu{$_} ? $node_of_cpu{$_} : -1} = 1  for @$set;
+    my @nodes = keys %nodes;
+    push(@{$self->{sets}}, {
+          cpus => $set,
+          node => (@nodes == 1 && $nodes[0] >= 0 ? $nodes[0] : undef),
+        });
+  }
+
+  dbg("spamd: cpu-affinity: %d CPU sets: %s", scalar @{$self->{sets}},
+      join(' ', map { join(',', @{$_->{cpus}})
+                      . (defined $_->{node} ? "\@node$_->{node}" : '')
+                    } @{$self->{sets}}));
+  $self;
+}
+
+sub _syscall_numbers {
+  # prefer the system's definitions
+  my %nr;
+  if (eval { package main; require 'syscall.ph'; 1 }) {
+    $nr{sched_setaffinity} = eval { &main::SYS_sched_setaffinity };
+    $nr{set_mempolicy} = eval { &main::SYS_set_mempolicy };
+    return \%nr  if defined $nr{sched_setaffinity};
+  }
+  my ($arch) = ($Config{archname} =~ /^([^-]+)/);
+  $arch = 'i386'  if $arch eq 'x86_64' && $Config{ptrsize} == 4;
+  $SYSCALLS{$arch}
+    or die "spamd: cpu-affinity: unknown syscall numbers for $arch\n";
+  return $SYSCALLS{$arch};
+}
+
+sub _read_sysfs {
+  my ($path) = @_;
+  open(my $fh, '<', $path) or die "spamd: cpu-affinity: cannot read $path: $!\n";
+  my $line = <$fh>;
+  close $fh;
+  defined $line or die "spamd: cpu-affinity: $path is empty\n";
+  chomp $line;
+  return $line;
+}
+
+# "0-3,8,10-11" => (0,1,2,3,8,10,11)
+sub _parse_cpu_list {
+  my ($list) = @_;
+  my @cpus;
+  foreach my $range (split(/,/, $list)) {
+    local($1,$2);
+    $range =~ /^\s*(\d+)(?:-(\d+))?\s*\z/
+      or die "spamd: cpu-affinity: invalid CPU list '$list'\n";
+    my ($from, $to) = ($1, defined $2 ? $2 : $1);
+    $from <= $to && $to < MASK_BITS
+      or die "spamd: cpu-affinity: invalid CPU range '$range'\n";
+    push(@cpus, $from .. $to);
+  }
+  return @cpus;
+}
+
+sub _read_cpu_nodes {
+  my %node_of_cpu;
+  opendir(my $dh, SYSFS_NODE) or return;  # no NUMA support
+  foreach my $entry (readdir $dh) {
+    local($1);
+    next if $entry !~ /^node(\d+)\z/;
+    my $node = $1;
+    my $list = eval { _read_sysfs(SYSFS_NODE."/$entry/cpulist") };
+    next if !defined $list || $list eq '';
+    $node_of_cpu{$_} = $node  for _parse_cpu_list($list);
+  }
+  closedir $dh;
+  return %node_of_cpu;
+}
+
+sub _mask {
+  my (@bits) = @_;
+  my $longbits = 8 * $Config{longsize};
+  my @longs = (0) x (MASK_BITS / $longbits);
+  $longs[int($_ / $longbits)] |= 1 << ($_ % $longbits)  for @bits;
+  return pack('L!*', @longs);
+}
+
+###########################################################################
+# Parent methods
+
+# returns the index of the CPU set for the next child
+sub pick_set {
+  my ($self) = @_;
+  my $sets = $self->{sets};
+  my @used = (0) x @$sets;
+  $used[$_]++  for values %{$self->{kids}};
+
+  # the least used set, starting after the one picked last time
+  my $best;
+  for my $i (0 .. $#$sets) {
+    my $idx = ($self->{next} + $i) % @$sets;
+    $best = $idx  if !defined $best || $used[$idx] < $used[$best];
+  }
+  $self->{next} = ($best + 1) % @$sets;
+  return $best;
+}
+
+sub add_child {
+  my ($self, $pid, $idx) = @_;
+  $self->{kids}->{$pid} = $idx;
+}
+
+sub child_exited {
+  my ($self, $pid) = @_;
+  delete $self->{kids}->{$pid};
+}
+
+sub forget_children {
+  my ($self) = @_;
+  $self->{kids} = { };
+}
+
+###########################################################################
+# Child methods
+
+sub apply_set {
+  my ($self, $idx) = @_;
+  my $set = $self->{sets}->[$idx];
+
+  my $mask = _mask(@{$set->{cpus}});
+  if (syscall($self->{syscalls}->{sched_setaffinity}, 0,
+              length($mask), $mask) != 0) {
+    warn "spamd: cpu-affinity: cannot bind to CPUs ".
+         join(',', @{$set->{cpus}}).": $!\n";
+    return;
+  }
+
+  my $where = 'CPUs ' . join(',', @{$set->{cpus}});
+  if (defined $set->{node} && defined $self->{syscalls}->{set_mempolicy}) {
+    my $nodemask = _mask($set->{node});
+    if (syscall($self->{syscalls}->{set_mempolicy}, MPOL_PREFERRED,
+                $nodemask, 8 * length($nodemask)) != 0) {
+      warn "spamd: cpu-affinity: cannot prefer memory of node ".
+           "$set->{node}: $!\n";
+    } else {
+      $where .= ", memory of node $set->{node}";
+    }
+  }
+  dbg("spamd: cpu-affinity: child bound to %s", $where);
+  return 1;
+}
+
+1;
@@ -0,0 +1,309 @@
+# scan result cache shared between spamd child processes
+#
+# <@LICENSE>
+# Licensed to the Apache Software Foundation (ASF) under one or more
+# contributor license agreements.  See the NOTICE file distributed with
+# this work for additional information regarding copyright ownership.
+# The ASF licenses this file to you under the Apache License, Version 2.0
+# (the "License"); you may not use this file except in compliance with
+# the License.  You may obtain a copy of the License at:
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# </@LICENSE>
+
+=head1 NAME
+
+Mail::SpamAssassin::SpamdResultCache - scan results shared between spamd children
+
+=head1 SYNOPSIS
+
+  # in the parent, before forking
+  my $cache = Mail::SpamAssassin::SpamdResultCache->new({
+    entries => 4096, ttl => 600 });
+
+  # in a child
+  my $key = $cache->message_key($mail, $username);
+  my $status = Mail::SpamAssassin::PerMsgStatus->new($spamtest, $mail);
+  if (!$cache->replay($key, $status)) {
+    $status->check();
+    $cache->store($key, $status);
+  }
+
+=head1 DESCRIPTION
+
+Identical messages (MTA retries, one message delivered to several
+recipients, list traffic) tend to reach spamd more than once.  This module
+keeps the final score and rule hits of recent scans in a SysV shared memory
+segment which is created by the spamd parent process and inherited by all
+its children, so that a repeated message is answered without running the
+rules again, whichever child accepts it.
+
+Entries are keyed on the pristine body digest, a digest of the pristine
+header and the user name.  The table is direct-mapped: each key has a single
+slot and a newer result simply replaces whatever was there.  Slots are
+written without locking; every slot carries a checksum of its contents, so a
+reader which races with a writer sees a miss rather than a torn entry.
+
+The segment is marked for removal as soon as it is created, so the kernel
+releases it once the last spamd process has exited.
+
+=head1 METHODS
+
+=over 4
+
+=cut
+
+package Mail::SpamAssassin::SpamdResultCache;
+
+use strict;
+use warnings;
+# use bytes;
+use re 'taint';
+
+use Digest::SHA qw(sha1 sha1_hex);
+use IPC::SysV qw(IPC_PRIVATE IPC_RMID S_IRUSR S_IWUSR shmat shmdt memread memwrite);
+
+use Mail::SpamAssassin::Logger;
+
+our @ISA = qw();
+
+# size of a slot in bytes; results with more rule hits than fit are not cached
+use constant SLOT_SIZE => 1024;
+
+# slot layout: checksum of the rest, payload length, payload
+use constant SLOT_HEADER => 'a20 n';
+use constant SLOT_HEADER_SIZE => 22;
+
+###########################################################################
+
+=item $cache = Mail::SpamAssassin::SpamdResultCache->new({ entries => $n, ttl => $secs })
+
+Creates and attaches a shared memory segment for C<entries> cached results,
+which stay valid for C<ttl> seconds.  Must be called in the parent process
+before forking.  Dies if the segment cannot be created.
+
+=cut
+
+sub new {
+  my $class = shift;
+  $class = ref($class) || $class;
+
+  my ($opts) = @_;
+  my $self = {
+    entries => $opts->{entries},
+    ttl     => $opts->{ttl},
+    hits    => 0,
+    misses  => 0,
+    stored  => 0,
+  };
+  bless ($self, $class);
+
+  my $size = $self->{entries} * SLOT_SIZE;
+  my $id = shmget(IPC_PRIVATE, $size, S_IRUSR | S_IWUSR);
+  defined $id
+    or die "spamd: result cache: cannot create $size bytes shared memory: $!\n";
+  my $addr = shmat($id, undef, 0);
+  my $err = $!;
+  # the segment lives on while attached, and is inherited on fork
+  shmctl($id, IPC_RMID, 0)
+    or warn "spamd: result cache: cannot mark segment for removal: $!\n";
+  defined $addr
+    or die "spamd: result cache: cannot attach shared memory: $err\n";
+  $self->{addr} = $addr;
+
+  dbg("spamd: result cache of %d entries (%d bytes), ttl %d s",
+      $self->{entries}, $size, $self->{ttl});
+  $self;
+}
+
+###########################################################################
+
+=item $key = $cache->message_key($mail, $user)
+
+Returns the cache key for a parsed message (a
+C<Mail::SpamAssassin::Message> object) scanned on behalf of C<$user>.
+
+=cut
+
+sub message_key {
+  my ($self, $mail, $user) = @_;
+  return sha1(join("\0", $mail->get_pristine_body_digest(),
+                         sha1_hex($mail->get_pristine_header()),
+                         defined $user ? $user : ''));
+}
+
+sub _slot_offset {
+  my ($self, $key) = @_;
+  return (unpack('N', $key) % $self->{entries}) * SLOT_SIZE;
+}
+
+###########################################################################
+
+=item $ok = $cache->replay($key, $status)
+
+Looks up C<$key>.  On a hit, registers the cached rule hits with the given
+C<Mail::SpamAssassin::PerMsgStatus> object instead of running the rules, and
+finishes it up as C<check()> would, so that the usual methods (C<get_score>,
+C<rewrite_mail>, C<get_report> etc.) can be used on it.  Returns true on a
+hit, false on a miss.
+
+=cut
+
+sub replay {
+  my ($self, $key, $status) = @_;
+
+  my $slot = '';
+  memread($self->{addr}, $slot, $self->_slot_offset($key), SLOT_SIZE);
+  my ($sum, $len) = unpack(SLOT_HEADER, $slot);
+  my $payload = $len && $len <= SLOT_SIZE - SLOT_HEADER_SIZE
+                  ? substr($slot, SLOT_HEADER_SIZE, $len) : '';
+
+  my ($entry_key, $expires, $score, $hits);
+  if ($payload ne '' && sha1($payload) eq $sum) {
+    ($entry_key, $expires, $score, $hits) = unpack('a20 N d n/a*', $payload);
+  }
+  if (!defined $entry_key || $entry_key ne $key || $expires < time) {
+    $self->{misses}++;
+    dbg("spamd: result cache miss (%d hits, %d misses)",
+        $self->{hits}, $self->{misses});
+    return 0;
+  }
+
+  $self->{hits}++;
+  dbg("spamd: result cache hit, score %s (%d hits, %d misses)",
+      $score, $self->{hits}, $self->{misses});
+
+  # the hits keep the scores they had in the scan, which a plugin may have
+  # given dynamically; got_hit() would copy them into the config, or drop
+  # the hits the config scores 0, so they are registered directly
+  my $conf = $status->{conf};
+  my %hit_scores;
+  foreach my $hit (split(/\n/, $hits)) {
+    my ($rule, $rule_score, $area) = split(/\t/, $hit, 3);
+    next if $status->{tests_already_hit}->{$rule};
+    $status->{tests_already_hit}->{$rule} = 1;
+    $hit_scores{$rule} = $rule_score;
+
+    my $desc = $conf->get_description_for_rule($rule);
+    $desc = "No description available."  if !defined $desc || $desc eq '';
+    $status->_handle_hit($rule, $rule_score, $area, 'cached', $desc);
+
+    my $prefix = $conf->{subjprefix}->{$rule};
+    if (defined $prefix && defined $conf->{rewrite_header}->{Subject}) {
+      $status->{subjprefix} ||= '';
+      $status->{subjprefix} .= "$prefix "
+        if index($status->{subjprefix}, $prefix) == -1;
+    }
+  }
+  {
+    # the report lists the scores of the hits, taken from the config
+    local @{$conf->{scores}}{keys %hit_scores} = values %hit_scores;
+    $status->check_cleanup();
+  }
+  $status->{score} = $score;
+  $status->{is_spam} = $status->is_spam();
+  $status->{result_from_cache} = 1;
+  return 1;
+}
+
+###########################################################################
+
+=item $cache->store($key, $status)
+
+Stores the result of a completed scan under C<$key>.  Scans which were cut
+short by a time limit are not stored.
+
+=cut
+
+sub store {
+  my ($self, $key, $status) = @_;
+
+  return if $status->{deadline_exceeded};
+
+  my $scores = $status->{conf}->{scores};
+  my $test_logs = $status->{test_logs};
+  my $hits = join("\n", map {
+      join("\t", $_, $scores->{$_},
+                 defined $test_logs->{$_}->{area} ? $test_logs->{$_}->{area}
+                                                   : '')
+    } @{$status->{test_names_hit}});
+
+  my $payload = pack('a20 N d n/a*', $key, time + $self->{ttl},
+                     $status->get_score(), $hits);
+  if (length($payload) > SLOT_SIZE - SLOT_HEADER_SIZE) {
+    dbg("spamd: result cache: %d bytes of rule hits do not fit a slot",
+        length($hits));
+    return;
+  }
+  my $slot = pack(SLOT_HEADER, sha1($payload), length($payload)) . $payload;
+  memwrite($self->{addr}, $slot, $self->_slot_offset($key), length($slot));
+  $self->{stored}++;
+}
+
+###########################################################################
+
+=item $cache->forget($key)
+
+Drops a cached result, e.g. after the message was learned or reported.
+
+=cut
+
+sub forget {
+  my ($self, $key) = @_;
+
+  my $offset = $self->_slot_offset($key);
+  my $slot = '';
+  memread($self->{addr}, $slot, $offset, SLOT_HEADER_SIZE + 20);
+  return if substr($slot, SLOT_HEADER_SIZE, 20) ne $key;
+
+  memwrite($self->{addr}, "\0" x SLOT_HEADER_SIZE, $offset, SLOT_HEADER_SIZE);
+  dbg("spamd: result cache: dropped entry");
+}
+
+###########################################################################
+
+=item $cache->stats()
+
+Returns the number of hits, misses and stored results seen by this process.
+
+=cut
+
+sub stats {
+  my ($self) = @_;
+  return ($self->{hits}, $self->{misses}, $self->{stored});
+}
+
+###########################################################################
+
+=item $cache->detach()
+
+Detaches the shared memory segment from this process, which must not use the
+cache afterwards; e.g. before a reloading spamd creates a new cache.  Other
+processes which inherited the segment keep it: it was marked for removal
+when it was created, so the kernel releases it once the last one detaches.
+
+=cut
+
+sub detach {
+  my ($self) = @_;
+  return if !defined $self->{addr};
+  defined shmdt($self->{addr})
+    or warn "spamd: result cache: cannot detach shared memory: $!\n";
+  delete $self->{addr};
+}
+
+1;
+
+=back
+
+=head1 SEE ALSO
+
+C<spamd>
+
+=cut
@@ -380,13 +380,6 @@ our @OPTIONAL_BINARIES = (
   version_check_params => '--version',
   version_check_regex => 'curl ([\d\.]*)',
   desc => $lwp_note,
-},
-{
-  binary => 're2c',
-  version => '0',
-
-  desc => 'The "re2c" program is used by sa-compile to compile rules 
-  for regular expressions to speed up scanning.',
 }
 );
 
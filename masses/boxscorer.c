@@ -0,0 +1,640 @@
+/* This program fits a scoreset for SpamAssassin to the corpus written by
+ * logs-to-c, by minimizing the logistic loss of the messages with every
+ * mutable score kept within its range.  The minimizer is a projected
+ * limited-memory BFGS method: scores held at a bound by the gradient are
+ * fixed for the step, the others follow the L-BFGS direction, and the step
+ * is cut back along the path projected onto the ranges until the loss goes
+ * down enough.  It is deterministic: a run gives the same scores whatever
+ * the number of threads.
+ *
+ * <@LICENSE>
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to you under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * </@LICENSE>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/time.h>
+
+#include "corpus.h"
+#include "score-kernel.h"
+
+#define OUTPUT_FILE "boxscorer.scores"
+
+/* messages scored at a time, and the unit the loss is summed up in */
+#define SCORE_BLOCK 1024
+
+#define DEFAULT_THRESHOLD 5.0
+double threshold = DEFAULT_THRESHOLD;
+
+const char * corpus_file = CORPUS_FILE;
+const char * output_file = OUTPUT_FILE;
+double ham_preference = 2.0;
+double gain = 1.0;		/* slope of the logistic, per point of score */
+double l2 = 0.0;		/* pull towards the starting scores */
+int max_iterations = 500;
+double tolerance = 1e-6;	/* on the largest projected gradient */
+int memory = 10;		/* L-BFGS correction pairs kept */
+int num_threads = 1;
+
+/* The loss is
+ *
+ *   sum over messages i of c_i * log(1 + exp(-y_i * gain * (score_i - threshold)))
+ *
+ * divided by the sum of the c_i, plus l2/2 times the squared distance of
+ * the scores from the starting ones.  y_i is 1 for spam and -1 for ham; c_i
+ * is the number of times the message was seen, times 1 + ham_preference
+ * times the number of rules it hit for ham, as the perceptron replicates
+ * hard hams.  The scores of the mutable rules are the variables. */
+double * msg_weight;	/* c_i over the sum of them, with the sign of -y_i */
+double * residual;	/* derivative of the loss by the score of message i */
+double * block_loss;	/* loss of each block of SCORE_BLOCK messages */
+int num_blocks;
+
+double * start;		/* starting scores */
+
+/* the messages hitting each rule, as in garescorer */
+unsigned int * rule_start;
+unsigned int * rule_msgs;
+
+/* The evaluation is split between the threads: messages first, a share of
+ * the blocks each, then rules, a share each.  Every block sum and every
+ * gradient entry is added up in the same order whoever does it. */
+static struct {
+	pthread_t * threads;
+	pthread_barrier_t barrier;
+	int stop;
+	const double * x;
+	double * grad;
+} pool;
+
+/* log(1 + exp(-m)), without overflow */
+static double log1pexp_neg (double m) {
+	return m > 0 ? log1p (exp (-m)) : -m + log1p (exp (m));
+}
+
+static void evaluate_share (int id) {
+	double score[SCORE_BLOCK];
+	int b, k, r;
+	unsigned int h;
+
+	for (b = num_blocks * id / num_threads;
+			b < num_blocks * (id + 1) / num_threads; b++) {
+		int first = b * SCORE_BLOCK;
+		int n = num_nondup - first < SCORE_BLOCK ? num_nondup - first : SCORE_BLOCK;
+		double loss = 0;
+
+		score_messages (pool.x, 0.0, first, n, score);
+		for (k = 0; k < n; k++) {
+			int i = first + k;
+			double m = gain * (score[k] + scores[i] - threshold);
+
+			/* msg_weight is negative for spam, so that the margin is
+			 * m * -sign and the loss falls as the margin grows */
+			if ( msg_weight[i] < 0 ) {
+				loss -= msg_weight[i] * log1pexp_neg (m);
+				residual[i] = msg_weight[i] * gain / (1 + exp (m));
+			} else {
+				loss += msg_weight[i] * log1pexp_neg (-m);
+				residual[i] = msg_weight[i] * gain / (1 + exp (-m));
+			}
+		}
+		block_loss[b] = loss;
+	}
+	pthread_barrier_wait (&pool.barrier);
+
+	for (r = num_mutable * id / num_threads;
+			r < num_mutable * (id + 1) / num_threads; r++) {
+		double g = l2 * (pool.x[r] - start[r]);
+
+		for (h = rule_start[r]; h < rule_start[r+1]; h++) {
+			g += residual[rule_msgs[h]];
+		}
+		pool.grad[r] = g;
+	}
+}
+
+static void * pool_thread (void * arg) {
+	int id = (int)(long)arg;
+
+	for (;;) {
+		pthread_barrier_wait (&pool.barrier);
+		if ( pool.stop ) {
+			return NULL;
+		}
+		evaluate_share (id);
+		pthread_barrier_wait (&pool.barrier);
+	}
+}
+
+/* Returns the loss at x, and its gradient in grad. */
+static double evaluate (const double * x, double * grad) {
+	double loss = 0;
+	int b, r;
+
+	pool.x = x;
+	pool.grad = grad;
+	if ( num_threads > 1 ) {
+		pthread_barrier_wait (&pool.barrier);
+	}
+	evaluate_share (0);
+	if ( num_threads > 1 ) {
+		pthread_barrier_wait (&pool.barrier);
+	}
+
+	for (b = 0; b < num_blocks; b++) {
+		loss += block_loss[b];
+	}
+	if ( l2 != 0 ) {
+		double d = 0;
+
+		for (r = 0; r < num_mutable; r++) {
+			d += (x[r] - start[r]) * (x[r] - start[r]);
+		}
+		loss += l2 / 2 * d;
+	}
+	return loss;
+}
+
+static void init_pool () {
+	long t;
+
+	pthread_barrier_init (&pool.barrier, NULL, num_threads);
+	pool.threads = (pthread_t*)calloc(num_threads, sizeof(pthread_t));
+	for (t = 1; t < num_threads; t++) {
+		if ( pthread_create (&pool.threads[t], NULL, pool_thread, (void *)t) != 0 ) {
+			perror ("pthread_create");
+			exit (1);
+		}
+	}
+}
+
+static void destroy_pool () {
+	int t;
+
+	pool.stop = 1;
+	if ( num_threads > 1 ) {
+		pthread_barrier_wait (&pool.barrier);
+	}
+	for (t = 1; t < num_threads; t++) {
+		pthread_join (pool.threads[t], NULL);
+	}
+	pthread_barrier_destroy (&pool.barrier);
+	free (pool.threads);
+}
+
+void init_rule_index () {
+	unsigned int * fill;
+	unsigned int h;
+	int i, r;
+
+	rule_start = (unsigned int*)calloc(num_mutable + 1, sizeof(unsigned int));
+	rule_msgs = (unsigned int*)malloc((hit_start[num_nondup] + 1) * sizeof(unsigned int));
+	fill = (unsigned int*)calloc(num_mutable + 1, sizeof(unsigned int));
+	if ( !rule_start || !rule_msgs || !fill ) {
+		fprintf (stderr, "No room for the rule index\n");
+		exit (1);
+	}
+
+	for (h = 0; h < hit_start[num_nondup]; h++) {
+		rule_start[hit_index[h] + 1]++;
+	}
+	for (r = 0; r < num_mutable; r++) {
+		rule_start[r + 1] += rule_start[r];
+	}
+	memcpy (fill, rule_start, num_mutable * sizeof(unsigned int));
+	for (i = 0; i < num_nondup; i++) {
+		for (h = hit_start[i]; h < hit_start[i+1]; h++) {
+			rule_msgs[fill[hit_index[h]]++] = i;
+		}
+	}
+	free (fill);
+}
+
+/* Works out the weight of each message in the loss, and the starting
+ * scores: the ones in the corpus, within their ranges. */
+void init_problem () {
+	double total = 0;
+	int i, r;
+
+	msg_weight = (double*)malloc((num_nondup + 1) * sizeof(double));
+	residual = (double*)malloc((num_nondup + 1) * sizeof(double));
+	num_blocks = (num_nondup + SCORE_BLOCK - 1) / SCORE_BLOCK;
+	block_loss = (double*)calloc(num_blocks + 1, sizeof(double));
+	start = (double*)malloc((num_mutable + 1) * sizeof(double));
+
+	for (i = 0; i < num_nondup; i++) {
+		double c = tests_count[i];
+
+		if ( !is_spam[i] ) {
+			c *= 1 + ham_preference * num_tests_hit(i);
+		}
+		msg_weight[i] = c;
+		total += c;
+	}
+	for (i = 0; i < num_nondup; i++) {
+		msg_weight[i] /= total;
+		if ( is_spam[i] ) {
+			msg_weight[i] = -msg_weight[i];
+		}
+	}
+
+	for (r = 0; r < num_mutable; r++) {
+		start[r] = bestscores[r] * threshold / DEFAULT_THRESHOLD;
+		if ( start[r] < range_lo[r] ) start[r] = range_lo[r];
+		if ( start[r] > range_hi[r] ) start[r] = range_hi[r];
+	}
+}
+
+/* If the threshold has been changed, the ranges are scaled with it, as the
+ * perceptron does. */
+void scale_scores (double old_threshold, double new_threshold) {
+	int i;
+
+	if ( old_threshold == new_threshold ) {
+		return;
+	}
+	for (i = 0; i < num_scores; i++) {
+		if ( is_mutable[i] ) {
+			range_lo[i] = range_lo[i] * new_threshold / old_threshold;
+			range_hi[i] = range_hi[i] * new_threshold / old_threshold;
+		}
+	}
+}
+
+static double dot (const double * a, const double * b, const unsigned char * free) {
+	double sum = 0;
+	int r;
+
+	for (r = 0; r < num_mutable; r++) {
+		if ( free[r] ) {
+			sum += a[r] * b[r];
+		}
+	}
+	return sum;
+}
+
+/* Finds the scores with the lowest loss, starting from the ones in result,
+ * which they are written back to.  Returns the number of iterations. */
+int minimize (double * result) {
+	int n = num_mutable;
+	double * x = (double*)malloc((n + 1) * sizeof(double));
+	double * g = (double*)malloc((n + 1) * sizeof(double));
+	double * xn = (double*)malloc((n + 1) * sizeof(double));
+	double * gn = (double*)malloc((n + 1) * sizeof(double));
+	double * d = (double*)malloc((n + 1) * sizeof(double));
+	double * alpha = (double*)malloc((memory + 1) * sizeof(double));
+	double ** s = (double**)malloc((memory + 1) * sizeof(double*));
+	double ** y = (double**)malloc((memory + 1) * sizeof(double*));
+	unsigned char * free_var = (unsigned char*)malloc(n + 1);
+	double f, fn, * tmp;
+	int pairs = 0, newest = 0;	/* ring of correction pairs */
+	int iter, k, r;
+
+	for (k = 0; k < memory; k++) {
+		s[k] = (double*)malloc((n + 1) * sizeof(double));
+		y[k] = (double*)malloc((n + 1) * sizeof(double));
+	}
+
+	memcpy (x, result, n * sizeof(double));
+	f = evaluate (x, g);
+	printf ("Starting loss %.8f.\n", f);
+
+	for (iter = 0; iter < max_iterations; iter++) {
+		double pg = 0, gd, step, decrease;
+		int num_free = 0, tries;
+
+		/* the largest step the gradient can take within the ranges, and
+		 * the scores not held at a bound by it */
+		for (r = 0; r < n; r++) {
+			double p = x[r] - g[r];
+
+			if ( p < range_lo[r] ) p = range_lo[r];
+			if ( p > range_hi[r] ) p = range_hi[r];
+			if ( fabs (p - x[r]) > pg ) pg = fabs (p - x[r]);
+			free_var[r] = !((x[r] <= range_lo[r] && g[r] > 0)
+					|| (x[r] >= range_hi[r] && g[r] < 0));
+			num_free += free_var[r];
+		}
+		if ( iter % 10 == 0 ) {
+			printf ("Iteration %d: loss %.8f, projected gradient %.3g, %d of %d scores free.\n",
+					iter, f, pg, num_free, n);
+		}
+		if ( pg <= tolerance ) {
+			break;
+		}
+
+		/* two-loop recursion over the free scores */
+		for (r = 0; r < n; r++) {
+			d[r] = free_var[r] ? -g[r] : 0;
+		}
+		for (k = 0; k < pairs; k++) {
+			int j = (newest - k + memory) % memory;
+			double sy = dot (s[j], y[j], free_var);
+
+			alpha[j] = sy > 0 ? dot (s[j], d, free_var) / sy : 0;
+			for (r = 0; r < n; r++) {
+				if ( free_var[r] ) d[r] -= alpha[j] * y[j][r];
+			}
+		}
+		if ( pairs > 0 ) {
+			double sy = dot (s[newest], y[newest], free_var);
+			double yy = dot (y[newest], y[newest], free_var);
+			double gamma = sy > 0 && yy > 0 ? sy / yy : 1;
+
+			for (r = 0; r < n; r++) {
+				d[r] *= gamma;
+			}
+		}
+		for (k = pairs - 1; k >= 0; k--) {
+			int j = (newest - k + memory) % memory;
+			double sy = dot (s[j], y[j], free_var);
+			double beta = sy > 0 ? dot (y[j], d, free_var) / sy : 0;
+
+			for (r = 0; r < n; r++) {
+				if ( free_var[r] ) d[r] += (alpha[j] - beta) * s[j][r];
+			}
+		}
+
+		gd = dot (g, d, free_var);
+		if ( gd >= 0 ) {
+			/* not downhill over the free scores: start over from the
+			 * gradient */
+			pairs = 0;
+			for (r = 0; r < n; r++) {
+				d[r] = free_var[r] ? -g[r] : 0;
+			}
+		}
+
+		/* backtrack along the projected path until the loss falls by a
+		 * part of what the gradient promises */
+		for (step = 1.0, tries = 0; tries < 40; tries++, step *= 0.5) {
+			decrease = 0;
+			for (r = 0; r < n; r++) {
+				xn[r] = x[r] + step * d[r];
+				if ( xn[r] < range_lo[r] ) xn[r] = range_lo[r];
+				if ( xn[r] > range_hi[r] ) xn[r] = range_hi[r];
+				decrease += g[r] * (xn[r] - x[r]);
+			}
+			fn = evaluate (xn, gn);
+			if ( fn <= f + 1e-4 * decrease ) {
+				break;
+			}
+		}
+		if ( tries == 40 ) {
+			if ( pairs == 0 ) {
+				printf ("No further progress at iteration %d.\n", iter);
+				break;
+			}
+			pairs = 0;
+			continue;
+		}
+
+		/* keep the correction pair if it has positive curvature */
+		k = (newest + 1) % memory;
+		{
+			double sy = 0, yy = 0;
+
+			for (r = 0; r < n; r++) {
+				s[k][r] = xn[r] - x[r];
+				y[k][r] = gn[r] - g[r];
+				sy += s[k][r] * y[k][r];
+				yy += y[k][r] * y[k][r];
+			}
+			if ( sy > 1e-12 * yy ) {
+				newest = k;
+				if ( pairs < memory ) pairs++;
+			}
+		}
+
+		tmp = x; x = xn; xn = tmp;
+		tmp = g; g = gn; gn = tmp;
+		if ( f - fn <= 1e-12 * (fabs (fn) > 1 ? fabs (fn) : 1) ) {
+			f = fn;
+			iter++;
+			break;
+		}
+		f = fn;
+	}
+	printf ("Final loss %.8f after %d iterations.\n", f, iter);
+
+	memcpy (result, x, n * sizeof(double));
+
+	for (k = 0; k < memory; k++) {
+		free (s[k]);
+		free (y[k]);
+	}
+	free (s);
+	free (y);
+	free (alpha);
+	free (free_var);
+	free (d);
+	free (gn);
+	free (xn);
+	free (g);
+	free (x);
+	return iter;
+}
+
+/* Prints a summary of how the messages are classified with the scores,
+ * in the format of perceptron.scores. */
+void write_summary (FILE * fp, const double * x) {
+	double score[SCORE_BLOCK];
+	struct tally t;
+	int first, ga_nn, ga_yy, ga_ny, ga_yn, ham, spam;
+	double nnscore, yyscore, nyscore, ynscore;
+
+	memset (&t, 0, sizeof(t));
+	for (first = 0; first < num_nondup; first += SCORE_BLOCK) {
+		int n = num_nondup - first < SCORE_BLOCK ? num_nondup - first : SCORE_BLOCK;
+		int k;
+
+		score_messages (x, 0.0, first, n, score);
+		for (k = 0; k < n; k++) {
+			score[k] += scores[first+k];
+		}
+		tally_messages (score, tests_count + first, first, n, threshold, &t);
+	}
+	ga_nn = t.count[TALLY_NN];
+	ga_yy = t.count[TALLY_YY];
+	ga_ny = t.count[TALLY_NY];
+	ga_yn = t.count[TALLY_YN];
+	nnscore = t.score[TALLY_NN];
+	yyscore = t.score[TALLY_YY];
+	nyscore = t.score[TALLY_NY];
+	ynscore = t.score[TALLY_YN];
+	ham = ga_nn + ga_ny;
+	spam = ga_yy + ga_yn;
+
+	fprintf (fp,"\n# SUMMARY for threshold %3.1f:\n", threshold);
+	fprintf (fp,
+			"# Correctly non-spam: %6d  %4.2f%%\n",
+			ga_nn,
+			(ga_nn / (float) ham) * 100.0);
+	fprintf (fp,
+			"# Correctly spam:     %6d  %4.2f%%\n",
+			ga_yy,
+			(ga_yy / (float) spam) * 100.0);
+	fprintf (fp,
+			"# False positives:    %6d  %4.2f%%\n",
+			ga_ny,
+			(ga_ny / (float) ham) * 100.0);
+	fprintf (fp,
+			"# False negatives:    %6d  %4.2f%%\n",
+			ga_yn,
+			(ga_yn / (float) spam) * 100.0);
+
+	fprintf (fp,"# Average score for spam:  %3.3f    ham: %3.1f\n",(ynscore+yyscore)/((double)(ga_yn+ga_yy)),(nyscore+nnscore)/((double)(ga_nn+ga_ny)));
+	fprintf (fp,"# Average for false-pos:   %3.3f  false-neg: %3.1f\n",(nyscore/(double)ga_ny),(ynscore/(double)ga_yn));
+
+	fprintf (fp,"# TOTAL:              %6d  %3.2f%%\n\n", ham + spam, 100.0);
+}
+
+/* Writes out the scores, in the format of perceptron.scores. */
+void write_scores (FILE * fp, const double * x) {
+	int i;
+
+	write_summary (fp, x);
+	for (i = 0; i < num_scores; i++) {
+		if ( is_mutable[i] )  {
+			fprintf(fp, "score %-30s %2.3f # [%2.3f..%2.3f]\n", score_names[i], x[i], range_lo[i], range_hi[i]);
+		} else {
+			fprintf(fp, "score %-30s %2.3f # not mutable\n", score_names[i], range_lo[i]);
+		}
+	}
+}
+
+void usage () {
+	printf ("usage: boxscorer [args]\n"
+			"\n"
+			"  -p ham_preference = extra weight of hams, times number of tests hit (2.0 default)\n"
+			"  -t threshold = minimum threshold for spam (5.0 default)\n"
+			"  -g gain = slope of the logistic loss per point of score (1.0 default)\n"
+			"  -r l2 = pull of the scores towards the starting ones (0 default)\n"
+			"  -i iterations = most iterations to run (500 default)\n"
+			"  -e tolerance = stop when no score can move further than this (1e-6 default)\n"
+			"  -m memory = correction pairs kept by L-BFGS (10 default)\n"
+			"  -c corpus = corpus file written by logs-to-c (" CORPUS_FILE " default)\n"
+			"  -o file = file to write the scores to (" OUTPUT_FILE " default)\n"
+			"  -j threads = number of threads to evaluate the loss with (1 default)\n"
+			"  -h = print this help\n"
+			"\n");
+	exit(30);
+}
+
+int main (int argc, char ** argv) {
+	struct timeval tv_start, tv_end;
+	double * x;
+	FILE * fp;
+	int arg, i;
+
+	while ((arg = getopt (argc, argv, "p:t:g:r:i:e:m:c:o:j:h?")) != -1) {
+		switch (arg) {
+			case 'p':
+				ham_preference = atof(optarg);
+				break;
+
+			case 't':
+				threshold = atof(optarg);
+				break;
+
+			case 'g':
+				gain = atof(optarg);
+				break;
+
+			case 'r':
+				l2 = atof(optarg);
+				break;
+
+			case 'i':
+				max_iterations = atoi(optarg);
+				break;
+
+			case 'e':
+				tolerance = atof(optarg);
+				break;
+
+			case 'm':
+				memory = atoi(optarg);
+				break;
+
+			case 'c':
+				corpus_file = optarg;
+				break;
+
+			case 'o':
+				output_file = optarg;
+				break;
+
+			case 'j':
+				num_threads = atoi(optarg);
+				break;
+
+			case 'h':
+			case '?':
+				usage();
+				break;
+		}
+	}
+	if ( num_threads < 1 ) {
+		num_threads = 1;
+	}
+	if ( memory < 1 ) {
+		memory = 1;
+	}
+
+	load_corpus (corpus_file);
+	select_score_kernel (NULL);
+	scale_scores (DEFAULT_THRESHOLD, threshold);
+
+	init_problem ();
+	init_rule_index ();
+	init_pool ();
+
+	/* the immutable scores are already in the base score of each message */
+	x = (double*)calloc(num_scores + 1, sizeof(double));
+	memcpy (x, start, num_mutable * sizeof(double));
+
+	gettimeofday (&tv_start, 0);
+	minimize (x);
+	gettimeofday (&tv_end, 0);
+	printf ("Training time = %fs.\n", (tv_end.tv_sec - tv_start.tv_sec)
+			+ (tv_end.tv_usec - tv_start.tv_usec) / 1000000.0);
+
+	destroy_pool ();
+
+	fp = fopen (output_file, "w");
+	if ( fp ) {
+		write_scores (fp, x);
+		fclose (fp);
+	} else {
+		perror (output_file);
+		return 1;
+	}
+
+	for (i = 0; i < num_mutable; i++) {
+		if ( x[i] < range_lo[i] || x[i] > range_hi[i] ) {
+			fprintf (stderr, "%s out of range\n", score_names[i]);
+			return 1;
+		}
+	}
+	free (x);
+	return 0;
+}
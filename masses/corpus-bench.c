@@ -0,0 +1,322 @@
+/* Measures how fast a scoreset can be evaluated against a corpus, with the
+ * rule hits stored the way tmp/tests.h used to store them (one row of
+ * max_hits_per_msg shorts per message) and in the CSR layout the optimizers
+ * use now, one message at a time and with each of the blocked kernels of
+ * score-kernel.c.  Either loads a corpus written by logs-to-c or makes up
+ * one.
+ *
+ * <@LICENSE>
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to you under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * </@LICENSE>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+#include "corpus.h"
+#include "score-kernel.h"
+
+double threshold = 5.0;
+int passes = 20;
+
+/* the dense layout */
+int max_hits_per_msg;
+unsigned char *dense_num_tests_hit;
+unsigned short *dense_tests_hit;	/* [num_nondup][max_hits_per_msg] */
+
+double *lookup;
+
+/* tallies, as in garescorer */
+int ga_yy, ga_yn, ga_ny, ga_nn;
+double yyscore, ynscore, nyscore, nnscore;
+
+static void tally (int i, double msg_score) {
+	if ( is_spam[i] ) {
+		if ( msg_score >= threshold ) {
+			ga_yy += tests_count[i];
+			yyscore += msg_score * tests_count[i];
+		} else {
+			ga_yn += tests_count[i];
+			ynscore += msg_score * tests_count[i];
+		}
+	} else {
+		if ( msg_score >= threshold ) {
+			ga_ny += tests_count[i];
+			nyscore += msg_score * tests_count[i];
+		} else {
+			ga_nn += tests_count[i];
+			nnscore += msg_score * tests_count[i];
+		}
+	}
+}
+
+static void reset_tally () {
+	ga_yy = ga_yn = ga_ny = ga_nn = 0;
+	yyscore = ynscore = nyscore = nnscore = 0.0;
+}
+
+static void evaluate_dense () {
+	int i, j;
+
+	for (i = num_nondup-1; i >= 0; i--) {
+		const unsigned short *row = dense_tests_hit + (size_t)i * max_hits_per_msg;
+		double msg_score = 0.0;
+
+		for (j = dense_num_tests_hit[i]-1; j >= 0; j--) {
+			msg_score += lookup[row[j]];
+		}
+		tally (i, msg_score + scores[i]);
+	}
+}
+
+static void evaluate_csr () {
+	int i;
+
+	for (i = num_nondup-1; i >= 0; i--) {
+		const unsigned short *hits = hit_index + hit_start[i];
+		double msg_score = 0.0;
+		int j;
+
+		for (j = num_tests_hit(i)-1; j >= 0; j--) {
+			msg_score += lookup[hits[j]];
+		}
+		tally (i, msg_score + scores[i]);
+	}
+}
+
+/* messages scored at a time by the kernels */
+#define BLOCK 1024
+
+static void evaluate_kernel () {
+	double msg_score[BLOCK];
+	struct tally t;
+	int first, k;
+
+	memset (&t, 0, sizeof(t));
+	for (first = 0; first < num_nondup; first += BLOCK) {
+		int n = num_nondup - first < BLOCK ? num_nondup - first : BLOCK;
+
+		score_messages (lookup, 0.0, first, n, msg_score);
+		for (k = 0; k < n; k++) {
+			msg_score[k] += scores[first+k];
+		}
+		tally_messages (msg_score, tests_count + first, first, n, threshold, &t);
+	}
+	ga_nn = t.count[TALLY_NN];
+	ga_ny = t.count[TALLY_NY];
+	ga_yn = t.count[TALLY_YN];
+	ga_yy = t.count[TALLY_YY];
+	nnscore = t.score[TALLY_NN];
+	nyscore = t.score[TALLY_NY];
+	ynscore = t.score[TALLY_YN];
+	yyscore = t.score[TALLY_YY];
+}
+
+/* Checks that the kernel in use scores every message exactly as a plain
+ * loop adding up the hits in order does. */
+static void check_kernel (const char *name) {
+	double msg_score[BLOCK];
+	int first, k;
+
+	for (first = 0; first < num_nondup; first += BLOCK) {
+		int n = num_nondup - first < BLOCK ? num_nondup - first : BLOCK;
+
+		score_messages (lookup, 0.0, first, n, msg_score);
+		for (k = 0; k < n; k++) {
+			double sum = 0.0;
+			unsigned int h;
+
+			for (h = hit_start[first+k]; h < hit_start[first+k+1]; h++) {
+				sum += lookup[hit_index[h]];
+			}
+			if ( msg_score[k] != sum ) {
+				fprintf (stderr, "%s kernel: message %d scores %.17g, not %.17g\n",
+						name, first + k, msg_score[k], sum);
+				exit (1);
+			}
+		}
+	}
+}
+
+/* Makes up a corpus of n messages over r mutable rules.  Most messages hit
+ * a handful of rules; one in a thousand is an outlier hitting up to
+ * max_hits of them, which is what sizes the dense layout. */
+static void make_corpus (int n, int r, int max_hits) {
+	unsigned int total = 0;
+	int i, j;
+
+	num_tests = num_nondup = n;
+	num_scores = num_mutable = r;
+	num_spam = num_ham = 0;
+
+	is_spam = malloc (n);
+	tests_count = malloc (n * sizeof(int));
+	scores = malloc (n * sizeof(double));
+	hit_start = malloc ((n + 1) * sizeof(unsigned int));
+	for (i = 0; i < n; i++) {
+		int k = (lrand48() % 1000 == 0) ? 1 + lrand48() % max_hits
+						: 1 + lrand48() % 12;
+		hit_start[i] = total;
+		total += k;
+		is_spam[i] = lrand48() & 1;
+		if ( is_spam[i] ) num_spam++; else num_ham++;
+		tests_count[i] = 1;
+		scores[i] = drand48() * 4.0 - 2.0;
+	}
+	hit_start[n] = total;
+	hit_index = malloc ((total + 1) * sizeof(unsigned short));
+	for (i = 0; i < n; i++) {
+		for (j = hit_start[i]; j < hit_start[i+1]; j++) {
+			hit_index[j] = lrand48() % r;
+		}
+	}
+}
+
+static void make_dense () {
+	int i, j;
+
+	max_hits_per_msg = 0;
+	for (i = 0; i < num_nondup; i++) {
+		if ( (int)num_tests_hit(i) + 1 > max_hits_per_msg ) {
+			max_hits_per_msg = num_tests_hit(i) + 1;
+		}
+	}
+	if ( max_hits_per_msg > 256 ) {
+		fprintf (stderr, "%d hits in one message do not fit the dense layout's counts\n",
+				max_hits_per_msg - 1);
+		exit (1);
+	}
+	dense_num_tests_hit = calloc (num_nondup, 1);
+	dense_tests_hit = calloc ((size_t)num_nondup * max_hits_per_msg,
+			sizeof(unsigned short));
+	if ( !dense_num_tests_hit || !dense_tests_hit ) {
+		fprintf (stderr, "No room for the dense layout\n");
+		exit (1);
+	}
+	for (i = 0; i < num_nondup; i++) {
+		dense_num_tests_hit[i] = num_tests_hit(i);
+		for (j = 0; j < (int)num_tests_hit(i); j++) {
+			dense_tests_hit[(size_t)i * max_hits_per_msg + j] =
+				hit_index[hit_start[i] + j];
+		}
+	}
+}
+
+static double now () {
+	struct timeval tv;
+
+	gettimeofday (&tv, 0);
+	return tv.tv_sec + tv.tv_usec * 1.0e-6;
+}
+
+static void run (const char *name, void (*evaluate)(), size_t bytes) {
+	double t0, dt;
+	int p;
+
+	evaluate ();	/* warm up */
+	t0 = now ();
+	for (p = 0; p < passes; p++) {
+		reset_tally ();
+		evaluate ();
+	}
+	dt = now () - t0;
+	printf ("%-6s %10.1f MB  %8.3f ms/pass  %12.0f messages/s  (fp %d, fn %d)\n",
+			name, bytes / 1048576.0, dt * 1000.0 / passes,
+			(double)num_nondup * passes / dt, ga_ny, ga_yn);
+}
+
+void usage () {
+	printf ("usage: corpus-bench [args]\n"
+			"\n"
+			"  -c corpus = corpus file written by logs-to-c\n"
+			"  -n messages = make up a corpus of this many messages instead (1000000 default)\n"
+			"  -r rules = rules in a made-up corpus (800 default)\n"
+			"  -m max_hits = hits of the worst outliers in a made-up corpus (250 default)\n"
+			"  -p passes = evaluation passes to time (20 default)\n"
+			"  -h = print this help\n"
+			"\n");
+	exit(30);
+}
+
+int main (int argc, char ** argv) {
+	const char *corpus_file = NULL;
+	static const char *kernels[] = { "scalar", "sse2", "avx2" };
+	int n = 1000000, r = 800, max_hits = 250;
+	int i, arg;
+
+	while ((arg = getopt (argc, argv, "c:n:r:m:p:h?")) != -1) {
+		switch (arg) {
+			case 'c':
+				corpus_file = optarg;
+				break;
+
+			case 'n':
+				n = atoi(optarg);
+				break;
+
+			case 'r':
+				r = atoi(optarg);
+				break;
+
+			case 'm':
+				max_hits = atoi(optarg);
+				break;
+
+			case 'p':
+				passes = atoi(optarg);
+				break;
+
+			case 'h':
+			case '?':
+				usage();
+				break;
+		}
+	}
+
+	srand48 (1);
+	if ( corpus_file ) {
+		load_corpus (corpus_file);
+	} else {
+		make_corpus (n, r, max_hits);
+	}
+	make_dense ();
+
+	lookup = malloc (num_mutable * sizeof(double));
+	for (i = 0; i < num_mutable; i++) {
+		lookup[i] = drand48() * 3.0 - 0.5;
+	}
+
+	printf ("%d messages, %u hits, %d hits in the worst one\n",
+			num_nondup, hit_start[num_nondup], max_hits_per_msg - 1);
+	run ("dense", evaluate_dense, (size_t)num_nondup * (1 + max_hits_per_msg
+				* sizeof(unsigned short)));
+	run ("csr", evaluate_csr, (num_nondup + 1) * sizeof(unsigned int)
+			+ hit_start[num_nondup] * sizeof(unsigned short));
+
+	for (i = 0; i < (int)(sizeof(kernels) / sizeof(kernels[0])); i++) {
+		if ( select_score_kernel (kernels[i]) == NULL ) {
+			printf ("%-6s not supported here\n", kernels[i]);
+			continue;
+		}
+		check_kernel (kernels[i]);
+		run (kernels[i], evaluate_kernel, (num_nondup + 1) * sizeof(unsigned int)
+				+ hit_start[num_nondup] * sizeof(unsigned short));
+	}
+	return 0;
+}
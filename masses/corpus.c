@@ -0,0 +1,162 @@
+/* Loads the binary corpus file written by logs-to-c.  See corpus.h for the
+ * layout.
+ *
+ * <@LICENSE>
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to you under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * </@LICENSE>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "corpus.h"
+
+int num_tests, num_nondup, num_spam, num_ham;
+int num_scores, num_mutable;
+
+unsigned char *is_spam;
+int *tests_count;
+double *scores;
+unsigned int *hit_start;
+unsigned short *hit_index;
+
+unsigned char *is_mutable;
+double *range_lo, *range_hi;
+double *bestscores;
+char **score_names;
+
+static const char *corpus_path;
+
+static void corpus_error (const char *msg) {
+	fprintf (stderr, "%s: %s\n", corpus_path, msg);
+	exit (1);
+}
+
+/* Returns a pointer to the section at offset, after checking that its
+ * count elements of the given size lie within the file. */
+static void * section (char *base, const struct corpus_header *hdr,
+		uint64_t offset, uint64_t count, size_t size) {
+	if ( offset % 8 != 0 || offset < sizeof(*hdr) || offset > hdr->file_size
+			|| count > (hdr->file_size - offset) / size ) {
+		corpus_error ("corrupt file, section out of bounds");
+	}
+	return base + offset;
+}
+
+void load_corpus (const char *path) {
+	struct corpus_header *hdr;
+	struct stat st;
+	char *base, *names;
+	uint32_t *name_start;
+	uint64_t h;
+	uint64_t names_len;
+	int fd, i;
+
+	corpus_path = path;
+
+	if ( (fd = open (path, O_RDONLY)) < 0 || fstat (fd, &st) < 0 ) {
+		corpus_error (strerror (errno));
+	}
+	if ( (size_t)st.st_size < sizeof(*hdr) ) {
+		corpus_error ("not a corpus file (too short)");
+	}
+
+	/* private and writable, so that the optimizers can adjust ranges and
+	 * scores in place without touching the file */
+	base = mmap (NULL, st.st_size, PROT_READ|PROT_WRITE, MAP_PRIVATE, fd, 0);
+	if ( base == MAP_FAILED ) {
+		corpus_error (strerror (errno));
+	}
+	close (fd);
+
+	hdr = (struct corpus_header *)base;
+	if ( memcmp (hdr->magic, CORPUS_MAGIC, sizeof(hdr->magic)) != 0 ) {
+		corpus_error ("not a corpus file (bad magic), run logs-to-c");
+	}
+	if ( hdr->byte_order != CORPUS_BYTE_ORDER ) {
+		corpus_error ("written on a machine with another byte order, run logs-to-c here");
+	}
+	if ( hdr->version != CORPUS_VERSION ) {
+		fprintf (stderr, "%s: format version %u, expected %u, run logs-to-c\n",
+				path, hdr->version, CORPUS_VERSION);
+		exit (1);
+	}
+	if ( hdr->file_size != (uint64_t)st.st_size ) {
+		corpus_error ("truncated file");
+	}
+	if ( hdr->num_mutable > hdr->num_scores || hdr->num_scores > 65536
+			|| hdr->num_nondup > hdr->num_tests
+			|| hdr->num_tests > 0x7fffffff ) {
+		corpus_error ("corrupt file, bad counts");
+	}
+
+	num_tests = hdr->num_tests;
+	num_nondup = hdr->num_nondup;
+	num_spam = hdr->num_spam;
+	num_ham = hdr->num_ham;
+	num_scores = hdr->num_scores;
+	num_mutable = hdr->num_mutable;
+
+	hit_start = section (base, hdr, hdr->hit_start, num_nondup + 1, sizeof(uint32_t));
+	is_spam = section (base, hdr, hdr->is_spam, num_nondup, sizeof(uint8_t));
+	tests_count = section (base, hdr, hdr->tests_count, num_nondup, sizeof(int32_t));
+	scores = section (base, hdr, hdr->base_score, num_nondup, sizeof(double));
+	is_mutable = section (base, hdr, hdr->is_mutable, num_scores, sizeof(uint8_t));
+	range_lo = section (base, hdr, hdr->range_lo, num_scores, sizeof(double));
+	range_hi = section (base, hdr, hdr->range_hi, num_scores, sizeof(double));
+	bestscores = section (base, hdr, hdr->bestscores, num_scores, sizeof(double));
+	name_start = section (base, hdr, hdr->name_start, num_scores + 1, sizeof(uint32_t));
+
+	hit_index = section (base, hdr, hdr->hit_index, hdr->num_hits, sizeof(uint16_t));
+	if ( hit_start[0] != 0 || hit_start[num_nondup] != hdr->num_hits ) {
+		corpus_error ("corrupt file, bad hit count");
+	}
+	for (i = 0; i < num_nondup; i++) {
+		if ( hit_start[i] > hit_start[i+1] ) {
+			corpus_error ("corrupt file, bad hit offsets");
+		}
+	}
+	for (h = 0; h < hdr->num_hits; h++) {
+		if ( hit_index[h] >= num_mutable ) {
+			corpus_error ("corrupt file, hit on an immutable rule");
+		}
+	}
+
+	names_len = hdr->file_size - hdr->names;
+	names = section (base, hdr, hdr->names, names_len, 1);
+	score_names = (char **)calloc (num_scores, sizeof(char *));
+	if ( num_scores && !score_names ) {
+		corpus_error ("out of memory");
+	}
+	for (i = 0; i < num_scores; i++) {
+		if ( name_start[i] >= names_len
+				|| memchr (names + name_start[i], '\0',
+					names_len - name_start[i]) == NULL ) {
+			corpus_error ("corrupt file, bad rule name");
+		}
+		score_names[i] = names + name_start[i];
+	}
+
+	printf ("Read test results for %d messages (%d total).\n", num_nondup,
+			num_tests);
+	printf ("Read scores for %d tests.\n", num_scores);
+}
@@ -0,0 +1,93 @@
+/* Binary corpus file, written by logs-to-c and loaded at run time by the
+ * score optimizers (perceptron, garescorer).
+ *
+ * <@LICENSE>
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to you under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * </@LICENSE>
+ */
+
+#ifndef CORPUS_H
+#define CORPUS_H
+
+#include <stdint.h>
+
+#define CORPUS_FILE		"tmp/corpus.bin"
+#define CORPUS_MAGIC		"SACORPUS"
+#define CORPUS_VERSION		1
+#define CORPUS_BYTE_ORDER	0x01020304
+
+/* The file is this header followed by the sections it points to, each one
+ * starting on an 8-byte boundary, so that the whole file can be mapped and
+ * used in place.  Numbers are in the byte order of the machine which wrote
+ * the file (byte_order tells if it is ours).
+ *
+ * Messages with the same label and the same rule hits are stored once
+ * (num_nondup of them), with tests_count telling how many there were.  The
+ * hits of message i are hit_index[hit_start[i] .. hit_start[i+1]-1]; only
+ * mutable rules are listed there, the scores of the immutable rules a
+ * message hit are summed up in its base score.  Rules are numbered so that
+ * the mutable ones come first (0 .. num_mutable-1). */
+struct corpus_header {
+	char magic[8];
+	uint32_t version;
+	uint32_t byte_order;
+	uint32_t num_tests;	/* messages in the logs */
+	uint32_t num_nondup;	/* distinct messages in the file */
+	uint32_t num_spam;
+	uint32_t num_ham;
+	uint32_t num_scores;	/* rules */
+	uint32_t num_mutable;
+	uint64_t num_hits;	/* length of hit_index */
+	uint64_t file_size;
+
+	/* offsets of the sections from the start of the file */
+	uint64_t hit_start;	/* uint32_t[num_nondup+1] */
+	uint64_t hit_index;	/* uint16_t[num_hits] */
+	uint64_t is_spam;	/* uint8_t[num_nondup] */
+	uint64_t tests_count;	/* int32_t[num_nondup] */
+	uint64_t base_score;	/* double[num_nondup] */
+	uint64_t is_mutable;	/* uint8_t[num_scores] */
+	uint64_t range_lo;	/* double[num_scores] */
+	uint64_t range_hi;	/* double[num_scores] */
+	uint64_t bestscores;	/* double[num_scores] */
+	uint64_t name_start;	/* uint32_t[num_scores+1], into names */
+	uint64_t names;		/* NUL-terminated rule names */
+};
+
+/* Set up by load_corpus().  The arrays point into a private mapping of the
+ * file: they can be modified, and the changes stay in this process. */
+extern int num_tests, num_nondup, num_spam, num_ham;
+extern int num_scores, num_mutable;
+
+extern unsigned char *is_spam;
+extern int *tests_count;
+extern double *scores;		/* base score of each message */
+extern unsigned int *hit_start;	/* hits of msg: hit_index[hit_start[msg] .. */
+extern unsigned short *hit_index;	/* .. hit_start[msg+1]-1] */
+
+extern unsigned char *is_mutable;
+extern double *range_lo, *range_hi;
+extern double *bestscores;
+extern char **score_names;
+
+/* number of (mutable) rules message msg hit */
+#define num_tests_hit(msg)	(hit_start[(msg)+1] - hit_start[(msg)])
+
+/* Maps the corpus file at path and sets up the variables above.  Prints an
+ * error and exits if the file cannot be used. */
+void load_corpus (const char *path);
+
+#endif /* CORPUS_H */
@@ -25,6 +25,9 @@
 #include <time.h>
 #include <unistd.h>
 #include <strings.h>
+#include <stdint.h>
+#include <math.h>
+#include <pthread.h>
 
 /* GAUL: Genetic Algorithm Utility Library.  http://gaul.sourceforge.net/ */
 #include <gaul.h>
@@ -53,6 +56,8 @@ int max_generations = 10000;
 double crossover_prob = 1.0;
 /* The probability of one boolean allele being switched. */
 double mutation_prob = 0.1;
+/* The number of threads evaluating an individual. */
+int num_threads = 1;
 
 int num_rules;		/* The number of rules being optimized. */
 int max_hits;		/* The maximal number of hits in a unique pattern. */
@@ -71,6 +76,20 @@ int * class_data;	/* The class that each pattern belongs to (ham, spam). */
 #define max(x,y) ((x)>(y)?(x):(y))
 #define min(x,y) ((x)<(y)?(x):(y))
 
+/* The chromosome of the individual being evaluated, as a bitset over the
+ * rules, 64 rules to a word. */
+int num_words;
+uint64_t * chromosome_bits;
+
+/* The terms of the fitness function, by number of hits:
+ * min(num_hits, maximum_relevant_hits)^hits_exponent and
+ * -num_hits^penalty_exponent, so that pow() is not called for every
+ * pattern. */
+double * hits_term;
+double * penalty_term;
+
+#define popcount(x) __builtin_popcountll(x)
+
 /* Loads the compressed matrix into memory.  */
 void load_patterns () {
 	FILE * pfile;
@@ -105,6 +124,192 @@ void load_patterns () {
 				fprintf (stderr, "%s truncated (entry %d)\n", hits_file, p);
 				exit(1);
 			}
+			if (pattern(p,i) < 0 || pattern(p,i) >= num_rules) {
+				fprintf (stderr, "%s: bad rule number %d (entry %d)\n", hits_file, pattern(p,i), p);
+				exit(1);
+			}
+		}
+	}
+	fclose (pfile);
+}
+
+/* Fills in hits_term and penalty_term. */
+void make_fitness_tables () {
+	int h;
+
+	assert(hits_term = (double*)malloc(sizeof(double) * (max_hits + 1)));
+	assert(penalty_term = (double*)malloc(sizeof(double) * (max_hits + 1)));
+	for (h = 0; h <= max_hits; h++) {
+		hits_term[h] = pow(min(h,maximum_relevant_hits),hits_exponent);
+		penalty_term[h] = -pow(h,penalty_exponent);
+	}
+}
+
+/* Packs a chromosome into chromosome_bits. */
+static void pack_chromosome (const boolean * chromosome) {
+	int i;
+
+	bzero (chromosome_bits, sizeof(uint64_t) * num_words);
+	for (i = 0; i < num_rules; i++) {
+		if (chromosome[i]) {
+			chromosome_bits[i / 64] |= (uint64_t)1 << (i % 64);
+		}
+	}
+}
+
+/* The patterns are split into slices, one for each thread evaluating an
+ * individual.  A slice has an index of the patterns each rule hits, so
+ * that only the patterns hit by the (few) rules of the chromosome are
+ * looked at.  The number of hits of those is counted up in pattern_hits,
+ * with a bit set for each one in pattern_touched; going through the set
+ * bits a word at a time visits them in order, as the plain loop over all
+ * the patterns does.  Slices start on a multiple of 64 patterns, so that
+ * threads do not share words of pattern_touched. */
+struct pattern_slice {
+	int first, last;	/* patterns first .. last-1 */
+	int * rule_start;	/* the patterns of this slice rule r hits are */
+	int * rule_patterns;	/* rule_patterns[rule_start[r] .. rule_start[r+1]-1] */
+	double fitness;		/* over this slice, of the last individual */
+	pthread_t thread;
+};
+
+struct pattern_slice * slices;
+unsigned short * pattern_hits;
+uint64_t * pattern_touched;
+
+/* Builds the rule index of a slice.  A rule hitting a pattern more than
+ * once is listed that many times, and counts that many hits. */
+static void index_slice (struct pattern_slice * slice) {
+	int i, j, r, n = 0;
+
+	assert(slice->rule_start = (int*)calloc(num_rules + 1, sizeof(int)));
+	for (i = slice->first; i < slice->last; i++) {
+		for (j = 0; j < pattern_size(i); j++) {
+			slice->rule_start[pattern(i,j) + 1]++;
+			n++;
+		}
+	}
+	for (r = 0; r < num_rules; r++) {
+		slice->rule_start[r + 1] += slice->rule_start[r];
+	}
+
+	assert(slice->rule_patterns = (int*)malloc(sizeof(int) * max(n, 1)));
+	for (i = slice->first; i < slice->last; i++) {
+		for (j = 0; j < pattern_size(i); j++) {
+			slice->rule_patterns[slice->rule_start[pattern(i,j)]++] = i;
+		}
+	}
+	/* the fill moved each start to the next rule's one */
+	for (r = num_rules; r > 0; r--) {
+		slice->rule_start[r] = slice->rule_start[r - 1];
+	}
+	slice->rule_start[0] = 0;
+}
+
+/* Counts up the hits of the rules in chromosome_bits on the patterns of a
+ * slice, and marks the patterns hit. */
+static void count_hits (const struct pattern_slice * slice) {
+	int w, k;
+
+	for (w = 0; w < num_words; w++) {
+		uint64_t bits = chromosome_bits[w];
+
+		while (bits) {
+			int r = w * 64 + __builtin_ctzll(bits);
+
+			bits &= bits - 1;
+			for (k = slice->rule_start[r]; k < slice->rule_start[r + 1]; k++) {
+				int p = slice->rule_patterns[k];
+
+				pattern_hits[p]++;
+				pattern_touched[p / 64] |= (uint64_t)1 << (p % 64);
+			}
+		}
+	}
+}
+
+/* The fitness term of pattern i. */
+#define pattern_fitness(i,num_hits) \
+	(hits_term[num_hits] * pattern_count(i) * (class(i) ? 1 : penalty_term[num_hits]))
+
+/* Works out the sum of the fitness function over the patterns of a slice,
+ * as described above pattern_score(), and clears the counts again. */
+static void slice_fitness (struct pattern_slice * slice) {
+	int w, i;
+
+	count_hits (slice);
+
+	slice->fitness = 0;
+	if ( hits_term[0] != 0 ) {
+		/* with hits_exponent 0 patterns nothing hit count as well */
+		for (i = slice->first; i < slice->last; i++) {
+			slice->fitness += pattern_fitness(i, pattern_hits[i]);
+			pattern_hits[i] = 0;
+		}
+		for (w = slice->first / 64; w * 64 < slice->last; w++) {
+			pattern_touched[w] = 0;
+		}
+		return;
+	}
+
+	for (w = slice->first / 64; w * 64 < slice->last; w++) {
+		uint64_t bits = pattern_touched[w];
+
+		pattern_touched[w] = 0;
+		while (bits) {
+			i = w * 64 + __builtin_ctzll(bits);
+			bits &= bits - 1;
+			slice->fitness += pattern_fitness(i, pattern_hits[i]);
+			pattern_hits[i] = 0;
+		}
+	}
+}
+
+/* With more than one thread, each pattern_score() call has all of them
+ * work on a slice; the other threads wait for work at a barrier. */
+pthread_barrier_t evaluation_start, evaluation_done;
+
+static void * evaluation_thread_run (void * arg) {
+	struct pattern_slice * slice = arg;
+
+	for (;;) {
+		pthread_barrier_wait (&evaluation_start);
+		slice_fitness (slice);
+		pthread_barrier_wait (&evaluation_done);
+	}
+	return NULL;
+}
+
+/* Sets up the slices and starts the threads. */
+void init_evaluation () {
+	int i;
+
+	num_words = (num_rules + 63) / 64;
+	assert(chromosome_bits = (uint64_t*)calloc(max(num_words, 1), sizeof(uint64_t)));
+	assert(pattern_hits = (unsigned short*)calloc(max(num_patterns, 1), sizeof(unsigned short)));
+	assert(pattern_touched = (uint64_t*)calloc(num_patterns / 64 + 1, sizeof(uint64_t)));
+	assert(max_hits < 65536);
+
+	assert(slices = (struct pattern_slice*)calloc(num_threads, sizeof(struct pattern_slice)));
+	for (i = 0; i < num_threads; i++) {
+		slices[i].first = (long)num_patterns * i / num_threads / 64 * 64;
+		slices[i].last = (long)num_patterns * (i + 1) / num_threads / 64 * 64;
+	}
+	slices[num_threads - 1].last = num_patterns;
+	for (i = 0; i < num_threads; i++) {
+		index_slice (&slices[i]);
+	}
+
+	if ( num_threads == 1 ) {
+		return;
+	}
+	pthread_barrier_init (&evaluation_start, NULL, num_threads);
+	pthread_barrier_init (&evaluation_done, NULL, num_threads);
+	for (i = 1; i < num_threads; i++) {
+		if ( pthread_create (&slices[i].thread, NULL,
+					evaluation_thread_run, &slices[i]) ) {
+			perror ("pthread_create");
+			exit (1);
 		}
 	}
 }
@@ -116,17 +321,17 @@ void load_patterns () {
  * / exp(abs(target_num_rules - num_rules_present) * log(2) / target_flex_rules)
  * */
 static boolean pattern_score(population *pop, entity *entity) {
-	int i, j, num_hits, num_rules_present;
+	int i, num_rules_present;
 
 	entity->fitness = 0;
 
+	pack_chromosome ((boolean*)entity->chromosome[0]);
+
 	/* Count up the number of rules present in this individual's
 	 * chromosome. */
 	num_rules_present = 0;
-	for (i = 0; i < num_rules; i++) {
-		if (((boolean*)entity->chromosome[0])[i]) {
-			num_rules_present++;
-		}
+	for (i = 0; i < num_words; i++) {
+		num_rules_present += popcount(chromosome_bits[i]);
 	}
 
 	/* An individual with no rules present in its chromosome has 0 fitness,
@@ -136,19 +341,15 @@ static boolean pattern_score(population *pop, entity *entity) {
 	}
 
 	/* Compute the fitness function as described above. */
-	for (i = 0; i < num_patterns; i++) {
-		num_hits = 0;
-		/* This counts how many rules in the chromosome also hit the
-		 * pattern */
-		for (j = 0; j < pattern_size(i); j++) {
-			if (((boolean*)entity->chromosome[0])[pattern(i,j)]) {
-				num_hits++;
-			}
-		}
-		
-		/* See above for a description of what this does and why it
-		 * does it. */
-		entity->fitness += pow(min(num_hits,maximum_relevant_hits),hits_exponent) * pattern_count(i) * (class(i) ? 1 : -pow(num_hits,penalty_exponent));
+	if ( num_threads == 1 ) {
+		slice_fitness (&slices[0]);
+	} else {
+		pthread_barrier_wait (&evaluation_start);
+		slice_fitness (&slices[0]);
+		pthread_barrier_wait (&evaluation_done);
+	}
+	for (i = 0; i < num_threads; i++) {
+		entity->fitness += slices[i].fitness;
 	}
 	
 	/* This divisor is bound to 1, to prevent overflow.  exp(0) is undefined
@@ -198,18 +399,14 @@ void print_entity (entity * entity) {
 	bzero (histogram, sizeof(histogram));
 
 	/* Compute the histogram by scanning through the training data. */
+	pack_chromosome ((boolean*)entity->chromosome[0]);
+	for (i = 0; i < num_threads; i++) {
+		count_hits (&slices[i]);
+	}
 	for (i = 0; i < num_patterns; i++) {
 		int j;
 
-		num_hits = 0;
-		for (j = 0; j < pattern_size(i); j++) {
-			if (((boolean*)entity->chromosome[0])[pattern(i,j)]) {
-				num_hits++;
-				if ( num_hits == maximum_relevant_hits ) {
-					break;
-				}
-			}
-		}
+		num_hits = min(pattern_hits[i], maximum_relevant_hits);
 		for (j = 0; j <= num_hits; j++) {
 			histogram[class(i)][j] += pattern_count(i);
 		}
@@ -249,6 +446,7 @@ void usage () {
 			"  -g max_generations\n"
 			"  -x crossover_prob\n"
 			"  -u mutation_prob\n"
+			"  -j num_threads\n"
 			"\n  -? = print this help\n"
 			"\n");
 
@@ -259,7 +457,7 @@ int main (int argc, char ** argv) {
 	population *pop = 0;
 	char arg;
 
-	while ((arg = getopt (argc, argv, "h:r:m:t:l:e:p:s:g:x:u:?")) != -1) {
+	while ((arg = getopt (argc, argv, "h:r:m:t:l:e:p:s:g:x:u:j:?")) != -1) {
 		switch (arg) {
 			case 'h':
 				hits_file = optarg;
@@ -294,12 +492,20 @@ int main (int argc, char ** argv) {
 			case 'u':
 				mutation_prob = atof(optarg);
 				break;
+			case 'j':
+				num_threads = atoi(optarg);
+				if ( num_threads < 1 ) {
+					usage ();
+				}
+				break;
 			case '?':
 				usage ();
 		}
 	}
 
 	load_patterns();
+	make_fitness_tables();
+	init_evaluation();
 
 	random_init();
 	random_seed(time(0));
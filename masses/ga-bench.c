@@ -0,0 +1,283 @@
+/* Measures how long PGAPack takes over a generation of a GA shaped like
+ * garescorer's: a population of real strings, one allele per rule, most of
+ * it replaced each generation, with an evaluation function which reads
+ * every allele through PGAGetRealAllele().  The evaluation is kept cheap,
+ * so that what is timed is PGAPack itself.  Built twice by the Makefile:
+ * ga-bench with -DOPTIMIZE against the release library, where the
+ * accessors are macros and the debug tracing and checks are compiled out,
+ * and ga-bench-debug against the debug library, where they are not.
+ * With -p, times instead the parts of a generation which grow with the
+ * population, ranking and sorting it, over populations of 100 to 100000.
+ *
+ * <@LICENSE>
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to you under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * </@LICENSE>
+ */
+
+#include "pgapack.h"
+
+#include <unistd.h>
+#include <sys/time.h>
+
+int pop_size = 50;
+int replace_num = 33;
+int num_rules = 800;
+int generations = 2000;
+int no_duplicates = 0;
+int contiguous = 0;
+int sweep = 0;
+
+/* the population sizes -p times, and the strings it uses for them, kept
+ * short so that sorting rather than evaluating is what grows */
+static const int sweep_sizes[] = { 100, 1000, 10000, 100000 };
+#define SWEEP_RULES 8
+
+/* the scores the GA is to find */
+double *target;
+
+/* how far string p is from the target, read allele by allele as
+ * garescorer's evaluation does */
+double evaluate (PGAContext *ctx, int p, int pop) {
+	double dist = 0.0;
+	int i;
+
+	for (i = 0; i < num_rules; i++) {
+		double d = PGAGetRealAllele (ctx, p, pop, i) - target[i];
+
+		dist += d * d;
+	}
+	return dist;
+}
+
+/* the same, through a pointer to the string's alleles */
+double evaluate_row (PGAContext *ctx, int p, int pop) {
+	PGAReal *row = PGAGetRealRow (ctx, p, pop);
+	double dist = 0.0;
+	int i;
+
+	for (i = 0; i < num_rules; i++) {
+		double d = row[i] - target[i];
+
+		dist += d * d;
+	}
+	return dist;
+}
+
+static double now () {
+	struct timeval tv;
+
+	gettimeofday (&tv, 0);
+	return tv.tv_sec + tv.tv_usec * 1.0e-6;
+}
+
+void usage () {
+	printf ("usage: ga-bench [args]\n"
+			"\n"
+			"  -s size = population size (50 default)\n"
+			"  -r replace = individuals replaced each generation (33 default)\n"
+			"  -n rules = alleles in a string (800 default)\n"
+			"  -g generations = generations to time (2000 default)\n"
+			"  -d = do not allow duplicate strings\n"
+			"  -c = keep each population in one block, evaluate through\n"
+			"       row pointers\n"
+			"  -p = time ranking, sorting and a generation for populations\n"
+			"       of 100 to 100000 strings of %d alleles, replacing the\n"
+			"       same share of each as -s and -r do\n"
+			"  -h = print this help\n"
+			"\n", SWEEP_RULES);
+	exit(30);
+}
+
+/* how many times to repeat something done once per generation to a
+ * population of size strings, so that each size takes about as long */
+static int sweep_reps (int size) {
+	return size < 1000000 / 3 ? 1000000 / size : 3;
+}
+
+/* times PGAFitness() ranking the population, PGASortPop() sorting it,
+ * and whole generations, for each of sweep_sizes */
+void bench_pop_sizes (int *argc, char **argv) {
+	PGAContext *ctx;
+	double t, t_rank, t_sort, t_gen;
+	int s, size, reps, r;
+
+	printf ("%s: strings of %d alleles, %d%% replaced each generation\n",
+#if OPTIMIZE
+			"release",
+#else
+			"debug",
+#endif
+			num_rules, 100 * replace_num / pop_size);
+	printf ("%10s %14s %14s %16s\n",
+			"size", "rank (ms)", "sort (ms)", "generation (ms)");
+	for (s = 0; s < sizeof(sweep_sizes) / sizeof(sweep_sizes[0]); s++) {
+		size = sweep_sizes[s];
+		reps = sweep_reps (size);
+
+		ctx = PGACreate (argc, argv, PGA_DATATYPE_REAL, num_rules,
+				PGA_MINIMIZE);
+		PGASetRandomSeed (ctx, 1);
+		PGASetPopSize (ctx, size);
+		PGASetNumReplaceValue (ctx,
+				(int) ((double) size * replace_num / pop_size));
+		PGASetPopReplaceType (ctx, PGA_POPREPL_BEST);
+		PGASetFitnessType (ctx, PGA_FITNESS_RANKING);
+		PGASetMutationType (ctx, PGA_MUTATION_GAUSSIAN);
+		PGASetMutationProb (ctx, 1.0 / num_rules);
+		PGASetUp (ctx);
+
+		PGAEvaluate (ctx, PGA_OLDPOP, evaluate, NULL);
+
+		t = now ();
+		for (r = 0; r < reps; r++) {
+			PGAFitness (ctx, PGA_OLDPOP);
+		}
+		t_rank = (now () - t) / reps;
+
+		t = now ();
+		for (r = 0; r < reps; r++) {
+			PGASortPop (ctx, PGA_OLDPOP);
+		}
+		t_sort = (now () - t) / reps;
+
+		t = now ();
+		for (r = 0; r < reps; r++) {
+			PGASelect (ctx, PGA_OLDPOP);
+			PGARunMutationAndCrossover (ctx, PGA_OLDPOP, PGA_NEWPOP);
+			PGAEvaluate (ctx, PGA_NEWPOP, evaluate, NULL);
+			PGAFitness (ctx, PGA_NEWPOP);
+			PGAUpdateGeneration (ctx, NULL);
+		}
+		t_gen = (now () - t) / reps;
+
+		printf ("%10d %14.4f %14.4f %16.4f\n", size,
+				t_rank * 1000.0, t_sort * 1000.0, t_gen * 1000.0);
+		PGADestroy (ctx);
+	}
+}
+
+int main (int argc, char **argv) {
+	void (*create_new_generation)(PGAContext *, int, int);
+	double (*eval)(PGAContext *, int, int) = evaluate;
+	PGAContext *ctx;
+	double t0, t_eval = 0.0, t_total, t;
+	int g, i, best, arg;
+
+	while ((arg = getopt (argc, argv, "s:r:n:g:dcph?")) != -1) {
+		switch (arg) {
+			case 's':
+				pop_size = atoi(optarg);
+				break;
+
+			case 'r':
+				replace_num = atoi(optarg);
+				break;
+
+			case 'n':
+				num_rules = atoi(optarg);
+				break;
+
+			case 'g':
+				generations = atoi(optarg);
+				break;
+
+			case 'd':
+				no_duplicates = 1;
+				break;
+
+			case 'c':
+				contiguous = 1;
+				break;
+
+			case 'p':
+				sweep = 1;
+				num_rules = SWEEP_RULES;
+				break;
+
+			case 'h':
+			case '?':
+				usage();
+				break;
+		}
+	}
+
+	target = malloc (num_rules * sizeof(double));
+	if ( !target ) {
+		fprintf (stderr, "No room for the target\n");
+		exit (1);
+	}
+	srand48 (1);
+	for (i = 0; i < num_rules; i++) {
+		target[i] = drand48() * 8.0 - 3.0;
+	}
+
+	if ( sweep ) {
+		bench_pop_sizes (&argc, argv);
+		return 0;
+	}
+
+	ctx = PGACreate (&argc, argv, PGA_DATATYPE_REAL, num_rules, PGA_MINIMIZE);
+	PGASetRandomSeed (ctx, 1);
+	PGASetPopSize (ctx, pop_size);
+	PGASetNumReplaceValue (ctx, replace_num);
+	PGASetPopReplaceType (ctx, PGA_POPREPL_BEST);
+	PGASetMutationType (ctx, PGA_MUTATION_GAUSSIAN);
+	PGASetMutationProb (ctx, 1.0 / num_rules);
+	if ( no_duplicates ) {
+		PGASetNoDuplicatesFlag (ctx, PGA_TRUE);
+	}
+	if ( contiguous ) {
+		PGASetContiguousPopFlag (ctx, PGA_TRUE);
+		eval = evaluate_row;
+	}
+	PGASetUp (ctx);
+
+	if ( PGAGetMutationOrCrossoverFlag (ctx) ) {
+		create_new_generation = PGARunMutationOrCrossover;
+	} else {
+		create_new_generation = PGARunMutationAndCrossover;
+	}
+
+	PGAEvaluate (ctx, PGA_OLDPOP, eval, NULL);
+	PGAFitness (ctx, PGA_OLDPOP);
+
+	t0 = now ();
+	for (g = 0; g < generations; g++) {
+		PGASelect (ctx, PGA_OLDPOP);
+		create_new_generation (ctx, PGA_OLDPOP, PGA_NEWPOP);
+		t = now ();
+		PGAEvaluate (ctx, PGA_NEWPOP, eval, NULL);
+		t_eval += now () - t;
+		PGAFitness (ctx, PGA_NEWPOP);
+		PGAUpdateGeneration (ctx, NULL);
+	}
+	t_total = now () - t0;
+
+	best = PGAGetBestIndex (ctx, PGA_OLDPOP);
+	printf ("%s: %d generations of %d strings of %d alleles\n",
+#if OPTIMIZE
+			"release",
+#else
+			"debug",
+#endif
+			generations, pop_size, num_rules);
+	printf ("%8.3f ms/generation, %8.3f ms of it evaluating  (best %.6g)\n",
+			t_total * 1000.0 / generations, t_eval * 1000.0 / generations,
+			PGAGetEvaluation (ctx, best, PGA_OLDPOP));
+
+	PGADestroy (ctx);
+	return 0;
+}
@@ -12,10 +12,8 @@
 #include <unistd.h>
 #include <sys/time.h>
 #include <math.h>
-#include "tmp/scores.h"
-#include "tmp/tests.h"
-
-extern int num_spam, num_ham;	/* in tmp/tests.h */
+#include "corpus.h"
+#include "score-kernel.h"
 
 
 /* Use score ranges derived from hit-frequencies S/O ratio,
@@ -29,7 +27,40 @@ extern int num_spam, num_ham;	/* in tmp/tests.h */
 /* inheritance of acquired characters / soft inheritance / Lamarckism */
 #define LAMARCK
 
+/* Tallies and scratch space of an evaluation of an individual, so that
+ * several individuals can be evaluated at once. */
+struct evaluation {
+  int ga_yy,ga_yn,ga_ny,ga_nn;
+  double ynscore,nyscore,yyscore,nnscore;
+  double *lookup;		/* alleles of the individual, by rule */
+#ifdef LAMARCK
+  unsigned char *ny_hit;	/* rules hit by a false positive */
+  unsigned char *yn_hit;	/* rules hit by a false negative */
+  int weight_balance;
+#endif
+
+  /* The scores of every message under the last individual evaluated
+   * (mostly the parent of the next one), so that evaluating an individual
+   * which differs from it in a few alleles only rescores the messages
+   * which hit the rules changed.  See evaluate_individual(). */
+  struct {
+    int valid;
+    double *alleles;		/* what msg_score was computed with */
+    double *msg_score;
+    int ga_yy,ga_yn,ga_ny,ga_nn;
+    long long ynscore,nyscore,yyscore,nnscore;	/* in SCORE_UNITs */
+    int *yn_count;		/* false negatives hitting each rule */
+    int *ny_count;		/* false positives hitting each rule */
+    int *changed;		/* scratch: rules changed */
+    unsigned int *dirty;	/* scratch: messages to rescore */
+    unsigned char *is_dirty;
+  } cache;
+};
+
+void init_evaluation(struct evaluation *);
+void init_rule_index();
 double evaluate(PGAContext *, int, int);
+double evaluate_individual(struct evaluation *, PGAContext *, int, int);
 int    GetIntegerParameter(char *query);
 void dump(FILE *);
 void WriteString(PGAContext *ctx, FILE *fp, int p, int pop);
@@ -54,7 +85,7 @@ void dump(FILE *);
 void WriteString(PGAContext *ctx, FILE *fp, int p, int pop);
 void showSummary(PGAContext *ctx);
 
-double evaluate_inner();
+double evaluate_inner(struct evaluation *);
 
 
 
@@ -102,6 +133,42 @@ const double crossover_rate = 0.65;
 
 int justCount = 0;
 
+const char *corpus_file = CORPUS_FILE;
+
+#ifndef USE_VARIABLE_MUTATIONS
+/* with -k, the GA's state is saved there every 100 generations, and with
+ * -R a run carries on from it.  Not with USE_VARIABLE_MUTATIONS, whose
+ * strings carry mutation noise PGAPack does not know of, and whose
+ * mutation rate is kept in globals. */
+char *checkpoint_file = NULL;
+int resume = 0;
+#define CHECKPOINT_OPTIONS "k:R"
+#else
+#define CHECKPOINT_OPTIONS ""
+#endif
+
+/* scratch space, sized by the corpus */
+double (*tmp_scores)[2];
+double *tmp_total;
+
+/* the messages hitting each rule: rule_msgs[rule_start[rule] ..
+ * rule_start[rule+1]-1], the inverse of hit_start/hit_index */
+unsigned int *rule_start;
+unsigned int *rule_msgs;
+
+/* Rescore from scratch when the messages hitting the changed rules have
+ * more than this fraction of all hits. */
+#define INCREMENTAL_MAX_FRACTION 0.25
+
+/* The cache sums up message scores in whole units of this, so that the
+ * sums come out the same whatever order messages were added and taken
+ * away in: an individual gets the same evaluation every time. */
+#define SCORE_UNIT (1.0/1048576)
+
+/* the evaluations done by the GA's own thread: PGAPack's callbacks,
+ * mutation, adaptation and the reports */
+struct evaluation main_eval;
+
 void usage()
 {
 #ifdef USE_MPI
@@ -117,6 +184,23 @@ void usage()
      "  -b nybias = bias towards false negatives (10.0 default)\n"
      "  -f fptarget = target FP percentage (alt fitness function, off by default)\n"
      "  -t threshold = threshold for spam/nonspam decision (5 default)\n"
+     "  -c corpus = corpus file written by logs-to-c (" CORPUS_FILE " default)\n"
+#ifndef USE_MPI
+     "  -j threads = evaluate this many individuals at a time (1 default)\n"
+#ifndef USE_VARIABLE_MUTATIONS
+     "  -i islands = evolve this many populations at a time, each on its\n"
+     "               own thread (1 default, overrides -j, not with -k)\n"
+     "  -m generations = migrate between islands this often (10 default)\n"
+#endif
+#endif
+#ifndef USE_VARIABLE_MUTATIONS
+     "  -k file = checkpoint the GA to file every 100 generations\n"
+     "  -R = resume from the -k checkpoint file\n"
+#else
+     "\n"
+     "  (checkpoints, -k and -R, and islands, -i and -m, need a build\n"
+     "  without USE_VARIABLE_MUTATIONS and LAMARCK; see README)\n"
+#endif
      "\n"
      "  -C = just count hits and exit, no evolution\n\n");
 #ifdef USE_MPI
@@ -127,55 +211,138 @@ void usage()
 
 void init_data()
 {
-#ifdef USE_MPI
-  int rank;
-
-  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  /* every process maps the corpus file by itself, there is no need to
+   * ship it around */
+  load_corpus(corpus_file);
+  select_score_kernel(NULL);
 
-  if (rank == 0) {
-#endif
-
-    loadtests();
-    loadscores();
-    nybias = nybias*((double)num_spam)/((double)num_ham);
+  nybias = nybias*((double)num_spam)/((double)num_ham);
 #ifdef USE_VARIABLE_MUTATIONS
-    mutation_rate_modifier = (double)pow(mutation_rate_modifier,
-					(double)1/num_mutable);
+  mutation_rate_modifier = (double)pow(mutation_rate_modifier,
+				      (double)1/num_mutable);
 #endif
 
-#ifdef USE_MPI
+  tmp_scores = calloc(num_scores, sizeof(*tmp_scores));
+  tmp_total = calloc(num_nondup, sizeof(*tmp_total));
+  if (!tmp_scores || !tmp_total) {
+    fprintf(stderr, "No room for scratch arrays\n");
+    exit(1);
   }
+  init_rule_index();
+  init_evaluation(&main_eval);
+}
 
-  MPI_Bcast(num_tests_hit, num_nondup, MPI_CHAR, 0, MPI_COMM_WORLD);
-  MPI_Bcast(&nybias, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
-  MPI_Bcast(is_spam, num_nondup, MPI_CHAR, 0, MPI_COMM_WORLD);
-  MPI_Bcast(tests_hit, num_nondup*max_hits_per_msg, MPI_SHORT, 0,
-	    MPI_COMM_WORLD);
-#ifdef USE_VARIABLE_MUTATIONS
-  MPI_Bcast(&mutation_rate_modifier, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
-#endif
-  MPI_Bcast(is_mutable, num_scores, MPI_CHAR, 0, MPI_COMM_WORLD);
-  MPI_Bcast(range_lo, num_scores, MPI_DOUBLE, 0, MPI_COMM_WORLD);
-  MPI_Bcast(range_hi, num_scores, MPI_DOUBLE, 0, MPI_COMM_WORLD);
-  MPI_Bcast(bestscores, num_scores, MPI_DOUBLE, 0, MPI_COMM_WORLD);
-  MPI_Bcast(scores, num_scores, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+void init_rule_index()
+{
+  unsigned int *fill;
+  unsigned int h;
+  int i, r;
+
+  rule_start = calloc(num_mutable + 1, sizeof(*rule_start));
+  rule_msgs = malloc((hit_start[num_nondup] + 1) * sizeof(*rule_msgs));
+  fill = calloc(num_mutable + 1, sizeof(*fill));
+  if (!rule_start || !rule_msgs || !fill) {
+    fprintf(stderr, "No room for the rule index\n");
+    exit(1);
+  }
+
+  for (h = 0; h < hit_start[num_nondup]; h++)
+    rule_start[hit_index[h] + 1]++;
+  for (r = 0; r < num_mutable; r++)
+    rule_start[r + 1] += rule_start[r];
+
+  memcpy(fill, rule_start, num_mutable * sizeof(*fill));
+  for (i = 0; i < num_nondup; i++) {
+    for (h = hit_start[i]; h < hit_start[i+1]; h++)
+      rule_msgs[fill[hit_index[h]]++] = i;
+  }
+  free(fill);
+}
+
+void init_evaluation(struct evaluation *ev)
+{
+  memset(ev, 0, sizeof(*ev));
+  ev->lookup = calloc(num_mutable, sizeof(*ev->lookup));
+#ifdef LAMARCK
+  ev->ny_hit = calloc(num_mutable, sizeof(*ev->ny_hit));
+  ev->yn_hit = calloc(num_mutable, sizeof(*ev->yn_hit));
+  if (!ev->ny_hit || !ev->yn_hit) {
+    fprintf(stderr, "No room for scratch arrays\n");
+    exit(1);
+  }
 #endif
+  ev->cache.alleles = calloc(num_mutable, sizeof(*ev->cache.alleles));
+  ev->cache.msg_score = calloc(num_nondup, sizeof(*ev->cache.msg_score));
+  ev->cache.yn_count = calloc(num_mutable, sizeof(*ev->cache.yn_count));
+  ev->cache.ny_count = calloc(num_mutable, sizeof(*ev->cache.ny_count));
+  ev->cache.changed = calloc(num_mutable, sizeof(*ev->cache.changed));
+  ev->cache.dirty = calloc(num_nondup, sizeof(*ev->cache.dirty));
+  ev->cache.is_dirty = calloc(num_nondup, sizeof(*ev->cache.is_dirty));
+  if (!ev->lookup || !ev->cache.alleles || !ev->cache.msg_score ||
+      !ev->cache.yn_count || !ev->cache.ny_count || !ev->cache.changed ||
+      !ev->cache.dirty || !ev->cache.is_dirty) {
+    fprintf(stderr, "No room for scratch arrays\n");
+    exit(1);
+  }
 }
 
 /* this is about 35% faster than calling PGAGetRealAllele() directly inside
  * score_msg(), in my tests. */
 void
-load_scores_into_lookup(PGAContext *ctx, int p, int pop)
+load_scores_into_lookup(struct evaluation *ev, PGAContext *ctx, int p, int pop)
 {
+  PGAReal *row = PGAGetRealRow(ctx, p, pop);
   int i;
   for (i = 0; i < num_mutable; i++) {
-    lookup[i] = PGAGetRealAllele(ctx, p, pop, i); 
+    ev->lookup[i] = row[i];
 #ifdef LAMARCK
-    yn_hit[i] = ny_hit[i] = 0;
+    ev->yn_hit[i] = ev->ny_hit[i] = 0;
 #endif
   }
 } 
 
+#ifndef USE_MPI
+/* With -j, PGAPack evaluates the individuals of a population on that many
+ * threads (see PGASetNumThreads()).  The GA's own thread, thread 0, goes on
+ * using main_eval, so that the reports see what it evaluated; the others
+ * each have one of these. */
+int num_threads = 1;
+struct evaluation *thread_eval;
+#define THREAD_OPTIONS "j:"
+
+void init_thread_evals(void)
+{
+  int i;
+
+  thread_eval = calloc(num_threads - 1, sizeof(*thread_eval));
+  if (!thread_eval) {
+    fprintf(stderr, "No room for the threads' scratch arrays\n");
+    exit(1);
+  }
+  for (i = 0; i < num_threads - 1; i++)
+    init_evaluation(&thread_eval[i]);
+}
+
+#ifndef USE_VARIABLE_MUTATIONS
+/* With -i, that many islands evolve populations of their own, each on a
+ * thread of its own (see PGASetNumIslands()), sending their best to the
+ * next island every -m generations.  Island n's thread evaluates with
+ * thread_eval[n-1].  Not with USE_VARIABLE_MUTATIONS, whose mutation
+ * keeps its scratch space and counters in globals. */
+int num_islands = 1;
+int migration_interval = 10;
+#define ISLAND_OPTIONS "i:m:"
+#endif
+#endif /* ! USE_MPI */
+
+/* options of what is not built in are left for getopt to reject */
+#ifndef THREAD_OPTIONS
+#define THREAD_OPTIONS ""
+#endif
+#ifndef ISLAND_OPTIONS
+#define ISLAND_OPTIONS ""
+#endif
+
 int main(int argc, char **argv) {
     PGAContext *ctx;
     int i,p;
@@ -185,7 +352,8 @@ int main(int argc, char **argv) {
     MPI_Init(&argc, &argv);
 #endif
 
-    while ((arg = getopt (argc, argv, "b:r:s:e:t:f:C")) != -1) {
+    while ((arg = getopt (argc, argv, "b:r:s:e:t:f:c:" THREAD_OPTIONS
+			  ISLAND_OPTIONS CHECKPOINT_OPTIONS "C")) != -1) {
       switch (arg) {
         case 'b':
           nybias = atof(optarg);
@@ -211,6 +379,42 @@ int main(int argc, char **argv) {
 	  replace_num = atoi(optarg);
 	  break;
 
+        case 'c':
+          corpus_file = optarg;
+          break;
+
+#ifndef USE_MPI
+        case 'j':
+          num_threads = atoi(optarg);
+          if (num_threads < 1)
+            usage();
+          break;
+
+#ifndef USE_VARIABLE_MUTATIONS
+        case 'i':
+          num_islands = atoi(optarg);
+          if (num_islands < 1)
+            usage();
+          break;
+
+        case 'm':
+          migration_interval = atoi(optarg);
+          if (migration_interval < 1)
+            usage();
+          break;
+#endif
+#endif
+
+#ifndef USE_VARIABLE_MUTATIONS
+        case 'k':
+          checkpoint_file = optarg;
+          break;
+
+        case 'R':
+          resume = 1;
+          break;
+#endif
+
         case 'C':
           justCount = 1;
           break;
@@ -290,9 +494,41 @@ int main(int argc, char **argv) {
      PGASetMaxNoChangeValue(ctx, no_change_val);
      PGASetMaxGAIterValue(ctx, maxiter);
 
+#ifndef USE_VARIABLE_MUTATIONS
+     /* with USE_VARIABLE_MUTATIONS, our CreateString() allocates the
+      * strings, and keeps mutation noise after the scores where PGAPack
+      * does not know of it.  Otherwise, PGAPack can keep each population
+      * in one block, and checkpoint it */
+     PGASetContiguousPopFlag(ctx, PGA_TRUE);
+     if (checkpoint_file && !justCount) {
+       PGASetCheckpointFile(ctx, checkpoint_file);
+       if (resume)
+         PGASetResumeFile(ctx, checkpoint_file);
+     }
+#endif
+
+#ifndef USE_MPI
+#ifndef USE_VARIABLE_MUTATIONS
+     if (num_islands > 1 && !justCount) {
+       PGASetNumIslands(ctx, num_islands);
+       PGASetMigrationInterval(ctx, migration_interval);
+       num_threads = num_islands;
+       init_thread_evals();
+     } else
+#endif
+     if (num_threads > 1 && !justCount) {
+       PGASetNumThreads(ctx, num_threads);
+       init_thread_evals();
+     }
+#endif
+
      PGASetUp(ctx);
 
 #ifndef USE_VARIABLE_MUTATIONS
+     /* PGASetUp() restored the iteration count of a -R checkpoint; only
+      * count the iterations of this run in the performance lines */
+     t0_iter = PGAGetGAIterValue(ctx);
+
      if (! justCount) {
        /* Now initialize the scores */
        for(i=0; i<num_scores; i++) {
@@ -323,13 +559,11 @@ int main(int argc, char **argv) {
      return(0);
 }
 
-int ga_yy,ga_yn,ga_ny,ga_nn;
 #ifdef USE_VARIABLE_MUTATIONS
 int num_mutated = 0;
 int var_mutated = 0;
 int iters_same_passed = 0;
 #ifdef LAMARCK
-int weight_balance;
 int adapt_times = 0;
 int adapt_crossover = 0;
 int adapt_repeat = 0;
@@ -338,22 +572,30 @@ int adapt_fp_add = 0;
 int adapt_fn_add = 0;
 #endif
 #endif
-double ynscore,nyscore,yyscore,nnscore;
 
-double score_msg(PGAContext *ctx, int p, int pop, int i)
+/* The score of message i under the alleles in lookup.  The hits are
+ * added up in the same order as score_messages() does. */
+static inline double sum_msg(const double *lookup, int i)
 {
   double msg_score = 0.0;
-  int j;
+  unsigned int h;
 
   /* For every test the message hit on */
-  for(j=num_tests_hit[i]-1; j>=0; j--)
+  for (h = hit_start[i]; h < hit_start[i+1]; h++)
   {
     /* Up the message score by the allele for this test in the genome
-     * msg_score += PGAGetRealAllele(ctx, p, pop, tests_hit[i][j]); */
-    msg_score += lookup[tests_hit[i][j]];
+     * msg_score += PGAGetRealAllele(ctx, p, pop, hit_index[h]); */
+    msg_score += lookup[hit_index[h]];
   }
 
-  msg_score += scores[i];	/* base from non-mutable */
+  return msg_score + scores[i];	/* base from non-mutable */
+}
+
+double score_msg(struct evaluation *ev, int i)
+{
+  const unsigned short *hits = hit_index + hit_start[i];
+  int j, n = num_tests_hit(i);
+  double msg_score = sum_msg(ev->lookup, i);
 
   /* Ok, now we know the score for this message.
    * Let's see how this genome did... */
@@ -363,19 +605,19 @@ double score_msg(PGAContext *ctx, int p, int pop, int i)
     if(msg_score >= threshold)
     {
       /* Good positive */
-      ga_yy += tests_count[i];
-      yyscore += msg_score*tests_count[i];
+      ev->ga_yy += tests_count[i];
+      ev->yyscore += msg_score*tests_count[i];
       /* Each true positive means yyscore += at least 5 */
     }
     else
     {
       /* False negative */
-      ga_yn += tests_count[i];
-      ynscore += msg_score*tests_count[i];
+      ev->ga_yn += tests_count[i];
+      ev->ynscore += msg_score*tests_count[i];
       /* Each false negative means that ynscore += less than 5 */
 #ifdef LAMARCK
-      for(j=num_tests_hit[i]-1; j>=0; j--)
-	yn_hit[tests_hit[i][j]] = 1;
+      for(j=n-1; j>=0; j--)
+	ev->yn_hit[hits[j]] = 1;
 #endif
     }
   }
@@ -384,19 +626,19 @@ double score_msg(PGAContext *ctx, int p, int pop, int i)
     if(msg_score >= threshold)
     {
       /* False positive */
-      ga_ny += tests_count[i];
-      nyscore += msg_score*tests_count[i];
+      ev->ga_ny += tests_count[i];
+      ev->nyscore += msg_score*tests_count[i];
       /* Each false positive means nyscore += more than 5 */
 #ifdef LAMARCK
-      for(j=num_tests_hit[i]-1; j>=0; j--)
-	ny_hit[tests_hit[i][j]] = 1;
+      for(j=n-1; j>=0; j--)
+	ev->ny_hit[hits[j]] = 1;
 #endif
     }
     else
     {
       /* Good negative */
-      ga_nn += tests_count[i];
-      nnscore += msg_score*tests_count[i];
+      ev->ga_nn += tests_count[i];
+      ev->nnscore += msg_score*tests_count[i];
       /* Each good negative means nnscore += less than 5 */
     }
   }
@@ -406,51 +648,190 @@ double score_msg(PGAContext *ctx, int p, int pop, int i)
 
 double evaluate(PGAContext *ctx, int p, int pop)
 {
-  double tot_score = 0.0;
+#ifndef USE_MPI
+  int t = PGAGetThreadIndex(ctx);
+
+  if (t > 0)
+    return evaluate_individual(&thread_eval[t-1], ctx, p, pop);
+#endif
+  return evaluate_individual(&main_eval, ctx, p, pop);
+}
+
+/* Adds (sign 1) or takes away (sign -1) message i, scoring msg_score, to
+ * or from the tallies of the cache. */
+static void cache_tally(struct evaluation *ev, int i, double msg_score,
+			int sign)
+{
+  int count = sign*tests_count[i];
+  long long total = sign*llrint(msg_score*tests_count[i]/SCORE_UNIT);
+  int j;
+
+  if (is_spam[i]) {
+    if (msg_score >= threshold) {
+      ev->cache.ga_yy += count;
+      ev->cache.yyscore += total;
+    } else {
+      ev->cache.ga_yn += count;
+      ev->cache.ynscore += total;
+#ifdef LAMARCK
+      for (j=hit_start[i]; j<hit_start[i+1]; j++)
+	ev->cache.yn_count[hit_index[j]] += sign;
+#endif
+    }
+  } else {
+    if (msg_score >= threshold) {
+      ev->cache.ga_ny += count;
+      ev->cache.nyscore += total;
+#ifdef LAMARCK
+      for (j=hit_start[i]; j<hit_start[i+1]; j++)
+	ev->cache.ny_count[hit_index[j]] += sign;
+#endif
+    } else {
+      ev->cache.ga_nn += count;
+      ev->cache.nnscore += total;
+    }
+  }
+}
+
+/* Scores every message under ev->lookup. */
+static void rescore_all(struct evaluation *ev)
+{
   int i;
 
-  yyscore = ynscore = nyscore = nnscore = 0.0;
-  ga_yy=ga_yn=ga_ny=ga_nn=0;
+  ev->cache.yyscore = ev->cache.ynscore = 0;
+  ev->cache.nyscore = ev->cache.nnscore = 0;
+  ev->cache.ga_yy=ev->cache.ga_yn=ev->cache.ga_ny=ev->cache.ga_nn=0;
+#ifdef LAMARCK
+  memset(ev->cache.yn_count, 0, num_mutable*sizeof(*ev->cache.yn_count));
+  memset(ev->cache.ny_count, 0, num_mutable*sizeof(*ev->cache.ny_count));
+#endif
 
-  load_scores_into_lookup(ctx, p, pop);
+  score_messages(ev->lookup, 0.0, 0, num_nondup, ev->cache.msg_score);
 
   /* For every message */
-  for (i=num_nondup-1; i>=0; i--)
-  {
-    tot_score += score_msg(ctx,p,pop,i);
+  for (i=num_nondup-1; i>=0; i--) {
+    ev->cache.msg_score[i] += scores[i];	/* base from non-mutable */
+    cache_tally(ev, i, ev->cache.msg_score[i], 1);
   }
 
+  memcpy(ev->cache.alleles, ev->lookup,
+	 num_mutable*sizeof(*ev->cache.alleles));
+  ev->cache.valid = 1;
+}
+
+/* Rescores the messages hitting the n rules in ev->cache.changed. */
+static void rescore_changed(struct evaluation *ev, int n)
+{
+  unsigned int *dirty = ev->cache.dirty;
+  int num_dirty = 0;
+  unsigned int m;
+  int i, r;
+
+  for (i = 0; i < n; i++) {
+    r = ev->cache.changed[i];
+    for (m = rule_start[r]; m < rule_start[r+1]; m++) {
+      if (!ev->cache.is_dirty[rule_msgs[m]]) {
+	ev->cache.is_dirty[rule_msgs[m]] = 1;
+	dirty[num_dirty++] = rule_msgs[m];
+      }
+    }
+    ev->cache.alleles[r] = ev->lookup[r];
+  }
+
+  /* summed up in full rather than adjusted by the changes, so that a
+   * message ends up with the same score either way */
+  for (i = 0; i < num_dirty; i++) {
+    double old_score, new_score;
+    long long *total;
+
+    m = dirty[i];
+    old_score = ev->cache.msg_score[m];
+    new_score = ev->cache.msg_score[m] = sum_msg(ev->lookup, m);
+    ev->cache.is_dirty[m] = 0;
+
+    if ((old_score >= threshold) != (new_score >= threshold)) {
+      cache_tally(ev, m, old_score, -1);
+      cache_tally(ev, m, new_score, 1);
+      continue;
+    }
+    /* still on the same side of the threshold */
+    if (is_spam[m])
+      total = (new_score >= threshold) ? &ev->cache.yyscore : &ev->cache.ynscore;
+    else
+      total = (new_score >= threshold) ? &ev->cache.nyscore : &ev->cache.nnscore;
+    *total += llrint(new_score*tests_count[m]/SCORE_UNIT) -
+      llrint(old_score*tests_count[m]/SCORE_UNIT);
+  }
+}
+
+double evaluate_individual(struct evaluation *ev, PGAContext *ctx, int p,
+			   int pop)
+{
+  long work = 0;
+  int i, n = 0;
+
+  load_scores_into_lookup(ev, ctx, p, pop);
+
+  if (ev->cache.valid) {
+    for (i = 0; i < num_mutable; i++) {
+      if (ev->lookup[i] != ev->cache.alleles[i]) {
+	ev->cache.changed[n++] = i;
+	work += rule_start[i+1] - rule_start[i];
+      }
+    }
+  }
+  if (ev->cache.valid &&
+      work <= INCREMENTAL_MAX_FRACTION*hit_start[num_nondup])
+    rescore_changed(ev, n);
+  else
+    rescore_all(ev);
+
+  ev->ga_yy = ev->cache.ga_yy;
+  ev->ga_yn = ev->cache.ga_yn;
+  ev->ga_ny = ev->cache.ga_ny;
+  ev->ga_nn = ev->cache.ga_nn;
+  ev->yyscore = ev->cache.yyscore*SCORE_UNIT;
+  ev->ynscore = ev->cache.ynscore*SCORE_UNIT;
+  ev->nyscore = ev->cache.nyscore*SCORE_UNIT;
+  ev->nnscore = ev->cache.nnscore*SCORE_UNIT;
+#ifdef LAMARCK
+  for (i = 0; i < num_mutable; i++) {
+    ev->yn_hit[i] = ev->cache.yn_count[i] > 0;
+    ev->ny_hit[i] = ev->cache.ny_count[i] > 0;
+  }
+#endif
+
   if (justCount) {
     dump(stdout);
     exit (0);
   }
 
-  return evaluate_inner();
+  return evaluate_inner(ev);
 }
 
 /* So can figure out how would evaluate without above - Allen */
 
-double evaluate_inner() {
+double evaluate_inner(struct evaluation *ev) {
   double dist_from_target_fp_rate_multiplier;
   double ynweight,nyweight;
 
   /* just count how far they were from the threshold, in each case */
-  ynweight = (ga_yn * threshold) - ynscore;
-  nyweight = nyscore - (ga_ny * threshold);
+  ynweight = (ev->ga_yn * threshold) - ev->ynscore;
+  nyweight = ev->nyscore - (ev->ga_ny * threshold);
   
 #ifdef LAMARCK
   if (ynweight > (nyweight*nybias))
-    weight_balance = -1;
+    ev->weight_balance = -1;
   else if (ynweight < (nyweight*nybias))
-    weight_balance = 1;
+    ev->weight_balance = 1;
   else
-    weight_balance = 0;
+    ev->weight_balance = 0;
 #endif
 
   if (fptarget >= 0.0) {
     /* abs((FP rate as percentage) - (target FP rate)) */
     dist_from_target_fp_rate_multiplier =
-              fabs(((ga_ny / (float) num_ham) * 100.0) - fptarget);
+              fabs(((ev->ga_ny / (float) num_ham) * 100.0) - fptarget);
 
     /* now ensure it's >= 1.0 and a large multiplier */
     dist_from_target_fp_rate_multiplier =
@@ -460,7 +841,7 @@ double evaluate_inner() {
     * distance from target FP rate; then the distance of FP and FN scores
     * from the threshold (as the least important criterion) */
 
-    return    ((100 * (ga_yn + ga_ny)) * dist_from_target_fp_rate_multiplier)
+    return    ((100 * (ev->ga_yn + ev->ga_ny)) * dist_from_target_fp_rate_multiplier)
               + (ynweight + nyweight*nybias);
 
   } else {
@@ -473,6 +854,7 @@ double evaluate_inner() {
 #ifdef LAMARCK
 int adapt(PGAContext *ctx, int p, int pop, int done_eval, int threshold,
 	  int repeat) {
+  struct evaluation *ev = &main_eval;
   double *myscores;
   int i;
   int changed = 0;
@@ -492,27 +874,27 @@ int adapt(PGAContext *ctx, int p, int pop, int done_eval, int threshold,
     PGASetEvaluationUpToDateFlag(ctx, p, pop, PGA_TRUE);
   }
 
-  if ((double)ga_yn > ((double)ga_ny*nybias))
-    weight_balance--;
-  else if ((double)ga_yn < ((double)ga_ny*nybias))
-    weight_balance++;
+  if ((double)ev->ga_yn > ((double)ev->ga_ny*nybias))
+    ev->weight_balance--;
+  else if ((double)ev->ga_yn < ((double)ev->ga_ny*nybias))
+    ev->weight_balance++;
 
-  if ((weight_balance < (threshold-1)) &&
-      (weight_balance > -threshold))
+  if ((ev->weight_balance < (threshold-1)) &&
+      (ev->weight_balance > -threshold))
     return 0;
 
   myscores = PGAGetIndividual(ctx, p, pop)->chrom;
 
   if (repeat) {
     for (i = 0; i < num_mutable; i++) {
-      if ((yn_hit[i] && (weight_balance < 0)) ||
-	  (ny_hit[i] && (weight_balance > 0))) {
-	if (((weight_balance < 0) &&
+      if ((ev->yn_hit[i] && (ev->weight_balance < 0)) ||
+	  (ev->ny_hit[i] && (ev->weight_balance > 0))) {
+	if (((ev->weight_balance < 0) &&
 #ifdef USE_SCORE_RANGES
 	     (myscores[i] < range_hi[i]) &&
 #endif
 	     (myscores[i] < -(double)0.01)) ||
-	    ((weight_balance > 0) &&
+	    ((ev->weight_balance > 0) &&
 #ifdef USE_SCORE_RANGES
 	     (myscores[i] > range_lo[i]) &&
 #endif
@@ -526,7 +908,7 @@ int adapt(PGAContext *ctx, int p, int pop, int done_eval, int threshold,
 #endif
 	  if (tmp_scores[i][0]) {
 	    changed = 1;
-	    lookup[i] = 0;
+	    ev->lookup[i] = 0;
 	  }
 	} else
 	  tmp_scores[i][0] = 0;
@@ -541,24 +923,24 @@ int adapt(PGAContext *ctx, int p, int pop, int done_eval, int threshold,
     for (i=num_nondup-1; i>=0; i--) {
       tmp_total[i] = scores[i];
       scores[i] =
-	score_msg(ctx,p,pop,i)/tests_count[i]; /* score sans ones modifying */
+	score_msg(ev,i)/tests_count[i]; /* score sans ones modifying */
     }
 
     for (i = 0; i < num_mutable; i++) {
       if (tmp_scores[i][0]) {
-	lookup[i] = myscores[i];
+	ev->lookup[i] = myscores[i];
 	tmp_scores[i][1] = 1;
-	if (weight_balance < 0) {
-	  yn_hit[i] = 1;
-	  ny_hit[i] = 0;
+	if (ev->weight_balance < 0) {
+	  ev->yn_hit[i] = 1;
+	  ev->ny_hit[i] = 0;
 	} else {
-	  ny_hit[i] = 1;
-	  yn_hit[i] = 0;
+	  ev->ny_hit[i] = 1;
+	  ev->yn_hit[i] = 0;
 	}
       } else {
-	lookup[i] = 0;
+	ev->lookup[i] = 0;
 	tmp_scores[i][1] = 0;
-	yn_hit[i] = ny_hit[i] = 0;
+	ev->yn_hit[i] = ev->ny_hit[i] = 0;
       }
     }
 
@@ -566,26 +948,26 @@ int adapt(PGAContext *ctx, int p, int pop, int done_eval, int threshold,
     while (1) {
       changed = 0;
       for (i = 0; i < num_mutable; i++) {
-	if (((tmp_scores[i][0] < 0) && yn_hit[i] && /* going up */
+	if (((tmp_scores[i][0] < 0) && ev->yn_hit[i] && /* going up */
 #ifdef USE_SCORE_RANGES
-             ((lookup[i] - tmp_scores[i][0]) < range_hi[i]) &&
+             ((ev->lookup[i] - tmp_scores[i][0]) < range_hi[i]) &&
 #endif
-             (weight_balance < 0) && (lookup[i] < -(double)0.01)) ||
-	    ((tmp_scores[i][0] > 0) && ny_hit[i] && /* going down */
+             (ev->weight_balance < 0) && (ev->lookup[i] < -(double)0.01)) ||
+	    ((tmp_scores[i][0] > 0) && ev->ny_hit[i] && /* going down */
 #ifdef USE_SCORE_RANGES
-             ((lookup[i] - tmp_scores[i][0]) > range_lo[i]) &&
+             ((ev->lookup[i] - tmp_scores[i][0]) > range_lo[i]) &&
 #endif
-	     (weight_balance > 0) &&
-             (lookup[i] > (double)0.01))) {
-	  lookup[i] -= tmp_scores[i][0];
+	     (ev->weight_balance > 0) &&
+             (ev->lookup[i] > (double)0.01))) {
+	  ev->lookup[i] -= tmp_scores[i][0];
 	  changed = 1;
 	} else
 	  tmp_scores[i][0] = 0;
-	yn_hit[i] = ny_hit[i] = 0;
+	ev->yn_hit[i] = ev->ny_hit[i] = 0;
       }
 
       if (changed) {
-	if (weight_balance > 0)
+	if (ev->weight_balance > 0)
 	  adapt_ny++;
 	else
 	  adapt_yn++;
@@ -593,18 +975,18 @@ int adapt(PGAContext *ctx, int p, int pop, int done_eval, int threshold,
       } else
 	break;
 
-      yyscore = ynscore = nyscore = nnscore = 0.0;
-      ga_yy=ga_yn=ga_ny=ga_nn=0;
+      ev->yyscore = ev->ynscore = ev->nyscore = ev->nnscore = 0.0;
+      ev->ga_yy=ev->ga_yn=ev->ga_ny=ev->ga_nn=0;
 
       for (i=num_nondup-1; i>=0; i--)
-	(void)score_msg(ctx,p,pop,i);
+	(void)score_msg(ev,i);
 
-      new_evaluation = evaluate_inner();
+      new_evaluation = evaluate_inner(ev);
 
       if (new_evaluation > old_evaluation) {
 	for (i = 0; i < num_mutable; i++) {
 	  if (tmp_scores[i][0])
-	    lookup[i] += tmp_scores[i][0];
+	    ev->lookup[i] += tmp_scores[i][0];
 	}
 	new_evaluation = old_evaluation;
 	adapt_overshot++;
@@ -612,13 +994,13 @@ int adapt(PGAContext *ctx, int p, int pop, int done_eval, int threshold,
       } else
 	old_evaluation = new_evaluation;
 
-      if ((double)ga_yn > ((double)ga_ny*nybias))
-	weight_balance--;
-      else if ((double)ga_yn < ((double)ga_ny*nybias))
-	weight_balance++;
+      if ((double)ev->ga_yn > ((double)ev->ga_ny*nybias))
+	ev->weight_balance--;
+      else if ((double)ev->ga_yn < ((double)ev->ga_ny*nybias))
+	ev->weight_balance++;
       
-      if ((weight_balance < (threshold-1)) &&
-	  (weight_balance > -threshold))
+      if ((ev->weight_balance < (threshold-1)) &&
+	  (ev->weight_balance > -threshold))
 	break;
     }
     for (i=num_nondup-1; i>=0; i--)
@@ -626,7 +1008,7 @@ int adapt(PGAContext *ctx, int p, int pop, int done_eval, int threshold,
 
     for (i=0; i < num_mutable; i++) {
       if (tmp_scores[i][1])
-	myscores[i] = lookup[i];
+	myscores[i] = ev->lookup[i];
     }
 
     PGASetEvaluation(ctx, p, pop, new_evaluation);
@@ -635,8 +1017,8 @@ int adapt(PGAContext *ctx, int p, int pop, int done_eval, int threshold,
     return 1;
   } else {
     for (i = 0; i < num_mutable; i++) {
-      if ((yn_hit[i] && (weight_balance < 0)) ||
-	  (ny_hit[i] && (weight_balance > 0))) {
+      if ((ev->yn_hit[i] && (ev->weight_balance < 0)) ||
+	  (ev->ny_hit[i] && (ev->weight_balance > 0))) {
         tmp = (double)0.001*rint(myscores[i]);
 	if (! tmp) {
 	  if (myscores[i] > (double)0.01)
@@ -659,7 +1041,7 @@ int adapt(PGAContext *ctx, int p, int pop, int done_eval, int threshold,
     }
     
     if (changed) {
-      if (weight_balance > 0)
+      if (ev->weight_balance > 0)
 	adapt_ny++;
       else
 	adapt_yn++;
@@ -919,32 +1301,34 @@ int myMutation(PGAContext *ctx, int p, int pop, double mr) {
 
 void dump(FILE *fp)
 {
+  struct evaluation *ev = &main_eval;
+
    fprintf (fp,"\n# SUMMARY for threshold %3.1f:\n", threshold);
   fprintf (fp,
 	   "# Correctly non-spam: %6d  %4.3f%%  (%4.3f%% of non-spam corpus)\n",
-	   ga_nn,
-       (ga_nn / (float) num_tests) * 100.0,
-       (ga_nn / (float) num_ham) * 100.0);
+	   ev->ga_nn,
+       (ev->ga_nn / (float) num_tests) * 100.0,
+       (ev->ga_nn / (float) num_ham) * 100.0);
   fprintf (fp,
 	   "# Correctly spam:     %6d  %4.3f%%  (%4.3f%% of spam corpus)\n",
-	   ga_yy,
-       (ga_yy / (float) num_tests) * 100.0,
-       (ga_yy / (float) num_spam) * 100.0);
+	   ev->ga_yy,
+       (ev->ga_yy / (float) num_tests) * 100.0,
+       (ev->ga_yy / (float) num_spam) * 100.0);
   fprintf (fp,
 	   "# False positives:    %6d  %4.3f%%  (%4.3f%% of nonspam, %6.0f weighted)\n",
-	   ga_ny,
-       (ga_ny / (float) num_tests) * 100.0,
-       (ga_ny / (float) num_ham) * 100.0,
-       nyscore*nybias);
+	   ev->ga_ny,
+       (ev->ga_ny / (float) num_tests) * 100.0,
+       (ev->ga_ny / (float) num_ham) * 100.0,
+       ev->nyscore*nybias);
   fprintf (fp,
 	   "# False negatives:    %6d  %4.3f%%  (%4.3f%% of spam, %6.0f weighted)\n",
-	   ga_yn,
-       (ga_yn / (float) num_tests) * 100.0,
-       (ga_yn / (float) num_spam) * 100.0,
-       ynscore);
+	   ev->ga_yn,
+       (ev->ga_yn / (float) num_tests) * 100.0,
+       (ev->ga_yn / (float) num_spam) * 100.0,
+       ev->ynscore);
 
-   fprintf (fp,"# Average score for spam:  %3.1f    nonspam: %3.1f\n",(ynscore+yyscore)/((double)(ga_yn+ga_yy)),(nyscore+nnscore)/((double)(ga_nn+ga_ny)));
-   fprintf (fp,"# Average for false-pos:   %3.1f  false-neg: %3.1f\n",(nyscore/(double)ga_ny),(ynscore/(double)ga_yn));
+   fprintf (fp,"# Average score for spam:  %3.1f    nonspam: %3.1f\n",(ev->ynscore+ev->yyscore)/((double)(ev->ga_yn+ev->ga_yy)),(ev->nyscore+ev->nnscore)/((double)(ev->ga_nn+ev->ga_ny)));
+   fprintf (fp,"# Average for false-pos:   %3.1f  false-neg: %3.1f\n",(ev->nyscore/(double)ev->ga_ny),(ev->ynscore/(double)ev->ga_yn));
 
    fprintf (fp,"# TOTAL:              %6d  %3.2f%%\n\n", num_tests, 100.0);
 }
@@ -995,7 +1379,6 @@ void showSummary(PGAContext *ctx)
       int genome = PGAGetBestIndex(ctx,PGA_OLDPOP);
       FILE *scores_file = NULL;
       (void)evaluate(ctx, genome, PGA_OLDPOP);
-      PGAGetEvaluation(ctx, genome, PGA_OLDPOP);
       scores_file = fopen("garescorer.scores","w");
       WriteString(ctx, scores_file, genome, PGA_OLDPOP);
       fclose(scores_file);
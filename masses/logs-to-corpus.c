@@ -0,0 +1,700 @@
+/* Converts the mass-check logs into the binary corpus file (see corpus.h),
+ * streaming through them and parsing them on several threads.  logs-to-c
+ * works out which rules go into the corpus, with their ranges and scores,
+ * writes them to a rules file and runs this on it when it has been built;
+ * the file written is the same as logs-to-c's own.
+ *
+ * <@LICENSE>
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to you under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * </@LICENSE>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "corpus.h"
+
+/* bytes of log parsed by a thread at a time */
+#define CHUNK_SIZE	(8 << 20)
+
+int num_threads = 0;	/* 0: one per CPU */
+
+/* The rules of the corpus, by index, as listed in the rules file. */
+struct rule {
+	char *name;
+	int mutable;
+	double range_lo, range_hi, score;
+};
+
+struct rule *rules;
+int num_rules, num_mutable_rules;
+
+/* open addressing table of rule index + 1, by name */
+int *rule_table;
+unsigned int rule_table_mask;
+
+/* A piece of a log, whole lines of it, and the messages parse_chunk() found
+ * in it.  The key of a message is the sorted list of the rules it hit, as
+ * many times as it hit them; its hits are the mutable ones in the order of
+ * the log. */
+struct parsed {
+	uint64_t hash;
+	size_t key, hits;	/* offsets into keys and hits of the chunk */
+	size_t key_len, num_hits;
+	double base_score;
+};
+
+struct chunk {
+	char *text;
+	size_t len, size;
+	int spam;
+
+	struct parsed *msgs;
+	size_t num_msgs, max_msgs;
+	unsigned short *keys, *hits;
+	size_t num_keys, max_keys, num_hits, max_hits;
+
+	pthread_t thread;
+};
+
+/* Reads a log in chunks which end at a line boundary; what was read past
+ * the last newline is kept for the next chunk. */
+struct reader {
+	const char *path;
+	int fd;
+	int eof;
+	char *rest;
+	size_t rest_len, rest_size;
+};
+
+/* The distinct messages, in the order they first appeared in the logs. */
+int num_tests, num_nondup, num_spam, num_ham;
+size_t max_nondup;
+uint64_t *msg_hash;
+size_t *msg_key;	/* into all_keys, up to msg_key[i+1] */
+unsigned short *all_keys;
+size_t num_all_keys, max_all_keys;
+uint8_t *msg_spam;
+int32_t *msg_count;
+double *msg_base_score;
+uint32_t *msg_hit_start;
+unsigned short *msg_hits;
+size_t num_msg_hits, max_msg_hits;
+
+/* open addressing table of distinct message + 1, by hash */
+uint32_t *msg_table;
+size_t msg_table_mask;
+
+static void die (const char *what, const char *msg) {
+	fprintf (stderr, "logs-to-corpus: %s: %s\n", what, msg);
+	exit (1);
+}
+
+static void * xrealloc (void *p, size_t n, size_t size) {
+	if ( n > (size_t)-1 / size ) {
+		die ("out of memory", "too much to allocate");
+	}
+	p = realloc (p, n * size);
+	if ( p == NULL && n ) {
+		die ("out of memory", strerror (errno));
+	}
+	return p;
+}
+
+/* Makes room for n more elements in an array which has used of max. */
+#define reserve(array, used, max, n) do { \
+	if ( (used) + (n) > (max) ) { \
+		(max) = ((used) + (n)) * 2; \
+		(array) = xrealloc ((array), (max), sizeof(*(array))); \
+	} \
+} while (0)
+
+static unsigned int hash_name (const char *name, size_t len) {
+	unsigned int h = 2166136261u;
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		h = (h ^ (unsigned char)name[i]) * 16777619u;
+	}
+	return h;
+}
+
+/* Returns the index of the rule called name[0 .. len-1], or -1. */
+static int find_rule (const char *name, size_t len) {
+	unsigned int slot = hash_name (name, len) & rule_table_mask;
+
+	while ( rule_table[slot] ) {
+		const struct rule *r = &rules[rule_table[slot] - 1];
+
+		if ( strncmp (r->name, name, len) == 0 && r->name[len] == '\0' ) {
+			return rule_table[slot] - 1;
+		}
+		slot = (slot + 1) & rule_table_mask;
+	}
+	return -1;
+}
+
+/* The rules file has a line "name mutable range_lo range_hi score" per
+ * rule, in the order of their indexes. */
+static void read_rules (const char *path) {
+	FILE *in = fopen (path, "r");
+	char *line = NULL;
+	size_t line_size = 0, max_rules = 0;
+	int i;
+
+	if ( in == NULL ) {
+		die (path, strerror (errno));
+	}
+	while ( getline (&line, &line_size, in) != -1 ) {
+		char *name = strtok (line, " \t\n");
+		char *mutable = strtok (NULL, " \t\n");
+		char *lo = strtok (NULL, " \t\n");
+		char *hi = strtok (NULL, " \t\n");
+		char *score = strtok (NULL, " \t\n");
+		struct rule *r;
+
+		if ( name == NULL || name[0] == '#' ) {
+			continue;
+		}
+		if ( score == NULL ) {
+			die (path, "expected \"name mutable range_lo range_hi score\"");
+		}
+		reserve (rules, (size_t)num_rules, max_rules, 1);
+		r = &rules[num_rules++];
+		r->name = strdup (name);
+		r->mutable = atoi (mutable) != 0;
+		r->range_lo = strtod (lo, NULL);
+		r->range_hi = strtod (hi, NULL);
+		r->score = strtod (score, NULL);
+		if ( r->mutable ) {
+			if ( num_mutable_rules != num_rules - 1 ) {
+				die (path, "mutable rules must come first");
+			}
+			num_mutable_rules++;
+		}
+	}
+	free (line);
+	fclose (in);
+
+	if ( num_rules > 65536 ) {
+		die (path, "too many rules for the corpus format");
+	}
+	for (rule_table_mask = 1; rule_table_mask < 2 * (unsigned int)num_rules; ) {
+		rule_table_mask <<= 1;
+	}
+	rule_table = calloc (rule_table_mask, sizeof(int));
+	rule_table_mask--;
+	for (i = 0; i < num_rules; i++) {
+		unsigned int slot = hash_name (rules[i].name, strlen (rules[i].name))
+					& rule_table_mask;
+
+		while ( rule_table[slot] ) {
+			slot = (slot + 1) & rule_table_mask;
+		}
+		rule_table[slot] = i + 1;
+	}
+}
+
+static uint64_t hash_key (int spam, const unsigned short *key, size_t n) {
+	uint64_t h = 14695981039346656037ULL ^ (uint64_t)spam;
+	size_t i;
+
+	for (i = 0; i < n; i++) {
+		h = (h ^ key[i]) * 1099511628211ULL;
+	}
+	/* FNV mixes the low bits of the last few rules poorly; the table is
+	 * indexed by them */
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	return h;
+}
+
+static int compare_index (const void *a, const void *b) {
+	return *(const unsigned short *)a - *(const unsigned short *)b;
+}
+
+static void sort_key (unsigned short *key, size_t n) {
+	size_t i, j;
+
+	if ( n > 32 ) {
+		qsort (key, n, sizeof(*key), compare_index);
+		return;
+	}
+	for (i = 1; i < n; i++) {
+		unsigned short k = key[i];
+
+		for (j = i; j > 0 && key[j-1] > k; j--) {
+			key[j] = key[j-1];
+		}
+		key[j] = k;
+	}
+}
+
+static int is_space (char c) {
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f'
+		|| c == '\v';
+}
+
+/* Adds the hits of one rule, "NAME" or "NAME(count)", to message m. */
+static void parse_hit (struct chunk *c, struct parsed *m, const char *name,
+		const char *end) {
+	unsigned long times = 1, t;
+	const char *p = end;
+	int rule;
+
+	if ( p > name && p[-1] == ')' ) {
+		for (p--; p > name && p[-1] >= '0' && p[-1] <= '9'; p--)
+			;
+		if ( p < end - 1 && p > name && p[-1] == '(' ) {
+			times = strtoul (p, NULL, 10);
+			end = p - 1;
+		}
+	}
+	if ( (rule = find_rule (name, end - name)) < 0 ) {
+		return;		/* unknown, subrule or ignored */
+	}
+
+	reserve (c->keys, c->num_keys, c->max_keys, times);
+	for (t = 0; t < times; t++) {
+		c->keys[c->num_keys++] = rule;
+	}
+	m->key_len += times;
+	if ( rules[rule].mutable ) {
+		reserve (c->hits, c->num_hits, c->max_hits, times);
+		for (t = 0; t < times; t++) {
+			c->hits[c->num_hits++] = rule;
+		}
+		m->num_hits += times;
+	} else {
+		for (t = 0; t < times; t++) {
+			m->base_score += rules[rule].score;
+		}
+	}
+}
+
+/* Parses a log line, "Y  7 /path/to/msg RULE_A,RULE_B(2) time=...", into
+ * a message, taking the fields apart the way logs-to-c does: lines whose
+ * label is not "Y" or "." or which stop after the score are skipped, the
+ * path and the rules are separated by single spaces. */
+static void parse_line (struct chunk *c, const char *p, const char *end) {
+	const char *label;
+	struct parsed *m;
+
+	while ( p < end && is_space (*p) ) p++;
+	label = p;
+	while ( p < end && !is_space (*p) ) p++;
+	if ( p - label != 1 || (*label != 'Y' && *label != '.') ) {
+		return;
+	}
+	while ( p < end && is_space (*p) ) p++;
+	while ( p < end && !is_space (*p) ) p++;
+	while ( p < end && is_space (*p) ) p++;
+	if ( p == end ) {
+		return;
+	}
+
+	reserve (c->msgs, c->num_msgs, c->max_msgs, 1);
+	m = &c->msgs[c->num_msgs++];
+	m->key = c->num_keys;
+	m->hits = c->num_hits;
+	m->key_len = m->num_hits = 0;
+	m->base_score = 0.0;
+
+	if ( (p = memchr (p, ' ', end - p)) != NULL ) {
+		const char *rules_end;
+
+		p++;
+		if ( (rules_end = memchr (p, ' ', end - p)) == NULL ) {
+			rules_end = end;
+		}
+		while ( p < rules_end ) {
+			const char *comma = memchr (p, ',', rules_end - p);
+
+			if ( comma == NULL ) {
+				comma = rules_end;
+			}
+			parse_hit (c, m, p, comma);
+			p = comma + 1;
+		}
+	}
+
+	sort_key (c->keys + m->key, m->key_len);
+	m->hash = hash_key (c->spam, c->keys + m->key, m->key_len);
+}
+
+static void * parse_chunk (void *arg) {
+	struct chunk *c = arg;
+	const char *p = c->text, *end = c->text + c->len;
+
+	c->num_msgs = c->num_keys = c->num_hits = 0;
+	while ( p < end ) {
+		const char *nl = memchr (p, '\n', end - p);
+
+		if ( nl == NULL ) {
+			nl = end;
+		}
+		parse_line (c, p, nl);
+		p = nl + 1;
+	}
+	return NULL;
+}
+
+/* Fills c with the next lines of the log; returns 0 at the end of it. */
+static int read_chunk (struct reader *r, struct chunk *c) {
+	size_t want = CHUNK_SIZE, cut;
+
+	c->len = 0;
+	reserve (c->text, c->len, c->size, r->rest_len + want);
+	memcpy (c->text, r->rest, r->rest_len);
+	c->len = r->rest_len;
+	r->rest_len = 0;
+
+	for (;;) {
+		while ( !r->eof && c->len < want ) {
+			ssize_t n = read (r->fd, c->text + c->len, c->size - c->len);
+
+			if ( n < 0 ) {
+				if ( errno == EINTR ) continue;
+				die (r->path, strerror (errno));
+			}
+			if ( n == 0 ) {
+				r->eof = 1;
+			}
+			c->len += n;
+		}
+		if ( r->eof ) {
+			return c->len > 0;
+		}
+		for (cut = c->len; cut > 0 && c->text[cut-1] != '\n'; cut--)
+			;
+		if ( cut > 0 ) {
+			break;
+		}
+		/* a line longer than the chunk */
+		want = c->len * 2;
+		reserve (c->text, c->len, c->size, want - c->len);
+	}
+
+	r->rest_len = c->len - cut;
+	reserve (r->rest, 0, r->rest_size, r->rest_len);
+	memcpy (r->rest, c->text + cut, r->rest_len);
+	c->len = cut;
+	return 1;
+}
+
+static void grow_msg_table () {
+	size_t size = msg_table_mask ? (msg_table_mask + 1) * 2 : 1 << 16;
+	uint32_t i;
+
+	free (msg_table);
+	msg_table = calloc (size, sizeof(*msg_table));
+	if ( msg_table == NULL ) {
+		die ("out of memory", strerror (errno));
+	}
+	msg_table_mask = size - 1;
+	for (i = 0; i < num_nondup; i++) {
+		size_t slot = msg_hash[i] & msg_table_mask;
+
+		while ( msg_table[slot] ) {
+			slot = (slot + 1) & msg_table_mask;
+		}
+		msg_table[slot] = i + 1;
+	}
+}
+
+/* Counts the messages of a parsed chunk in, in order, adding the ones not
+ * seen before to the distinct messages. */
+static void merge_chunk (const struct chunk *c) {
+	size_t k;
+
+	for (k = 0; k < c->num_msgs; k++) {
+		const struct parsed *m = &c->msgs[k];
+		const unsigned short *key = c->keys + m->key;
+		size_t slot;
+		int i;
+
+		if ( num_tests == INT_MAX ) {
+			die ("logs", "too many messages for the corpus format");
+		}
+		num_tests++;
+		if ( c->spam ) {
+			num_spam++;
+		} else {
+			num_ham++;
+		}
+
+		for (slot = m->hash & msg_table_mask; msg_table[slot];
+				slot = (slot + 1) & msg_table_mask) {
+			i = msg_table[slot] - 1;
+			if ( msg_hash[i] == m->hash && msg_spam[i] == c->spam
+					&& msg_key[i+1] - msg_key[i] == m->key_len
+					&& memcmp (all_keys + msg_key[i], key,
+						m->key_len * sizeof(*key)) == 0 ) {
+				break;
+			}
+		}
+		if ( msg_table[slot] ) {
+			msg_count[msg_table[slot] - 1]++;
+			continue;
+		}
+
+		i = num_nondup++;
+		msg_table[slot] = i + 1;
+		if ( (size_t)num_nondup > max_nondup ) {
+			max_nondup = max_nondup ? max_nondup * 2 : 1 << 16;
+			msg_hash = xrealloc (msg_hash, max_nondup, sizeof(*msg_hash));
+			msg_key = xrealloc (msg_key, max_nondup + 1, sizeof(*msg_key));
+			msg_spam = xrealloc (msg_spam, max_nondup, sizeof(*msg_spam));
+			msg_count = xrealloc (msg_count, max_nondup, sizeof(*msg_count));
+			msg_base_score = xrealloc (msg_base_score, max_nondup,
+					sizeof(*msg_base_score));
+			msg_hit_start = xrealloc (msg_hit_start, max_nondup + 1,
+					sizeof(*msg_hit_start));
+		}
+		msg_hash[i] = m->hash;
+		msg_spam[i] = c->spam;
+		msg_count[i] = 1;
+		msg_base_score[i] = m->base_score;
+
+		reserve (all_keys, num_all_keys, max_all_keys, m->key_len);
+		memcpy (all_keys + num_all_keys, key, m->key_len * sizeof(*key));
+		msg_key[i] = num_all_keys;
+		num_all_keys += m->key_len;
+		msg_key[i+1] = num_all_keys;
+
+		if ( num_msg_hits + m->num_hits > 0xffffffffu ) {
+			die ("logs", "too many hits for the corpus format");
+		}
+		reserve (msg_hits, num_msg_hits, max_msg_hits, m->num_hits);
+		memcpy (msg_hits + num_msg_hits, c->hits + m->hits,
+				m->num_hits * sizeof(*msg_hits));
+		msg_hit_start[i] = num_msg_hits;
+		num_msg_hits += m->num_hits;
+		msg_hit_start[i+1] = num_msg_hits;
+
+		if ( (size_t)num_nondup * 2 > msg_table_mask ) {
+			grow_msg_table ();
+		}
+	}
+}
+
+/* Reads a log, num_threads chunks at a time: all but the first are parsed
+ * on threads of their own, then they are merged in the order of the log. */
+static void read_log (const char *path, int spam, struct chunk *chunks) {
+	struct reader r;
+	int n, t;
+
+	memset (&r, 0, sizeof(r));
+	r.path = path;
+	if ( (r.fd = open (path, O_RDONLY)) < 0 ) {
+		die (path, strerror (errno));
+	}
+
+	do {
+		for (n = 0; n < num_threads && read_chunk (&r, &chunks[n]); n++) {
+			chunks[n].spam = spam;
+		}
+		for (t = 1; t < n; t++) {
+			if ( pthread_create (&chunks[t].thread, NULL, parse_chunk, &chunks[t]) ) {
+				die ("pthread_create", strerror (errno));
+			}
+		}
+		if ( n > 0 ) {
+			parse_chunk (&chunks[0]);
+		}
+		for (t = 1; t < n; t++) {
+			pthread_join (chunks[t].thread, NULL);
+		}
+		for (t = 0; t < n; t++) {
+			merge_chunk (&chunks[t]);
+		}
+	} while ( n == num_threads );
+
+	close (r.fd);
+	free (r.rest);
+}
+
+static void write_section (FILE *out, uint64_t *offset, uint64_t *where,
+		const void *data, size_t len) {
+	static const char zeros[8];
+	size_t pad = (8 - *offset % 8) % 8;
+
+	if ( out ) {
+		fwrite (zeros, 1, pad, out);
+		fwrite (data, 1, len, out);
+	}
+	*offset += pad;
+	*where = *offset;
+	*offset += len;
+}
+
+/* Writes the sections in the order of the header, once to work out the
+ * offsets and once more to write them after it. */
+static void write_corpus (const char *path) {
+	struct corpus_header hdr;
+	uint8_t *is_mutable = malloc (num_rules + 1);
+	double *range_lo = malloc ((num_rules + 1) * sizeof(double));
+	double *range_hi = malloc ((num_rules + 1) * sizeof(double));
+	double *bestscores = malloc ((num_rules + 1) * sizeof(double));
+	uint32_t *name_start = malloc ((num_rules + 1) * sizeof(uint32_t));
+	char *names, *tmp;
+	size_t names_len = 0;
+	FILE *out = NULL;
+	int i, pass;
+
+	for (i = 0; i < num_rules; i++) {
+		is_mutable[i] = rules[i].mutable;
+		range_lo[i] = rules[i].range_lo;
+		range_hi[i] = rules[i].range_hi;
+		bestscores[i] = rules[i].score;
+		name_start[i] = names_len;
+		names_len += strlen (rules[i].name) + 1;
+	}
+	name_start[num_rules] = names_len;
+	names = malloc (names_len + 1);
+	for (i = 0; i < num_rules; i++) {
+		strcpy (names + name_start[i], rules[i].name);
+	}
+	if ( num_nondup == 0 ) {
+		msg_hit_start = xrealloc (msg_hit_start, 1, sizeof(*msg_hit_start));
+		msg_hit_start[0] = 0;
+	}
+
+	memset (&hdr, 0, sizeof(hdr));
+	memcpy (hdr.magic, CORPUS_MAGIC, sizeof(hdr.magic));
+	hdr.version = CORPUS_VERSION;
+	hdr.byte_order = CORPUS_BYTE_ORDER;
+	hdr.num_tests = num_tests;
+	hdr.num_nondup = num_nondup;
+	hdr.num_spam = num_spam;
+	hdr.num_ham = num_ham;
+	hdr.num_scores = num_rules;
+	hdr.num_mutable = num_mutable_rules;
+	hdr.num_hits = num_msg_hits;
+
+	tmp = malloc (strlen (path) + 32);
+	sprintf (tmp, "%s.%d", path, (int)getpid ());
+
+	for (pass = 0; pass < 2; pass++) {
+		uint64_t offset = sizeof(hdr);
+
+		if ( pass == 1 ) {
+			if ( (out = fopen (tmp, "w")) == NULL ) {
+				die (tmp, strerror (errno));
+			}
+			fwrite (&hdr, sizeof(hdr), 1, out);
+		}
+		write_section (out, &offset, &hdr.hit_start, msg_hit_start,
+				(num_nondup + 1) * sizeof(uint32_t));
+		write_section (out, &offset, &hdr.hit_index, msg_hits,
+				num_msg_hits * sizeof(uint16_t));
+		write_section (out, &offset, &hdr.is_spam, msg_spam, num_nondup);
+		write_section (out, &offset, &hdr.tests_count, msg_count,
+				num_nondup * sizeof(int32_t));
+		write_section (out, &offset, &hdr.base_score, msg_base_score,
+				num_nondup * sizeof(double));
+		write_section (out, &offset, &hdr.is_mutable, is_mutable, num_rules);
+		write_section (out, &offset, &hdr.range_lo, range_lo,
+				num_rules * sizeof(double));
+		write_section (out, &offset, &hdr.range_hi, range_hi,
+				num_rules * sizeof(double));
+		write_section (out, &offset, &hdr.bestscores, bestscores,
+				num_rules * sizeof(double));
+		write_section (out, &offset, &hdr.name_start, name_start,
+				(num_rules + 1) * sizeof(uint32_t));
+		write_section (out, &offset, &hdr.names, names, names_len);
+		hdr.file_size = offset;
+	}
+	if ( ferror (out) | fclose (out) ) {
+		die (tmp, strerror (errno));
+	}
+	if ( rename (tmp, path) < 0 ) {
+		die (tmp, strerror (errno));
+	}
+
+	printf ("Wrote %d messages (%d distinct, %lu hits) and %d rules to %s\n",
+			num_tests, num_nondup, (unsigned long)num_msg_hits,
+			num_rules, path);
+	free (tmp);
+	free (names);
+	free (name_start);
+	free (bestscores);
+	free (range_hi);
+	free (range_lo);
+	free (is_mutable);
+}
+
+void usage () {
+	printf ("usage: logs-to-corpus [args] rules-file [spam.log [ham.log]]\n"
+			"\n"
+			"  -o corpus = file to write (" CORPUS_FILE " default)\n"
+			"  -j threads = threads parsing the logs (one per CPU default)\n"
+			"  -h = print this help\n"
+			"\n"
+			"  The rules file is written by logs-to-c, which runs this.\n"
+			"\n");
+	exit(30);
+}
+
+int main (int argc, char ** argv) {
+	const char *corpus_file = CORPUS_FILE;
+	const char *spam_log = "spam.log", *ham_log = "ham.log";
+	struct chunk *chunks;
+	int arg;
+
+	while ((arg = getopt (argc, argv, "o:j:h?")) != -1) {
+		switch (arg) {
+			case 'o':
+				corpus_file = optarg;
+				break;
+
+			case 'j':
+				num_threads = atoi(optarg);
+				break;
+
+			case 'h':
+			case '?':
+				usage();
+				break;
+		}
+	}
+	if ( optind >= argc || argc - optind > 3 ) {
+		usage();
+	}
+	if ( argc - optind > 1 ) spam_log = argv[optind+1];
+	if ( argc - optind > 2 ) ham_log = argv[optind+2];
+
+	if ( num_threads <= 0 ) {
+		num_threads = sysconf (_SC_NPROCESSORS_ONLN);
+		if ( num_threads <= 0 ) num_threads = 1;
+	}
+
+	read_rules (argv[optind]);
+	grow_msg_table ();
+	chunks = calloc (num_threads, sizeof(*chunks));
+
+	read_log (spam_log, 1, chunks);
+	read_log (ham_log, 0, chunks);
+	write_corpus (corpus_file);
+	return 0;
+}
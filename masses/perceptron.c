@@ -1,6 +1,6 @@
 /* This program uses stochastic gradient descent to learn a scoreset for
  * SpamAssassin.  You'll need to run logs-to-c from spamassassin/masses to
- * generate the stuff in tmp.
+ * generate the corpus file in tmp.
  *
  * <@LICENSE>
  * Licensed to the Apache Software Foundation (ASF) under one or more
@@ -26,9 +26,14 @@
 #include <sys/time.h>
 #include <math.h>
 #include <unistd.h>
+#include <pthread.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/wait.h>
 
-#include "tmp/scores.h"
-#include "tmp/tests.h"
+#include "corpus.h"
+#include "score-kernel.h"
 
 /* Ensure that multiple error functions have not been chosen. */
 #ifdef ENTROPIC_ERROR
@@ -52,6 +57,13 @@ void destroy_wheel ();
 int get_random_test ();
 void init_weights();
 void destroy_weights ();
+struct results {
+	int ga_nn, ga_yy, ga_ny, ga_yn;
+	double nnscore, yyscore, nyscore, ynscore;
+};
+
+void add_results (struct results * res, int fold);
+void write_summary (FILE * fp, const struct results * res);
 void write_weights (FILE * fp);
 void scale_scores (double old_threshold, double new_threshold);
 double evaluate_test (int test);
@@ -59,6 +71,9 @@ double evaluate_test_nogain (int test);
 void train (int num_epochs, double learning_rate);
 void usage ();
 
+/* messages scored at a time by add_results() */
+#define SCORE_BLOCK 1024
+
 /* Converts a weight to a SpamAssassin score. */
 #define weight_to_score(x) (-threshold*(x)/bias)
 #define score_to_weight(x) (-(x)*bias/threshold)
@@ -74,10 +89,19 @@ double threshold = DEFAULT_THRESHOLD;
 double * weights; /* The weights of the single-layer perceptron. */
 double bias; /* The network bias for the single-layer perceptron. */
 
+const char * corpus_file = CORPUS_FILE;
 int num_epochs = 15;
 double learning_rate = 2.0;
 double weight_decay = 1.0;
 
+int num_threads = 1;
+int batch_size = 0; /* 1 with one thread, 64 with more */
+
+/* For cross-validation: the fold of each instance, and the one held out
+ * from training. */
+int * fold_of;
+int held_out_fold = -1;
+
 /* Initialize the roulette wheel and populate it, replicating harder-to-classify hams. */
 void init_wheel () {
 	int i;
@@ -92,11 +116,16 @@ void init_wheel () {
 	for (i = 0; i < num_nondup - 1; i++) {
 		int slot_size = 1;
 
+		if ( held_out_fold >= 0 && fold_of[i] == held_out_fold ) {
+			roulette_wheel[i+1] = roulette_wheel[i];
+			continue;
+		}
+
 		/* Hams with more tests are rare and harder to classify but are the
 		 * most important to classify correctly.  They are thus replicated in the
 		 * training set proportionally to their difficulty. */
 		if ( ! is_spam[i] ) {
-			slot_size += (int)(num_tests_hit[i] * ham_preference * tests_count[i]);
+			slot_size += (int)(num_tests_hit(i) * ham_preference * tests_count[i]);
 		} else {
 			slot_size = tests_count[i];
 		}
@@ -175,60 +204,82 @@ void destroy_weights () {
 	}
 }
 
-/* Writes out the weights in SpamAssassin score space. */
-void write_weights (FILE * fp) {
-	int i;
-	int ga_nn, ga_yy, ga_ny, ga_yn;
-	double nnscore, yyscore, nyscore, ynscore;
-
-	ga_nn = ga_yy = ga_ny = ga_yn = 0;
-	nnscore = yyscore = nyscore = ynscore = 0;
-
-	/* Run through all of the instances in the training set and tally up
-	 * the scores. */
-	for (i = 0; i < num_nondup; i++) {
-		double score = weight_to_score(evaluate_test_nogain(i)) + threshold;
-
-		if ( score >= threshold && is_spam[i] ) {
-			ga_yy += tests_count[i];
-			yyscore += tests_count[i] * score;
-		} else if ( score < threshold && !is_spam[i] ) {
-			ga_nn += tests_count[i]; 
-			nnscore += tests_count[i] * score;
-		} else if ( score >= threshold && !is_spam[i] ) {
-			ga_ny += tests_count[i];
-			nyscore += tests_count[i] * score;
-		} else {
-			ga_yn += tests_count[i];
-			ynscore += tests_count[i] * score;
+/* Tallies up the classification of the instances in fold (or of all of
+ * them if fold is -1) with the current weights. */
+void add_results (struct results * res, int fold) {
+	double score[SCORE_BLOCK];
+	int count[SCORE_BLOCK];
+	struct tally t;
+	int first, k;
+
+	memset (&t, 0, sizeof(t));
+	for (first = 0; first < num_nondup; first += SCORE_BLOCK) {
+		int n = num_nondup - first < SCORE_BLOCK ? num_nondup - first : SCORE_BLOCK;
+
+		/* the same sums as evaluate_test_nogain() */
+		score_messages (weights, bias, first, n, score);
+		for (k = 0; k < n; k++) {
+			score[k] = weight_to_score(score[k]
+					+ score_to_weight(scores[first+k])) + threshold;
+			count[k] = (fold >= 0 && fold_of[first+k] != fold) ? 0
+				: tests_count[first+k];
 		}
+		tally_messages (score, count, first, n, threshold, &t);
 	}
 
+	res->ga_nn += t.count[TALLY_NN];
+	res->ga_ny += t.count[TALLY_NY];
+	res->ga_yn += t.count[TALLY_YN];
+	res->ga_yy += t.count[TALLY_YY];
+	res->nnscore += t.score[TALLY_NN];
+	res->nyscore += t.score[TALLY_NY];
+	res->ynscore += t.score[TALLY_YN];
+	res->yyscore += t.score[TALLY_YY];
+}
+
+/* Prints a summary of tallied up results. */
+void write_summary (FILE * fp, const struct results * res) {
+	int ga_nn = res->ga_nn, ga_yy = res->ga_yy, ga_ny = res->ga_ny, ga_yn = res->ga_yn;
+	double nnscore = res->nnscore, yyscore = res->yyscore;
+	double nyscore = res->nyscore, ynscore = res->ynscore;
+	int ham = ga_nn + ga_ny, spam = ga_yy + ga_yn;
+
 	/* This is copied from the dump() function in craig-evolve.c.  It 
 	 * outputs some nice statistics about the learned classifier. */
 	fprintf (fp,"\n# SUMMARY for threshold %3.1f:\n", threshold);
 	fprintf (fp,
 			"# Correctly non-spam: %6d  %4.2f%%\n",
 			ga_nn,
-			(ga_nn / (float) num_ham) * 100.0);
+			(ga_nn / (float) ham) * 100.0);
 	fprintf (fp,
 			"# Correctly spam:     %6d  %4.2f%%\n",
 			ga_yy,
-			(ga_yy / (float) num_spam) * 100.0);
+			(ga_yy / (float) spam) * 100.0);
 	fprintf (fp,
 			"# False positives:    %6d  %4.2f%%\n",
 			ga_ny,
-			(ga_ny / (float) num_ham) * 100.0);
+			(ga_ny / (float) ham) * 100.0);
 	fprintf (fp,
 			"# False negatives:    %6d  %4.2f%%\n",
 			ga_yn,
-			(ga_yn / (float) num_spam) * 100.0);
+			(ga_yn / (float) spam) * 100.0);
 
 	fprintf (fp,"# Average score for spam:  %3.3f    ham: %3.1f\n",(ynscore+yyscore)/((double)(ga_yn+ga_yy)),(nyscore+nnscore)/((double)(ga_nn+ga_ny)));
 	fprintf (fp,"# Average for false-pos:   %3.3f  false-neg: %3.1f\n",(nyscore/(double)ga_ny),(ynscore/(double)ga_yn));
 
-	fprintf (fp,"# TOTAL:              %6d  %3.2f%%\n\n", num_tests, 100.0);
+	fprintf (fp,"# TOTAL:              %6d  %3.2f%%\n\n", ham + spam, 100.0);
+}
+
+/* Writes out the weights in SpamAssassin score space. */
+void write_weights (FILE * fp) {
+	struct results res;
+	int i;
 
+	/* Run through all of the instances in the training set and tally up
+	 * the scores. */
+	memset (&res, 0, sizeof(res));
+	add_results (&res, -1);
+	write_summary (fp, &res);
 
 	for (i = 0; i < num_scores; i++) {
 		if ( is_mutable[i] )  {
@@ -277,15 +328,15 @@ double evaluate_test (int test) {
 }
 
 /* Computes the value of the transfer function (in this case, linear) for
- * an input defined in tests_hit[test]* */
+ * the input defined by the hits of test. */
 double evaluate_test_nogain (int test) {
 	double sum;
-	int i;
+	unsigned int h;
 
 	sum = bias;
 
-	for (i = 0; i < num_tests_hit[test]; i++) {
-		sum += weights[tests_hit[test][i]];
+	for (h = hit_start[test]; h < hit_start[test+1]; h++) {
+		sum += weights[hit_index[h]];
 	}
 
 	/* Translate the 'unmutable' scores to weight space. */
@@ -294,12 +345,200 @@ double evaluate_test_nogain (int test) {
 	return sum;
 }
 
+/* Keeps a weight within the range of its rule (or at least on the right
+ * side of zero, with IGNORE_SCORE_RANGES). */
+static void constrain_weight (int idx) {
+#ifdef IGNORE_SCORE_RANGES
+	/* Constrain the weights so that nice rules are always <= 0 etc. */
+	if ( range_lo[idx] >= 0 && weights[idx] < 0 ) {
+		weights[idx] = 0;
+	} else if ( range_hi[idx] <= 0 && weights[idx] > 0 ) {
+		weights[idx] = 0;
+	}
+#else
+	if ( weights[idx] < score_to_weight(range_lo[idx]) ) {
+		weights[idx] = score_to_weight(range_lo[idx]);
+	} else if ( weights[idx] > score_to_weight(range_hi[idx]) ) {
+		weights[idx] = score_to_weight(range_hi[idx]);
+	}
+#endif
+}
+
+/* Computes the step for the weights of the rules a test hit. */
+static double compute_delta (int test, double learning_rate) {
+	double y_out, error, delta;
+
+	/* compute the output of the network */
+	y_out = evaluate_test(test);
+
+/* compute the error gradient for the logsig node with least squares error */
+#ifdef LEAST_SQUARES_ERROR
+	error = is_spam[test] - y_out;
+	delta = y_out * (1-y_out) * error / (num_tests_hit(test)+1) * learning_rate;
+#else
+/* compute the error gradient for the tanh node with entropic error */
+#ifdef ENTROPIC_ERROR
+	error = (2.0*is_spam[test]-1) - y_out;
+	delta = error / (num_tests_hit(test)+1) * learning_rate;
+#endif
+#endif
+	return delta;
+}
+
+/* Per-epoch preparation: weight decay, then a fresh order of the training
+ * instances. */
+static void start_epoch (int * tests) {
+	int i;
+
+	/* decay the weights on every epoch to smooth out statistical
+	 * anomalies */
+	if ( weight_decay != 1.0 ) {
+		bias *= weight_decay;
+		for (i = 0; i < num_mutable; i++) {
+			weights[i] *= weight_decay;
+		}
+	}
+
+	/* shuffle the training instances */
+	for (i = 0; i < wheel_size-1; i++) {
+		int tmp;
+		int r = lrand48 () % (wheel_size - i);
+
+		tmp = tests[i];
+		tests[i] = tests[r+i];
+		tests[r+i] = tmp;
+	}
+}
+
+/* Mini-batch training.  Each thread works out the steps for its share of a
+ * batch against the same weights, into its own sums.  The sums are then
+ * added up in thread order, each thread doing a share of the rules, and
+ * their mean over the batch is applied with the usual range clamping.  As
+ * a batch makes one step where plain SGD would make many, the learning rate
+ * is scaled up by the square root of the batch size.  A batch of one
+ * instance on one thread is plain stochastic gradient descent.  Given the
+ * same seed, batch size and number of threads, runs give the same scores. */
+struct batch_worker {
+	int id;
+	pthread_t thread;
+	double * step;		/* summed steps for each rule */
+	unsigned char * hit;	/* whether the rule was hit in this batch */
+	double bias_step;
+};
+
+static struct {
+	int * tests;
+	int num_epochs;
+	double learning_rate;
+	struct batch_worker * workers;
+	pthread_barrier_t barrier;
+} batch;
+
+static void * batch_worker_run (void * arg) {
+	struct batch_worker * w = (struct batch_worker *)arg;
+	int epoch, start, i, r, t;
+	unsigned int h;
+
+	for (epoch = 0; epoch < batch.num_epochs; epoch++) {
+		if ( w->id == 0 ) {
+			start_epoch (batch.tests);
+		}
+		pthread_barrier_wait (&batch.barrier);
+
+		for (start = 0; start < wheel_size; start += batch_size) {
+			int len = wheel_size - start < batch_size ? wheel_size - start : batch_size;
+
+			/* this thread's share of the batch */
+			for (i = start + len * w->id / num_threads;
+					i < start + len * (w->id + 1) / num_threads; i++) {
+				int test = batch.tests[i];
+				double delta = compute_delta (test, batch.learning_rate);
+
+				w->bias_step += delta;
+				for (h = hit_start[test]; h < hit_start[test+1]; h++) {
+					w->step[hit_index[h]] += delta;
+					w->hit[hit_index[h]] = 1;
+				}
+			}
+			pthread_barrier_wait (&batch.barrier);
+
+			/* the bias first, the ranges of the weights depend on it */
+			if ( w->id == 0 ) {
+				for (t = 0; t < num_threads; t++) {
+					if ( epoch + 1 < batch.num_epochs ) {
+						bias += batch.workers[t].bias_step / len;
+					}
+					batch.workers[t].bias_step = 0;
+				}
+			}
+			pthread_barrier_wait (&batch.barrier);
+
+			/* this thread's share of the rules */
+			for (r = num_mutable * w->id / num_threads;
+					r < num_mutable * (w->id + 1) / num_threads; r++) {
+				double step = 0;
+				int hit = 0;
+
+				for (t = 0; t < num_threads; t++) {
+					step += batch.workers[t].step[r];
+					hit |= batch.workers[t].hit[r];
+					batch.workers[t].step[r] = 0;
+					batch.workers[t].hit[r] = 0;
+				}
+				if ( hit ) {
+					weights[r] += step / len;
+					constrain_weight (r);
+				}
+			}
+			pthread_barrier_wait (&batch.barrier);
+		}
+	}
+	return NULL;
+}
+
+static void train_batched (int * tests, int num_epochs, double learning_rate) {
+	int t;
+
+	batch.tests = tests;
+	batch.num_epochs = num_epochs;
+	batch.learning_rate = learning_rate * sqrt(batch_size);
+	batch.workers = (struct batch_worker *)calloc(num_threads, sizeof(struct batch_worker));
+	pthread_barrier_init (&batch.barrier, NULL, num_threads);
+
+	for (t = 0; t < num_threads; t++) {
+		batch.workers[t].id = t;
+		batch.workers[t].step = (double*)calloc(num_mutable, sizeof(double));
+		batch.workers[t].hit = (unsigned char*)calloc(num_mutable, 1);
+	}
+
+	/* the calling thread is worker 0 */
+	for (t = 1; t < num_threads; t++) {
+		if ( pthread_create (&batch.workers[t].thread, NULL, batch_worker_run,
+					&batch.workers[t]) != 0 ) {
+			perror ("pthread_create");
+			exit (1);
+		}
+	}
+	batch_worker_run (&batch.workers[0]);
+	for (t = 1; t < num_threads; t++) {
+		pthread_join (batch.workers[t].thread, NULL);
+	}
+
+	pthread_barrier_destroy (&batch.barrier);
+	for (t = 0; t < num_threads; t++) {
+		free (batch.workers[t].step);
+		free (batch.workers[t].hit);
+	}
+	free (batch.workers);
+}
+
 /* Trains the perceptron using stochastic gradient descent. */
 void train (int num_epochs, double learning_rate) {
 	int epoch, random_test;
 	int i, j;
+	unsigned int h;
 	int * tests;
-	double y_out, error, delta;
+	double delta;
 
 	/* Initialize and populate an array containing indices of training
 	 * instances.  This is shuffled on every epoch and then iterated
@@ -316,73 +555,281 @@ void train (int num_epochs, double learning_rate) {
 		tests[j] = num_nondup-1;
 	}
 
-	for (epoch = 0; epoch < num_epochs; epoch++) {
-		/* decay the weights on every epoch to smooth out statistical
-		 * anomalies */
-		if ( weight_decay != 1.0 ) {
-			bias *= weight_decay;
-			for (i = 0; i < num_mutable; i++) {
-				weights[i] *= weight_decay;
-			}
-		}
-
-		/* shuffle the training instances */
-		for (i = 0; i < wheel_size-1; i++) {
-			int tmp;
-			int r = lrand48 () % (wheel_size - i);
+	if ( num_threads > 1 || batch_size > 1 ) {
+		train_batched (tests, num_epochs, learning_rate);
+		free(tests);
+		return;
+	}
 
-			tmp = tests[i];
-			tests[i] = tests[r+i];
-			tests[r+i] = tmp;
-		}
+	for (epoch = 0; epoch < num_epochs; epoch++) {
+		start_epoch (tests);
 
 		for (j = 0; j < wheel_size; j++) {
 
 			/* select a random test (they have been randomized above) */
 			random_test = tests[j];
 
-			/* compute the output of the network */
-			y_out = evaluate_test(random_test);
-	
-/* compute the error gradient for the logsig node with least squares error */
-#ifdef LEAST_SQUARES_ERROR
-			error = is_spam[random_test] - y_out;
-			delta = y_out * (1-y_out) * error / (num_tests_hit[random_test]+1) * learning_rate;
-#else
-/* compute the error gradient for the tanh node with entropic error */
-#ifdef ENTROPIC_ERROR
-			error = (2.0*is_spam[random_test]-1) - y_out;
-			delta = error / (num_tests_hit[random_test]+1) * learning_rate;
-#endif
-#endif
+			delta = compute_delta (random_test, learning_rate);
 	
 			/* adjust the weights to descend the steepest part of the error gradient */
 			if ( epoch + 1 < num_epochs ) {
 				bias += delta;
 			}
-			for (i = 0; i < num_tests_hit[random_test]; i++) {
-				int idx = tests_hit[random_test][i];
+			for (h = hit_start[random_test]; h < hit_start[random_test+1]; h++) {
+				int idx = hit_index[h];
 				weights[idx] += delta;
+				constrain_weight (idx);
+			}
+		}
+	}
 
-#ifdef IGNORE_SCORE_RANGES
-				/* Constrain the weights so that nice rules are always <= 0 etc. */
-				if ( range_lo[idx] >= 0 && weights[idx] < 0 ) {
-					weights[idx] = 0;
-				} else if ( range_hi[idx] <= 0 && weights[idx] > 0 ) {
-					weights[idx] = 0;
+	free(tests);
+}
+
+/* Hyperparameter sweep.  Every combination of the values given with -S
+ * (or a random sample of them, with -R) is trained and evaluated with k-fold
+ * cross-validation.  The corpus is loaded once; each (setting, fold) pair is
+ * trained in a child process of its own, several at a time, and sends its
+ * results back through a pipe. */
+#define SWEEP_PARAMS "pelw"
+#define MAX_SWEEP_VALUES 64
+
+double sweep_values[4][MAX_SWEEP_VALUES];
+int sweep_count[4];
+int sweep_random = 0;	/* settings to pick at random, 0 for all */
+int num_folds = 5;
+int num_procs = 0;	/* parallel trainings, 0 for one per CPU */
+
+struct setting {
+	double ham_preference;
+	int num_epochs;
+	double learning_rate;
+	double weight_decay;
+	struct results results;
+};
+
+/* Parses "p=1,2,4" etc. */
+void add_sweep_values (const char * spec) {
+	const char * param = spec[0] ? strchr(SWEEP_PARAMS, spec[0]) : NULL;
+	const char * p;
+	int n;
+
+	if ( !param || spec[1] != '=' ) {
+		fprintf (stderr, "bad sweep '%s', expected one of " SWEEP_PARAMS
+				" followed by =values\n", spec);
+		exit (30);
+	}
+	n = param - SWEEP_PARAMS;
+	for (p = spec + 2; *p; ) {
+		char * end;
+		double v = strtod (p, &end);
+
+		if ( end == p || (*end && *end != ',') ) {
+			fprintf (stderr, "bad value in sweep '%s'\n", spec);
+			exit (30);
+		}
+		if ( sweep_count[n] == MAX_SWEEP_VALUES ) {
+			fprintf (stderr, "too many values in sweep '%s'\n", spec);
+			exit (30);
+		}
+		sweep_values[n][sweep_count[n]++] = v;
+		p = *end ? end + 1 : end;
+	}
+}
+
+/* Trains with one setting, leaving out one fold, and returns the results
+ * for that fold; with a single fold, it trains and tests on everything.
+ * Runs in a child process, so it can use the globals. */
+static void run_fold (const struct setting * set, int fold, long seed,
+		struct results * res) {
+	ham_preference = set->ham_preference;
+	num_epochs = set->num_epochs;
+	learning_rate = set->learning_rate;
+	weight_decay = set->weight_decay;
+	held_out_fold = num_folds > 1 ? fold : -1;
+
+	/* the same seed for a fold whatever the setting */
+	srand48 (seed + fold);
+	init_wheel ();
+	init_weights ();
+	train (num_epochs, learning_rate);
+
+	memset (res, 0, sizeof(*res));
+	add_results (res, held_out_fold);
+}
+
+int sweep (long seed) {
+	struct setting * settings;
+	int num_settings, num_jobs, next, running;
+	pid_t * job_pid;
+	int * job_fd;
+	int i, n;
+
+	/* every combination of the values, defaulting to the ones given with
+	 * the usual options */
+	if ( !sweep_count[0] ) sweep_values[0][sweep_count[0]++] = ham_preference;
+	if ( !sweep_count[1] ) sweep_values[1][sweep_count[1]++] = num_epochs;
+	if ( !sweep_count[2] ) sweep_values[2][sweep_count[2]++] = learning_rate;
+	if ( !sweep_count[3] ) sweep_values[3][sweep_count[3]++] = weight_decay;
+
+	num_settings = sweep_count[0] * sweep_count[1] * sweep_count[2] * sweep_count[3];
+	settings = (struct setting *)calloc(num_settings, sizeof(struct setting));
+	for (i = 0; i < num_settings; i++) {
+		int k = i;
+
+		settings[i].weight_decay = sweep_values[3][k % sweep_count[3]];
+		k /= sweep_count[3];
+		settings[i].learning_rate = sweep_values[2][k % sweep_count[2]];
+		k /= sweep_count[2];
+		settings[i].num_epochs = (int)sweep_values[1][k % sweep_count[1]];
+		k /= sweep_count[1];
+		settings[i].ham_preference = sweep_values[0][k];
+	}
+
+	srand48 (seed);
+
+	/* random search: keep a random sample of the grid, in grid order */
+	if ( sweep_random > 0 && sweep_random < num_settings ) {
+		int * order = (int*)calloc(num_settings, sizeof(int));
+		unsigned char * keep = (unsigned char*)calloc(num_settings, 1);
+
+		for (i = 0; i < num_settings; i++) {
+			order[i] = i;
+		}
+		for (i = 0; i < sweep_random; i++) {
+			int r = i + lrand48 () % (num_settings - i);
+			int tmp = order[i];
+
+			order[i] = order[r];
+			order[r] = tmp;
+			keep[order[i]] = 1;
+		}
+		for (i = 0, n = 0; i < num_settings; i++) {
+			if ( keep[i] ) {
+				settings[n++] = settings[i];
+			}
+		}
+		num_settings = n;
+		free (order);
+		free (keep);
+	}
+
+	/* assign the instances to folds of about the same size */
+	fold_of = (int*)calloc(num_nondup, sizeof(int));
+	if ( num_folds > 1 ) {
+		int * order = (int*)calloc(num_nondup, sizeof(int));
+
+		for (i = 0; i < num_nondup; i++) {
+			order[i] = i;
+		}
+		for (i = 0; i < num_nondup - 1; i++) {
+			int r = i + lrand48 () % (num_nondup - i);
+			int tmp = order[i];
+
+			order[i] = order[r];
+			order[r] = tmp;
+		}
+		for (i = 0; i < num_nondup; i++) {
+			fold_of[order[i]] = i % num_folds;
+		}
+		free (order);
+	}
+
+	if ( num_procs < 1 ) {
+		num_procs = sysconf (_SC_NPROCESSORS_ONLN) / num_threads;
+		if ( num_procs < 1 ) {
+			num_procs = 1;
+		}
+	}
+
+	num_jobs = num_settings * num_folds;
+	job_pid = (pid_t*)calloc(num_jobs, sizeof(pid_t));
+	job_fd = (int*)calloc(num_jobs, sizeof(int));
+
+	printf ("Sweeping %d settings with %d-fold cross-validation, %d at a time.\n",
+			num_settings, num_folds, num_procs);
+	fflush (stdout);
+
+	for (next = 0, running = 0; next < num_jobs || running > 0; ) {
+		pid_t pid;
+		int status;
+
+		if ( next < num_jobs && running < num_procs ) {
+			int fd[2];
+
+			if ( pipe (fd) < 0 || (pid = fork ()) < 0 ) {
+				perror ("sweep");
+				exit (1);
+			}
+			if ( pid == 0 ) {
+				struct results res;
+
+				close (fd[0]);
+				if ( !freopen ("/dev/null", "w", stdout) ) {
+					_exit (1);
 				}
-#else
-				if ( weights[idx] < score_to_weight(range_lo[idx]) ) {
-					weights[idx] = score_to_weight(range_lo[idx]);
-				} else if ( weights[idx] > score_to_weight(range_hi[idx]) ) {
-					weights[idx] = score_to_weight(range_hi[idx]);
+				run_fold (&settings[next / num_folds], next % num_folds, seed, &res);
+				if ( write (fd[1], &res, sizeof(res)) != sizeof(res) ) {
+					_exit (1);
 				}
-#endif
+				_exit (0);
 			}
+			close (fd[1]);
+			job_pid[next] = pid;
+			job_fd[next] = fd[0];
+			next++;
+			running++;
+			continue;
+		}
+
+		if ( (pid = wait (&status)) < 0 ) {
+			if ( errno == EINTR ) {
+				continue;
+			}
+			perror ("wait");
+			exit (1);
+		}
+		for (i = 0; i < next; i++) {
+			struct results res;
+			struct results * sum;
+
+			if ( job_pid[i] != pid ) {
+				continue;
+			}
+			if ( !WIFEXITED(status) || WEXITSTATUS(status) != 0
+					|| read (job_fd[i], &res, sizeof(res)) != sizeof(res) ) {
+				fprintf (stderr, "sweep: training %d (fold %d) failed\n",
+						i / num_folds + 1, i % num_folds);
+				exit (1);
+			}
+			close (job_fd[i]);
+			job_pid[i] = 0;
+			running--;
+
+			sum = &settings[i / num_folds].results;
+			sum->ga_nn += res.ga_nn;
+			sum->ga_yy += res.ga_yy;
+			sum->ga_ny += res.ga_ny;
+			sum->ga_yn += res.ga_yn;
+			sum->nnscore += res.nnscore;
+			sum->yyscore += res.yyscore;
+			sum->nyscore += res.nyscore;
+			sum->ynscore += res.ynscore;
+			break;
 		}
 	}
 
-	free(tests);
+	for (i = 0; i < num_settings; i++) {
+		printf ("# SETTING -p %g -e %d -l %g -w %g (%d-fold cross-validation)",
+				settings[i].ham_preference, settings[i].num_epochs,
+				settings[i].learning_rate, settings[i].weight_decay, num_folds);
+		write_summary (stdout, &settings[i].results);
+	}
+
+	free (job_pid);
+	free (job_fd);
+	free (settings);
+	return 0;
 }
 
 void usage () {
@@ -394,6 +841,17 @@ void usage () {
 			"  -l learning_rate = learning rate for gradient descent (2.0 default)\n"
 			"  -t threshold = minimum threshold for spam (5.0 default)\n"
 			"  -w weight_decay = per-epoch decay of learned weight and bias (1.0 default)\n"
+			"  -c corpus = corpus file written by logs-to-c (" CORPUS_FILE " default)\n"
+			"  -j threads = number of threads to train with (1 default)\n"
+			"  -b batch_size = training instances per weight update (1 default, 64 with -j)\n"
+			"  -s seed = seed for the random number generator (default: from the time)\n"
+			"\n"
+			"  -S param=value,... = sweep: cross-validate every combination of the given\n"
+			"                       values of p, e, l and w (repeatable)\n"
+			"  -R count = sweep a random sample of count combinations only\n"
+			"  -k folds = number of cross-validation folds (5 default, 1 to train and\n"
+			"             test on the whole corpus)\n"
+			"  -P procs = trainings to run at once (default: CPUs / threads)\n"
 			"  -h = print this help\n"
 			"\n");
 	exit(30);
@@ -404,9 +862,12 @@ int main (int argc, char ** argv) {
 	long long int t_usec;
 	FILE * fp;
 	int arg;
+	long seed = 0;
+	int have_seed = 0;
+	int sweeping = 0;
 
 	/* Read the command line options */
-	while ((arg = getopt (argc, argv, "p:e:l:t:w:h?")) != -1) {
+	while ((arg = getopt (argc, argv, "p:e:l:t:w:c:j:b:s:S:R:k:P:h?")) != -1) {
 		switch (arg) {
 			case 'p':
 				ham_preference = atof(optarg);
@@ -428,6 +889,42 @@ int main (int argc, char ** argv) {
 				weight_decay = atof(optarg);
 				break;
 
+			case 'c':
+				corpus_file = optarg;
+				break;
+
+			case 'j':
+				num_threads = atoi(optarg);
+				break;
+
+			case 'b':
+				batch_size = atoi(optarg);
+				break;
+
+			case 's':
+				seed = atol(optarg);
+				have_seed = 1;
+				break;
+
+			case 'S':
+				add_sweep_values (optarg);
+				sweeping = 1;
+				break;
+
+			case 'R':
+				sweep_random = atoi(optarg);
+				sweeping = 1;
+				break;
+
+			case 'k':
+				num_folds = atoi(optarg);
+				sweeping = 1;
+				break;
+
+			case 'P':
+				num_procs = atoi(optarg);
+				break;
+
 			case 'h':
 			case '?':
 				usage();
@@ -435,20 +932,38 @@ int main (int argc, char ** argv) {
 		}
 	}
 
-	/* Seed the PRNG */
-	gettimeofday (&tv, 0);
-	t_usec = tv.tv_sec * 1000000 + tv.tv_usec;
-	srand48 ((int)t_usec);
+	if ( num_threads < 1 ) {
+		num_threads = 1;
+	}
+	if ( batch_size < 1 ) {
+		batch_size = num_threads > 1 ? 64 : 1;
+	}
+	if ( num_folds < 1 ) {
+		num_folds = 1;
+	}
+
+	/* Seed the PRNG; a given seed makes the run reproducible */
+	if ( !have_seed ) {
+		gettimeofday (&tv, 0);
+		t_usec = tv.tv_sec * 1000000 + tv.tv_usec;
+		seed = (int)t_usec;
+	}
+	srand48 (seed);
+	printf ("Random seed = %ld.\n", seed);
 
 	/* Load the instances and score constraints generated by logs-to-c. */
-	loadtests();
-	loadscores();
+	load_corpus (corpus_file);
+	select_score_kernel (NULL);
 
 	/* If the threshold has been changed, the ranges and scores need to be
 	 * scaled so that the output of the program will not be affected.
 	 */
 	scale_scores (DEFAULT_THRESHOLD, threshold);
 
+	if ( sweeping ) {
+		return sweep (seed);
+	}
+
 	/* Replicate instances from the training set to bias against false positives. */
 	init_wheel ();
 
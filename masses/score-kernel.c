@@ -0,0 +1,258 @@
+/* Scores and tallies up blocks of messages of the corpus at once.  See
+ * score-kernel.h.
+ *
+ * <@LICENSE>
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to you under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * </@LICENSE>
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+
+#include "corpus.h"
+#include "score-kernel.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HAVE_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+static void score_messages_scalar (const double *lookup, double init,
+		int first, int n, double *msg_score) {
+	int k;
+
+	for (k = 0; k < n; k++) {
+		double sum = init;
+		unsigned int h;
+
+		for (h = hit_start[first+k]; h < hit_start[first+k+1]; h++) {
+			sum += lookup[hit_index[h]];
+		}
+		msg_score[k] = sum;
+	}
+}
+
+/* No branches on the outcome: the index of the tally entry is worked out
+ * from the label and the comparison. */
+static void tally_messages_scalar (const double *msg_score, const int *count,
+		int first, int n, double threshold, struct tally *t) {
+	int k;
+
+	for (k = 0; k < n; k++) {
+		int i = first + k;
+		int which = (is_spam[i] != 0) * 2 + (msg_score[k] >= threshold);
+
+		t->count[which] += count[k];
+		t->score[which] += msg_score[k] * count[k];
+	}
+}
+
+#ifdef HAVE_X86_KERNELS
+
+/* Two messages at a time, one in each lane.  There are no gathers, so the
+ * rule values are loaded one by one; a lane whose message has no more hits
+ * adds 0. */
+__attribute__((target("sse2")))
+static void score_messages_sse2 (const double *lookup, double init,
+		int first, int n, double *msg_score) {
+	int k;
+
+	for (k = 0; k + 2 <= n; k += 2) {
+		int i = first + k;
+		unsigned int s0 = hit_start[i], n0 = hit_start[i+1] - s0;
+		unsigned int s1 = hit_start[i+1], n1 = hit_start[i+2] - s1;
+		unsigned int j, max = n0 > n1 ? n0 : n1;
+		__m128d acc = _mm_set1_pd (init);
+
+		for (j = 0; j < max; j++) {
+			double a = j < n0 ? lookup[hit_index[s0+j]] : 0.0;
+			double b = j < n1 ? lookup[hit_index[s1+j]] : 0.0;
+
+			acc = _mm_add_pd (acc, _mm_set_pd (b, a));
+		}
+		_mm_storeu_pd (msg_score + k, acc);
+	}
+	score_messages_scalar (lookup, init, first + k, n - k, msg_score + k);
+}
+
+__attribute__((target("sse2")))
+static void tally_messages_sse2 (const double *msg_score, const int *count,
+		int first, int n, double threshold, struct tally *t) {
+	const __m128d zero = _mm_setzero_pd ();
+	const __m128d thr = _mm_set1_pd (threshold);
+	__m128d cnt[4], sum[4];
+	double lanes[2];
+	int k, c;
+
+	for (c = 0; c < 4; c++) {
+		cnt[c] = sum[c] = zero;
+	}
+	for (k = 0; k + 2 <= n; k += 2) {
+		int i = first + k;
+		__m128d s = _mm_loadu_pd (msg_score + k);
+		__m128d w = _mm_cvtepi32_pd (_mm_loadl_epi64 ((const __m128i *)(count + k)));
+		__m128d spam = _mm_cmpneq_pd (_mm_set_pd (is_spam[i+1], is_spam[i]), zero);
+		__m128d ge = _mm_cmpge_pd (s, thr);
+		__m128d ws = _mm_mul_pd (s, w);
+		__m128d m[4];
+
+		m[TALLY_NN] = _mm_andnot_pd (spam, _mm_andnot_pd (ge, _mm_castsi128_pd (_mm_set1_epi32 (-1))));
+		m[TALLY_NY] = _mm_andnot_pd (spam, ge);
+		m[TALLY_YN] = _mm_andnot_pd (ge, spam);
+		m[TALLY_YY] = _mm_and_pd (spam, ge);
+		for (c = 0; c < 4; c++) {
+			cnt[c] = _mm_add_pd (cnt[c], _mm_and_pd (m[c], w));
+			sum[c] = _mm_add_pd (sum[c], _mm_and_pd (m[c], ws));
+		}
+	}
+	for (c = 0; c < 4; c++) {
+		_mm_storeu_pd (lanes, cnt[c]);
+		t->count[c] += lanes[0] + lanes[1];
+		_mm_storeu_pd (lanes, sum[c]);
+		t->score[c] += lanes[0] + lanes[1];
+	}
+	tally_messages_scalar (msg_score + k, count + k, first + k, n - k, threshold, t);
+}
+
+/* Four messages at a time, one in each lane, for as many steps as the one
+ * with the most hits has.  Each step gathers the next rule of every lane
+ * from hit_index, then its value from lookup; lanes which are done are
+ * masked off and add 0.  hit_index holds 16-bit numbers and is gathered
+ * 32 bits at a time, so the block holding the very last hit is left to
+ * the scalar loop, which does not read past it. */
+__attribute__((target("avx2")))
+static void score_messages_avx2 (const double *lookup, double init,
+		int first, int n, double *msg_score) {
+	const __m128i low16 = _mm_set1_epi32 (0xffff);
+	const __m128i one = _mm_set1_epi32 (1);
+	int k;
+
+	if ( hit_start[num_nondup] > INT_MAX ) {
+		/* the gathers take signed 32-bit indexes */
+		score_messages_sse2 (lookup, init, first, n, msg_score);
+		return;
+	}
+
+	for (k = 0; k + 4 <= n; k += 4) {
+		int i = first + k;
+		__m128i start = _mm_loadu_si128 ((const __m128i *)(hit_start + i));
+		__m128i end = _mm_loadu_si128 ((const __m128i *)(hit_start + i + 1));
+		__m128i left = _mm_sub_epi32 (end, start);
+		__m128i max = _mm_max_epi32 (left, _mm_shuffle_epi32 (left, 0x4e));
+		__m256d acc = _mm256_set1_pd (init);
+		int j, steps;
+
+		if ( hit_start[i+4] == hit_start[num_nondup] ) {
+			break;
+		}
+		max = _mm_max_epi32 (max, _mm_shuffle_epi32 (max, 0xb1));
+		steps = _mm_cvtsi128_si32 (max);
+
+		for (j = 0; j < steps; j++) {
+			__m128i live = _mm_cmpgt_epi32 (left, _mm_setzero_si128 ());
+			__m128i rule = _mm_mask_i32gather_epi32 (_mm_setzero_si128 (),
+					(const int *)hit_index, start, live, 2);
+			__m256d value = _mm256_mask_i32gather_pd (_mm256_setzero_pd (),
+					lookup, _mm_and_si128 (rule, low16),
+					_mm256_castsi256_pd (_mm256_cvtepi32_epi64 (live)), 8);
+
+			acc = _mm256_add_pd (acc, value);
+			start = _mm_add_epi32 (start, one);
+			left = _mm_sub_epi32 (left, one);
+		}
+		_mm256_storeu_pd (msg_score + k, acc);
+	}
+	/* gcc leaves the upper halves dirty, which makes the SSE code of the
+	 * caller (libm's exp, say) crawl */
+	_mm256_zeroupper ();
+	score_messages_scalar (lookup, init, first + k, n - k, msg_score + k);
+}
+
+__attribute__((target("avx2")))
+static void tally_messages_avx2 (const double *msg_score, const int *count,
+		int first, int n, double threshold, struct tally *t) {
+	const __m256d thr = _mm256_set1_pd (threshold);
+	const __m256d all = _mm256_castsi256_pd (_mm256_set1_epi32 (-1));
+	__m256d cnt[4], sum[4];
+	double lanes[4];
+	int k, c;
+
+	for (c = 0; c < 4; c++) {
+		cnt[c] = sum[c] = _mm256_setzero_pd ();
+	}
+	for (k = 0; k + 4 <= n; k += 4) {
+		int i = first + k, labels;
+		__m256d s = _mm256_loadu_pd (msg_score + k);
+		__m256d w = _mm256_cvtepi32_pd (_mm_loadu_si128 ((const __m128i *)(count + k)));
+		__m256d ge = _mm256_cmp_pd (s, thr, _CMP_GE_OQ);
+		__m256d ws = _mm256_mul_pd (s, w);
+		__m256d spam, m[4];
+
+		memcpy (&labels, is_spam + i, 4);
+		spam = _mm256_castsi256_pd (_mm256_cvtepi32_epi64 (_mm_cmpgt_epi32 (
+					_mm_cvtepu8_epi32 (_mm_cvtsi32_si128 (labels)),
+					_mm_setzero_si128 ())));
+
+		m[TALLY_NN] = _mm256_andnot_pd (spam, _mm256_andnot_pd (ge, all));
+		m[TALLY_NY] = _mm256_andnot_pd (spam, ge);
+		m[TALLY_YN] = _mm256_andnot_pd (ge, spam);
+		m[TALLY_YY] = _mm256_and_pd (spam, ge);
+		for (c = 0; c < 4; c++) {
+			cnt[c] = _mm256_add_pd (cnt[c], _mm256_and_pd (m[c], w));
+			sum[c] = _mm256_add_pd (sum[c], _mm256_and_pd (m[c], ws));
+		}
+	}
+	for (c = 0; c < 4; c++) {
+		_mm256_storeu_pd (lanes, cnt[c]);
+		t->count[c] += (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+		_mm256_storeu_pd (lanes, sum[c]);
+		t->score[c] += (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+	}
+	_mm256_zeroupper ();
+	tally_messages_scalar (msg_score + k, count + k, first + k, n - k, threshold, t);
+}
+
+#endif /* HAVE_X86_KERNELS */
+
+void (*score_messages) (const double *, double, int, int, double *) =
+	score_messages_scalar;
+void (*tally_messages) (const double *, const int *, int, int, double,
+		struct tally *) = tally_messages_scalar;
+
+const char * select_score_kernel (const char *name) {
+#ifdef HAVE_X86_KERNELS
+	__builtin_cpu_init ();
+	if ( (name == NULL || strcmp (name, "avx2") == 0)
+			&& __builtin_cpu_supports ("avx2") ) {
+		score_messages = score_messages_avx2;
+		tally_messages = tally_messages_avx2;
+		return "avx2";
+	}
+	if ( (name == NULL || strcmp (name, "sse2") == 0)
+			&& __builtin_cpu_supports ("sse2") ) {
+		score_messages = score_messages_sse2;
+		tally_messages = tally_messages_sse2;
+		return "sse2";
+	}
+#endif
+	if ( name == NULL || strcmp (name, "scalar") == 0 ) {
+		score_messages = score_messages_scalar;
+		tally_messages = tally_messages_scalar;
+		return "scalar";
+	}
+	return NULL;
+}
@@ -0,0 +1,54 @@
+/* Scores and tallies up blocks of messages of the corpus at once, with
+ * vector instructions where the CPU has them.
+ *
+ * <@LICENSE>
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to you under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * </@LICENSE>
+ */
+
+#ifndef SCORE_KERNEL_H
+#define SCORE_KERNEL_H
+
+/* Indexes into struct tally: is_spam*2 + (score >= threshold). */
+#define TALLY_NN	0	/* ham, correctly */
+#define TALLY_NY	1	/* false positive */
+#define TALLY_YN	2	/* false negative */
+#define TALLY_YY	3	/* spam, correctly */
+
+struct tally {
+	double count[4];	/* messages, weighted by count */
+	double score[4];	/* sum of their scores, weighted likewise */
+};
+
+/* Sets msg_score[k], for k in 0 .. n-1, to init plus the values in lookup
+ * of the rules message first+k hit, added up in the order of hit_index, so
+ * that the result is the same as that of a plain loop doing so. */
+extern void (*score_messages) (const double *lookup, double init, int first,
+		int n, double *msg_score);
+
+/* Adds the n messages starting at first, message first+k scoring
+ * msg_score[k], to the tally, count[k] times over (tests_count + first to
+ * count them as many times as they were seen). */
+extern void (*tally_messages) (const double *msg_score, const int *count,
+		int first, int n, double threshold, struct tally *t);
+
+/* Picks the implementation of the functions above: "avx2", "sse2" or
+ * "scalar", or the best one the CPU can run if name is NULL.  Returns the
+ * name of the one picked, or NULL if the one asked for cannot be used.
+ * Until it is called the scalar ones are used. */
+const char * select_score_kernel (const char *name);
+
+#endif /* SCORE_KERNEL_H */
@@ -0,0 +1,911 @@
+/* <@LICENSE>
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to you under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * </@LICENSE>
+ */
+
+/*
+ * spamd-fe -- accept/dispatch front-end for spamd.
+ *
+ * Accepts connections from spamc (optionally over SSL/TLS), reads and
+ * validates the request line and headers as described in spamd/PROTOCOL,
+ * then hands the connection to a spamd child over a UNIX domain socket
+ * which spamd listens on with "--listen=fe:/path".  The client's file
+ * descriptor is passed along (SCM_RIGHTS), so spamd reads the message body
+ * from and writes its answer to the client directly.  For SSL connections
+ * a socketpair takes the place of the client socket and spamd-fe relays
+ * the decrypted stream.
+ *
+ * Per hand-over, spamd-fe sends a single NUL byte carrying the descriptor,
+ * followed by
+ *
+ *     Peer: <address> <port>\r\n       (or "Peer: unix <path>")
+ *     TLS: <version>/<cipher>\r\n      (SSL connections only)
+ *     Request-length: <n>\r\n
+ *     \r\n
+ *     <n bytes: request line and headers, up to the empty line>
+ *
+ * Unix only.  See spamd-fe.pod for usage.
+ */
+
+#include "config.h"
+
+#include <stdarg.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+
+#ifdef HAVE_SYSEXITS_H
+#include <sysexits.h>
+#endif
+#ifdef HAVE_ERRNO_H
+#include <errno.h>
+#endif
+#ifdef HAVE_SYS_ERRNO_H
+#include <sys/errno.h>
+#endif
+
+#ifdef SPAMC_SSL
+#include <openssl/ssl.h>
+#include <openssl/err.h>
+#else
+typedef int SSL;		/* fake type to avoid conditional compilation */
+typedef int SSL_CTX;
+#endif
+
+#include "getopt.h"
+
+#ifndef EX_OK
+#define EX_OK           0
+#define EX_USAGE        64
+#define EX_UNAVAILABLE  69
+#define EX_SOFTWARE     70
+#define EX_OSERR        71
+#define EX_CONFIG       78
+#endif
+#ifndef EX_PROTOCOL
+#define EX_PROTOCOL     76
+#endif
+#ifndef EX_TEMPFAIL
+#define EX_TEMPFAIL     75
+#endif
+
+/* spamd reads at most 255 headers plus the terminating empty line */
+#define FE_MAX_HEADERS  255
+/* request line and headers; spamc sends well below 1k */
+#define FE_MAX_REQUEST  16384
+#define FE_MAX_LISTEN   16
+#define FE_RELAY_BUF    65536
+
+struct listener
+{
+    int fd;
+    int ssl;
+    const char *spec;
+    const char *path;		/* UNIX sockets only */
+};
+
+struct request
+{
+    char buf[FE_MAX_REQUEST];
+    int len;			/* bytes in buf */
+    int hdr_len;		/* request line and headers, 0 until complete */
+};
+
+static struct listener listeners[FE_MAX_LISTEN];
+static int n_listeners = 0;
+
+static const char *dispatch_path = NULL;
+static const char *pidfile = NULL;
+static int n_workers = 5;
+static int timeout = 30;
+static long max_size = 0;
+static int debug = 0;
+
+#ifdef SPAMC_SSL
+static SSL_CTX *ssl_ctx = NULL;
+#endif
+static const char *ssl_cert = NULL;
+static const char *ssl_key = NULL;
+
+static volatile sig_atomic_t got_term = 0;
+
+static const char *const methods[] = {
+    "PROCESS", "CHECK", "SYMBOLS", "REPORT", "REPORT_IFSPAM", "HEADERS",
+    "TELL", "SKIP", "PING", NULL
+};
+
+static void fe_log(int is_debug, const char *fmt, ...)
+{
+    va_list ap;
+
+    if (is_debug && !debug)
+	return;
+    va_start(ap, fmt);
+    fprintf(stderr, "spamd-fe[%d]: ", (int) getpid());
+    vfprintf(stderr, fmt, ap);
+    fputc('\n', stderr);
+    va_end(ap);
+}
+
+static void usage(void)
+{
+    printf("Usage: spamd-fe [options]\n\n");
+    printf("  -l, --listen [ssl:]host:port|[ssl:]/path\n"
+	   "                      Accept spamc connections here; may be given\n"
+	   "                      more than once [default: localhost:783]\n");
+    printf("  -d, --dispatch path UNIX socket spamd listens on with\n"
+	   "                      --listen=fe:path (required)\n");
+    printf("  -n, --workers num   Number of accepting processes [5]\n");
+    printf("  -t, --timeout sec   Timeout reading the request headers [30]\n");
+    printf("  -s, --max-size size Reject messages larger than this [0: no limit]\n");
+#ifdef SPAMC_SSL
+    printf("  --ssl-cert path     Server certificate for ssl: sockets\n");
+    printf("  --ssl-key path      Server key for ssl: sockets\n");
+#endif
+    printf("  -r, --pidfile path  Write the process id to this file\n");
+    printf("  -D, --debug         Log every connection to stderr\n");
+    printf("  -h, --help          Print this help message and exit\n");
+}
+
+/* ---------------------------------------------------------------------- */
+
+static int set_blocking(int fd, int blocking)
+{
+    int flags = fcntl(fd, F_GETFL, 0);
+
+    if (flags < 0)
+	return -1;
+    flags = blocking ? (flags & ~O_NONBLOCK) : (flags | O_NONBLOCK);
+    return fcntl(fd, F_SETFL, flags);
+}
+
+static int listen_unix(const char *path)
+{
+    struct sockaddr_un addr;
+    int fd;
+
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+	fe_log(0, "socket path too long: %s", path);
+	return -1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+	fe_log(0, "socket: %s", strerror(errno));
+	return -1;
+    }
+    unlink(path);
+    if (bind(fd, (struct sockaddr *) &addr, sizeof(addr)) < 0
+	|| chmod(path, 0666) < 0 || listen(fd, SOMAXCONN) < 0) {
+	fe_log(0, "cannot listen on %s: %s", path, strerror(errno));
+	close(fd);
+	return -1;
+    }
+    return fd;
+}
+
+static int listen_inet(const char *spec)
+{
+    char host[256];
+    const char *port = "783";
+    const char *colon;
+    struct addrinfo hints, *res, *ai;
+    int fd = -1, on = 1, rc;
+
+    /* host:port, [v6addr]:port, host or :port */
+    if (spec[0] == '[') {
+	const char *end = strchr(spec, ']');
+	if (!end || (size_t) (end - spec - 1) >= sizeof(host))
+	    return -1;
+	memcpy(host, spec + 1, end - spec - 1);
+	host[end - spec - 1] = '\0';
+	if (end[1] == ':')
+	    port = end + 2;
+    }
+    else if ((colon = strrchr(spec, ':')) != NULL) {
+	if ((size_t) (colon - spec) >= sizeof(host))
+	    return -1;
+	memcpy(host, spec, colon - spec);
+	host[colon - spec] = '\0';
+	port = colon + 1;
+    }
+    else {
+	if (strlen(spec) >= sizeof(host))
+	    return -1;
+	strcpy(host, spec);
+    }
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+    rc = getaddrinfo(host[0] == '\0' || strcmp(host, "*") == 0 ? NULL : host,
+		     port, &hints, &res);
+    if (rc != 0) {
+	fe_log(0, "cannot resolve %s: %s", spec, gai_strerror(rc));
+	return -1;
+    }
+    for (ai = res; ai != NULL; ai = ai->ai_next) {
+	fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+	if (fd < 0)
+	    continue;
+	setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+	if (bind(fd, ai->ai_addr, ai->ai_addrlen) == 0
+	    && listen(fd, SOMAXCONN) == 0)
+	    break;
+	close(fd);
+	fd = -1;
+    }
+    if (fd < 0)
+	fe_log(0, "cannot listen on %s: %s", spec, strerror(errno));
+    freeaddrinfo(res);
+    return fd;
+}
+
+static int add_listener(const char *spec)
+{
+    struct listener *l;
+    const char *addr = spec;
+
+    if (n_listeners == FE_MAX_LISTEN) {
+	fe_log(0, "too many listen sockets");
+	return -1;
+    }
+    l = &listeners[n_listeners];
+    l->spec = spec;
+    l->ssl = 0;
+    if (strncasecmp(addr, "ssl:", 4) == 0) {
+#ifdef SPAMC_SSL
+	l->ssl = 1;
+	addr += 4;
+#else
+	fe_log(0, "%s: not built with SSL support", spec);
+	return -1;
+#endif
+    }
+    l->path = addr[0] == '/' ? addr : NULL;
+    l->fd = l->path ? listen_unix(addr) : listen_inet(addr);
+    if (l->fd < 0)
+	return -1;
+    /* all workers poll the same sockets; the losers get EAGAIN */
+    set_blocking(l->fd, 0);
+    n_listeners++;
+    return 0;
+}
+
+#ifdef SPAMC_SSL
+static SSL_CTX *ssl_server_init(void)
+{
+    SSL_CTX *ctx;
+
+    SSL_library_init();
+    SSL_load_error_strings();
+    ctx = SSL_CTX_new(SSLv23_server_method());
+    if (ctx == NULL) {
+	fe_log(0, "cannot create SSL context");
+	return NULL;
+    }
+    SSL_CTX_set_options(ctx, SSL_OP_NO_SSLv2 | SSL_OP_NO_SSLv3);
+    SSL_CTX_set_mode(ctx, SSL_MODE_AUTO_RETRY);
+    if (!ssl_cert || !ssl_key
+	|| !SSL_CTX_use_certificate_chain_file(ctx, ssl_cert)
+	|| !SSL_CTX_use_PrivateKey_file(ctx, ssl_key, SSL_FILETYPE_PEM)
+	|| !SSL_CTX_check_private_key(ctx)) {
+	fe_log(0, "cannot load certificate %s and key %s: %s",
+	       ssl_cert ? ssl_cert : "(none)", ssl_key ? ssl_key : "(none)",
+	       ERR_reason_error_string(ERR_get_error()));
+	SSL_CTX_free(ctx);
+	return NULL;
+    }
+    return ctx;
+}
+#endif
+
+/* ---------------------------------------------------------------------- */
+
+static int full_write_fd(int fd, const char *buf, int len)
+{
+    int total = 0, n;
+
+    while (total < len) {
+	n = write(fd, buf + total, len - total);
+	if (n < 0 && errno == EINTR)
+	    continue;
+	if (n <= 0)
+	    return -1;
+	total += n;
+    }
+    return total;
+}
+
+static int client_write(int fd, SSL *ssl, const char *buf, int len)
+{
+#ifdef SPAMC_SSL
+    if (ssl)
+	return SSL_write(ssl, buf, len) == len ? len : -1;
+#endif
+    (void) ssl;
+    return full_write_fd(fd, buf, len);
+}
+
+/* same wording as spamd's protocol_error() */
+static void protocol_error(int fd, SSL *ssl, const char *peer, const char *err)
+{
+    char line[256];
+    int len = snprintf(line, sizeof(line),
+		       "SPAMD/1.0 %d Bad header line: %s\r\n", EX_PROTOCOL,
+		       err);
+    client_write(fd, ssl, line, len);
+    fe_log(0, "bad protocol from %s: header error: %s", peer, err);
+}
+
+/* Returns the length of the request line and headers if buf holds all of
+ * them, 0 if more is needed.  Protocol 1.0 and older have no headers.
+ */
+static int request_length(const char *buf, int len)
+{
+    const char *nl = memchr(buf, '\n', len);
+    const char *p, *ver;
+
+    if (!nl)
+	return 0;
+    ver = NULL;
+    for (p = buf; p + 6 < nl; p++) {
+	if (memcmp(p, "SPAMC/", 6) == 0) {
+	    ver = p + 6;
+	    break;
+	}
+    }
+    if (!ver || strtod(ver, NULL) <= 1.0)
+	return nl + 1 - buf;
+
+    /* headers end with an empty "\r\n" line */
+    for (p = nl + 1; p < buf + len;) {
+	nl = memchr(p, '\n', buf + len - p);
+	if (!nl)
+	    return 0;
+	if (nl == p + 1 && *p == '\r')
+	    return nl + 1 - buf;
+	p = nl + 1;
+    }
+    return 0;
+}
+
+/* Reads the request line and headers.  A plain socket is peeked at first,
+ * so that exactly the header bytes are consumed and the body stays in the
+ * socket for spamd; over SSL whatever follows the headers is left in buf.
+ * Returns NULL or an error message for the client.
+ */
+static const char *read_request(int fd, SSL *ssl, struct request *req)
+{
+    int n;
+
+    req->len = 0;
+    req->hdr_len = 0;
+    while (req->hdr_len == 0) {
+	int room = sizeof(req->buf) - req->len;
+
+	if (room == 0)
+	    return "(request headers too long)";
+#ifdef SPAMC_SSL
+	if (ssl) {
+	    n = SSL_read(ssl, req->buf + req->len, room);
+	    if (n <= 0)
+		return "(closed before headers)";
+	    req->len += n;
+	    req->hdr_len = request_length(req->buf, req->len);
+	    continue;
+	}
+#endif
+	n = recv(fd, req->buf + req->len, room, MSG_PEEK);
+	if (n < 0 && errno == EINTR)
+	    continue;
+	if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+	    return "(timeout reading headers)";
+	if (n <= 0)
+	    return "(closed before headers)";
+	req->hdr_len = request_length(req->buf, req->len + n);
+	if (req->hdr_len)
+	    n = req->hdr_len - req->len;
+	/* the bytes are there already, this does not block */
+	n = recv(fd, req->buf + req->len, n, MSG_WAITALL);
+	if (n <= 0)
+	    return "(closed before headers)";
+	req->len += n;
+    }
+    return NULL;
+}
+
+static int valid_number(const char *p, const char *end)
+{
+    if (p == end)
+	return 0;
+    for (; p < end; p++) {
+	if (*p < '0' || *p > '9')
+	    return 0;
+    }
+    return 1;
+}
+
+/* Checks the request the way spamd would, so that malformed requests never
+ * reach a spamd child.  Returns NULL or an error message for the client.
+ */
+static const char *validate_request(const struct request *req)
+{
+    const char *p = req->buf, *end = req->buf + req->hdr_len;
+    const char *nl = memchr(p, '\n', end - p);
+    const char *sp = memchr(p, ' ', nl - p);
+    int i, nhdr = 0;
+
+    if (!sp)
+	return "(unknown command)";
+    for (i = 0; methods[i]; i++) {
+	if ((size_t) (sp - p) == strlen(methods[i])
+	    && memcmp(p, methods[i], sp - p) == 0)
+	    break;
+    }
+    if (!methods[i] || nl - sp < 8 || memcmp(sp + 1, "SPAMC/", 6) != 0)
+	return "(unknown command)";
+
+    for (p = nl + 1; p < end; p = nl + 1) {
+	const char *colon, *value, *vend;
+
+	nl = memchr(p, '\n', end - p);
+	if (nl == p + 1 && *p == '\r')
+	    break;
+	if (++nhdr > FE_MAX_HEADERS)
+	    return "(too many headers)";
+
+	vend = nl > p && nl[-1] == '\r' ? nl - 1 : nl;
+	colon = memchr(p, ':', vend - p);
+	if (!colon)
+	    return "(header not in 'Name: value' format)";
+	for (value = colon + 1; value < vend && (*value == ' ' || *value == '\t');
+	     value++);
+
+	if (colon - p == 14 && memcmp(p, "Content-length", 14) == 0) {
+	    if (value < vend && !valid_number(value, vend))
+		return "(Content-Length contains non-numeric bytes)";
+	    if (max_size > 0 && value < vend && strtol(value, NULL, 10) > max_size)
+		return "(message larger than the front-end's --max-size)";
+	}
+	else if (colon - p == 4 && memcmp(p, "User", 4) == 0) {
+	    const char *c;
+	    for (c = value; c < vend; c++) {
+		if ((unsigned char) *c < 0x20)
+		    return "(User header contains control chars)";
+	    }
+	}
+    }
+    return NULL;
+}
+
+/* ---------------------------------------------------------------------- */
+
+static void peer_description(int fd, const struct listener *l,
+			     char *out, size_t outlen)
+{
+    struct sockaddr_storage ss;
+    socklen_t sslen = sizeof(ss);
+    char host[NI_MAXHOST], serv[NI_MAXSERV];
+
+    if (getpeername(fd, (struct sockaddr *) &ss, &sslen) == 0
+	&& ss.ss_family != AF_UNIX
+	&& getnameinfo((struct sockaddr *) &ss, sslen, host, sizeof(host),
+		       serv, sizeof(serv), NI_NUMERICHOST | NI_NUMERICSERV) == 0)
+	snprintf(out, outlen, "%s %s", host, serv);
+    else
+	snprintf(out, outlen, "unix %s", l->path ? l->path : "-");
+}
+
+/* Connects to spamd and passes fd over, along with the request headers. */
+static int dispatch(int fd, const char *peer, const char *tls,
+		    const struct request *req)
+{
+    struct sockaddr_un addr;
+    struct msghdr msg;
+    struct iovec iov;
+    struct cmsghdr *cmsg;
+    union
+    {
+	struct cmsghdr align;
+	char buf[CMSG_SPACE(sizeof(int))];
+    } control;
+    char nul = '\0';
+    char preamble[512];
+    int plen, sock;
+
+    sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sock < 0)
+	return -1;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, dispatch_path, sizeof(addr.sun_path) - 1);
+    if (connect(sock, (struct sockaddr *) &addr, sizeof(addr)) < 0) {
+	fe_log(0, "cannot connect to spamd on %s: %s", dispatch_path,
+	       strerror(errno));
+	close(sock);
+	return -1;
+    }
+
+    memset(&msg, 0, sizeof(msg));
+    memset(&control, 0, sizeof(control));
+    iov.iov_base = &nul;
+    iov.iov_len = 1;
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+    cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+
+    plen = snprintf(preamble, sizeof(preamble),
+		    "Peer: %s\r\n%s%s%sRequest-length: %d\r\n\r\n",
+		    peer, tls ? "TLS: " : "", tls ? tls : "", tls ? "\r\n" : "",
+		    req->hdr_len);
+
+    if (sendmsg(sock, &msg, 0) != 1
+	|| full_write_fd(sock, preamble, plen) < 0
+	|| full_write_fd(sock, req->buf, req->hdr_len) < 0) {
+	fe_log(0, "cannot pass connection to spamd: %s", strerror(errno));
+	close(sock);
+	return -1;
+    }
+    close(sock);
+    return 0;
+}
+
+#ifdef SPAMC_SSL
+/* Copies between the SSL connection and spamd's end of the socketpair
+ * until spamd is done.
+ */
+static void relay(SSL *ssl, int fd, int spamd_fd)
+{
+    static char buf[FE_RELAY_BUF];
+    struct pollfd pfd[2];
+    int client_open = 1, n;
+
+    pfd[0].fd = fd;
+    pfd[1].fd = spamd_fd;
+    pfd[1].events = POLLIN;
+    for (;;) {
+	pfd[0].events = client_open ? POLLIN : 0;
+	if (!client_open || !SSL_pending(ssl)) {
+	    n = poll(pfd, 2, -1);
+	    if (n < 0 && errno == EINTR)
+		continue;
+	    if (n < 0)
+		return;
+	}
+	if (client_open && (SSL_pending(ssl) || pfd[0].revents)) {
+	    n = SSL_read(ssl, buf, sizeof(buf));
+	    if (n <= 0) {
+		client_open = 0;
+		shutdown(spamd_fd, SHUT_WR);
+	    }
+	    else if (full_write_fd(spamd_fd, buf, n) < 0)
+		return;
+	}
+	if (pfd[1].revents) {
+	    n = read(spamd_fd, buf, sizeof(buf));
+	    if (n < 0 && errno == EINTR)
+		continue;
+	    if (n <= 0)
+		return;		/* spamd closed the connection */
+	    if (SSL_write(ssl, buf, n) != n)
+		return;
+	}
+    }
+}
+#endif
+
+static void handle_connection(int fd, const struct listener *l)
+{
+    static struct request req;
+    struct timeval tv;
+    char peer[NI_MAXHOST + NI_MAXSERV + 8];
+    const char *err;
+    SSL *ssl = NULL;
+
+    set_blocking(fd, 1);
+    tv.tv_sec = timeout;
+    tv.tv_usec = 0;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    peer_description(fd, l, peer, sizeof(peer));
+
+#ifdef SPAMC_SSL
+    if (l->ssl) {
+	ssl = SSL_new(ssl_ctx);
+	SSL_set_fd(ssl, fd);
+	if (SSL_accept(ssl) <= 0) {
+	    fe_log(0, "SSL handshake with %s failed: %s", peer,
+		   ERR_reason_error_string(ERR_get_error()));
+	    goto done;
+	}
+    }
+#endif
+
+    err = read_request(fd, ssl, &req);
+    if (!err)
+	err = validate_request(&req);
+    if (err) {
+	protocol_error(fd, ssl, peer, err);
+	goto done;
+    }
+    fe_log(1, "%.*s from %s", (int) (strchr(req.buf, ' ') - req.buf),
+	   req.buf, peer);
+
+    /* no timeout while spamd works on the message */
+    tv.tv_sec = 0;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    if (!ssl) {
+	if (dispatch(fd, peer, NULL, &req) < 0) {
+	    const char *busy = "SPAMD/1.0 75 Service Unavailable: "
+		"cannot reach spamd\r\n";
+	    full_write_fd(fd, busy, strlen(busy));
+	}
+    }
+#ifdef SPAMC_SSL
+    else {
+	char tls[128];
+	int sv[2];
+
+	snprintf(tls, sizeof(tls), "%s/%s", SSL_get_version(ssl),
+		 SSL_get_cipher(ssl));
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) < 0) {
+	    fe_log(0, "socketpair: %s", strerror(errno));
+	    goto done;
+	}
+	if (dispatch(sv[1], peer, tls, &req) < 0) {
+	    const char *busy = "SPAMD/1.0 75 Service Unavailable: "
+		"cannot reach spamd\r\n";
+	    SSL_write(ssl, busy, strlen(busy));
+	    close(sv[0]);
+	    close(sv[1]);
+	    goto done;
+	}
+	close(sv[1]);
+	/* part of the body may have arrived along with the headers */
+	if (req.len > req.hdr_len)
+	    full_write_fd(sv[0], req.buf + req.hdr_len, req.len - req.hdr_len);
+	relay(ssl, fd, sv[0]);
+	close(sv[0]);
+	SSL_shutdown(ssl);
+    }
+#endif
+
+  done:
+#ifdef SPAMC_SSL
+    if (ssl)
+	SSL_free(ssl);
+#endif
+    close(fd);
+}
+
+static void worker_loop(void)
+{
+    struct pollfd pfd[FE_MAX_LISTEN];
+    int i, n, fd;
+
+    signal(SIGTERM, SIG_DFL);
+    signal(SIGINT, SIG_DFL);
+    for (i = 0; i < n_listeners; i++) {
+	pfd[i].fd = listeners[i].fd;
+	pfd[i].events = POLLIN;
+    }
+    for (;;) {
+	n = poll(pfd, n_listeners, -1);
+	if (n < 0 && errno != EINTR) {
+	    fe_log(0, "poll: %s", strerror(errno));
+	    _exit(EX_OSERR);
+	}
+	for (i = 0; n > 0 && i < n_listeners; i++) {
+	    if (!pfd[i].revents)
+		continue;
+	    fd = accept(pfd[i].fd, NULL, NULL);
+	    if (fd >= 0)
+		handle_connection(fd, &listeners[i]);
+	}
+    }
+}
+
+static pid_t spawn_worker(void)
+{
+    pid_t pid = fork();
+
+    if (pid == 0) {
+	worker_loop();
+	_exit(EX_OK);
+    }
+    if (pid < 0)
+	fe_log(0, "fork: %s", strerror(errno));
+    return pid;
+}
+
+static void term_handler(int sig)
+{
+    (void) sig;
+    got_term = 1;
+}
+
+/* ---------------------------------------------------------------------- */
+
+int main(int argc, char **argv)
+{
+    static struct option longopts[] = {
+	{"listen", required_argument, 0, 'l'},
+	{"dispatch", required_argument, 0, 'd'},
+	{"workers", required_argument, 0, 'n'},
+	{"timeout", required_argument, 0, 't'},
+	{"max-size", required_argument, 0, 's'},
+	{"ssl-cert", required_argument, 0, 'C'},
+	{"ssl-key", required_argument, 0, 'K'},
+	{"pidfile", required_argument, 0, 'r'},
+	{"debug", no_argument, 0, 'D'},
+	{"help", no_argument, 0, 'h'},
+	{0, 0, 0, 0}
+    };
+    const char *specs[FE_MAX_LISTEN];
+    int n_specs = 0, need_ssl = 0, opt, longind, i, running;
+    pid_t *workers;
+    struct sigaction sa;
+
+    while ((opt = spamc_getopt_long(argc, argv, "l:d:n:t:s:r:Dh", longopts,
+				    &longind)) != -1) {
+	switch (opt) {
+	case 'l':
+	    if (n_specs == FE_MAX_LISTEN) {
+		fe_log(0, "too many listen sockets");
+		return EX_USAGE;
+	    }
+	    specs[n_specs++] = spamc_optarg;
+	    break;
+	case 'd':
+	    dispatch_path = spamc_optarg;
+	    break;
+	case 'n':
+	    n_workers = atoi(spamc_optarg);
+	    break;
+	case 't':
+	    timeout = atoi(spamc_optarg);
+	    break;
+	case 's':
+	    max_size = atol(spamc_optarg);
+	    break;
+	case 'C':
+	    ssl_cert = spamc_optarg;
+	    break;
+	case 'K':
+	    ssl_key = spamc_optarg;
+	    break;
+	case 'r':
+	    pidfile = spamc_optarg;
+	    break;
+	case 'D':
+	    debug = 1;
+	    break;
+	case 'h':
+	    usage();
+	    return EX_OK;
+	default:
+	    usage();
+	    return EX_USAGE;
+	}
+    }
+    if (!dispatch_path || dispatch_path[0] != '/' || n_workers < 1
+	|| timeout < 1) {
+	usage();
+	return EX_USAGE;
+    }
+    if (n_specs == 0)
+	specs[n_specs++] = "localhost:783";
+
+    signal(SIGPIPE, SIG_IGN);
+    for (i = 0; i < n_specs; i++) {
+	if (add_listener(specs[i]) < 0)
+	    return EX_CONFIG;
+	need_ssl |= listeners[i].ssl;
+    }
+#ifdef SPAMC_SSL
+    if (need_ssl && (ssl_ctx = ssl_server_init()) == NULL)
+	return EX_CONFIG;
+#else
+    (void) need_ssl;
+#endif
+
+    if (pidfile) {
+	FILE *f = fopen(pidfile, "w");
+	if (f) {
+	    fprintf(f, "%d\n", (int) getpid());
+	    fclose(f);
+	}
+	else
+	    fe_log(0, "cannot write to PID file %s: %s", pidfile,
+		   strerror(errno));
+    }
+
+    /* without SA_RESTART, so that the signal interrupts wait() below */
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = term_handler;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGTERM, &sa, NULL);
+    sigaction(SIGINT, &sa, NULL);
+
+    workers = calloc(n_workers, sizeof(pid_t));
+    if (!workers)
+	return EX_OSERR;
+    for (i = 0; i < n_workers; i++)
+	workers[i] = spawn_worker();
+
+    /* keep the workers running; a worker only exits if something broke */
+    while (!got_term) {
+	int status;
+	pid_t pid = wait(&status);
+
+	if (pid < 0) {
+	    if (errno == EINTR)
+		continue;
+	    break;
+	}
+	for (i = 0; i < n_workers; i++) {
+	    if (workers[i] == pid) {
+		fe_log(0, "worker %d exited with status %d", (int) pid,
+		       WIFEXITED(status) ? WEXITSTATUS(status) : -1);
+		sleep(1);	/* avoid a tight respawn loop */
+		workers[i] = spawn_worker();
+	    }
+	}
+    }
+
+    for (i = 0, running = 0; i < n_workers; i++) {
+	if (workers[i] > 0 && kill(workers[i], SIGTERM) == 0)
+	    running++;
+    }
+    while (running > 0) {
+	if (wait(NULL) < 0 && errno == EINTR)
+	    continue;
+	running--;
+    }
+    for (i = 0; i < n_listeners; i++) {
+	if (listeners[i].path)
+	    unlink(listeners[i].path);
+    }
+    if (pidfile)
+	unlink(pidfile);
+    return EX_OK;
+}
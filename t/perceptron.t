@@ -0,0 +1,68 @@
+#!/usr/bin/perl -T
+
+use lib '.'; use lib 't';
+use SATest; sa_t_init("perceptron");
+
+use Config;
+use Test::More;
+plan skip_all => "no perceptron" unless (-e '../masses/perceptron.c');
+plan skip_all => "perceptron does not build on Windows" if $RUNNING_ON_WINDOWS;
+plan skip_all => "no C compiler" unless $Config{cc};
+plan tests => 6;
+
+# ---------------------------------------------------------------------------
+
+# build the trainer and the corpus converter into the work dir, so as not
+# to leave objects behind in masses
+my $cc = untaint_var($Config{cc});
+untaint_system ("$cc -O2 -o $workdir/perceptron ../masses/perceptron.c ".
+    "../masses/corpus.c ../masses/score-kernel.c -lm -lpthread");
+ok (($? >> 8) == 0);
+untaint_system ("$cc -O2 -o $workdir/logs-to-corpus ../masses/logs-to-corpus.c ".
+    "-lpthread");
+ok (($? >> 8) == 0);
+
+# a made-up corpus: ten rules which mostly hit spam and ten which mostly hit
+# ham, all mutable, with ranges which do not give their signs away
+my @spamrules = map { "T_SPAMMY_$_" } 1..10;
+my @hamrules = map { "T_HAMMY_$_" } 1..10;
+
+open (O, ">$workdir/rules") or die "open $workdir/rules failed";
+print O "# name mutable range_lo range_hi score\n";
+print O "$_ 1 -4 4 0\n" foreach (@spamrules, @hamrules);
+close O or die "close $workdir/rules failed";
+
+srand (1);
+writelog ("$workdir/spam.log", 'Y', \@spamrules, \@hamrules);
+writelog ("$workdir/ham.log", '.', \@hamrules, \@spamrules);
+
+untaint_system ("$workdir/logs-to-corpus -o $workdir/corpus.bin ".
+    "$workdir/rules $workdir/spam.log $workdir/ham.log >/dev/null");
+ok (($? >> 8) == 0);
+
+# with a single fold, the scores are trained and tested on the whole
+# corpus, and should tell spam from ham nearly always
+my $out = untaint_cmd ("$workdir/perceptron -c $workdir/corpus.bin -k 1 ".
+    "-s 1 -P 1");
+like ($out, qr/1-fold cross-validation/);
+
+my ($fp) = $out =~ /False positives:\s+\d+\s+([\d.]+)%/;
+my ($fn) = $out =~ /False negatives:\s+\d+\s+([\d.]+)%/;
+ok (defined $fp && $fp < 5);
+ok (defined $fn && $fn < 10);
+
+exit;
+
+
+# each message hits each of the likely rules with a chance of 1 in 2, and
+# each of the others with a chance of 1 in 20
+sub writelog {
+  my ($f, $label, $likely, $unlikely) = @_;
+  open (O, ">$f") or die "open $f failed";
+  foreach my $i (1..200) {
+    my @hits = ((grep { rand() < 1/2 } @$likely),
+                (grep { rand() < 1/20 } @$unlikely));
+    print O "$label 0 /dev/null/$i ".join(',', @hits)." time=1\n";
+  }
+  close O or die "close $f failed";
+}
@@ -0,0 +1,31 @@
+#!/usr/bin/perl -T
+
+use lib '.'; use lib 't';
+use SATest; sa_t_init("spamd_child_concurrency");
+
+use Test::More;
+plan skip_all => "Spamd tests disabled" if $SKIP_SPAMD_TESTS;
+plan skip_all => "Test requires a non-root user" if $> == 0;
+plan tests => 16;
+
+# ---------------------------------------------------------------------------
+
+%patterns = (
+  q{ X-Spam-Status: Yes, score=}, 'status',
+  q{ X-Spam-Flag: YES}, 'flag',
+  q{ TEST_ENDSNUMS}, 'endsinnums',
+  q{ TEST_NOREALNAME}, 'noreal',
+);
+
+start_spamd("-L -x --round-robin -m1 --child-concurrency=3");
+ok ($spamd_pid > 1);
+ok (spamcrun ("< data/spam/001", \&patterns_run_cb));
+ok_all_patterns();
+ok (spamcrun_background ("< data/spam/002", {}));
+ok (spamcrun_background ("< data/spam/003", {}));
+ok (spamcrun_background ("< data/spam/004", {}));
+ok (spamcrun_background ("< data/spam/005", {}));
+clear_pattern_counters();
+ok (spamcrun ("< data/spam/001", \&patterns_run_cb));
+ok_all_patterns();
+ok (stop_spamd());
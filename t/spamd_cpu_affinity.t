@@ -0,0 +1,37 @@
+#!/usr/bin/perl -T
+
+use lib '.'; use lib 't';
+use SATest; sa_t_init("spamd_cpu_affinity");
+
+use Test::More;
+plan skip_all => "Spamd tests disabled" if $SKIP_SPAMD_TESTS;
+plan skip_all => "CPU affinity is only supported on Linux" if $^O ne 'linux';
+plan tests => 6;
+
+# ---------------------------------------------------------------------------
+
+%patterns = (
+  q{ X-Spam-Flag: YES } => 'flag',
+  q{ GTUBE }            => 'gtube',
+);
+
+start_spamd("-L -m 3 --round-robin --cpu-affinity=numa");
+ok (spamcrun ("< data/spam/gtube.eml", \&patterns_run_cb));
+ok_all_patterns();
+stop_spamd();
+
+%patterns = (
+  q{ cpu-affinity: child bound to CPUs } => 'bound',
+);
+checkfile($spamd_stderr, \&patterns_run_cb);
+ok_all_patterns();
+
+# a CPU that does not exist: the children run unpinned
+$spamd_already_killed = undef;
+%patterns = (
+  q{ X-Spam-Flag: YES } => 'flag',
+);
+start_spamd("-L --cpu-affinity=1023");
+ok (spamcrun ("< data/spam/gtube.eml", \&patterns_run_cb));
+ok_all_patterns();
+stop_spamd();
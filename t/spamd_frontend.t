@@ -0,0 +1,51 @@
+#!/usr/bin/perl -T
+
+use lib '.'; use lib 't';
+use SATest; sa_t_init("spamd_frontend");
+
+use Test::More;
+plan skip_all => "Spamd tests disabled"        if $SKIP_SPAMD_TESTS;
+plan skip_all => "Tests don't work on windows" if $RUNNING_ON_WINDOWS;
+plan skip_all => "spamd-fe not built"          unless -x "../spamc/spamd-fe";
+plan skip_all => "IO::FDPass not installed"    unless eval { require IO::FDPass; 1 };
+plan tests => 8;
+
+# ---------------------------------------------------------------------------
+
+tstprefs("
+  use_auto_whitelist 0
+");
+
+my $sockdir = mk_socket_tempdir();
+my $fe_sock = "$sockdir/spamd-fe.sock";
+my $client_sock = "$sockdir/client.sock";
+my $fe_pidfile = "$sockdir/spamd-fe.pid";
+
+start_spamd("-L --listen=fe:$fe_sock");
+untaint_system("../spamc/spamd-fe -n 2 -l $client_sock -d $fe_sock"
+               . " -r $fe_pidfile 2>$workdir/spamd-fe.err &");
+for (1 .. 10) { last if -S $client_sock; sleep 1; }
+
+%patterns = (
+  q{ Subject: There yours for FREE!}, 'subj',
+  q{ X-Spam-Status: Yes, score=}, 'status',
+  q{ X-Spam-Flag: YES}, 'flag',
+);
+ok (spamcrun ("-U $client_sock < data/spam/001", \&patterns_run_cb));
+ok_all_patterns();
+
+%patterns = (
+  q{ X-Spam-Flag: YES } => 'flag',
+  q{ GTUBE }            => 'gtube',
+);
+ok (spamcrun ("-U $client_sock < data/spam/gtube.eml", \&patterns_run_cb));
+ok_all_patterns();
+
+# the connection was handed over, not proxied
+%patterns = ( q{ via front-end } => 'handover' );
+checkfile($spamd_stderr, \&patterns_run_cb);
+ok_all_patterns();
+
+my $fe_pid = read_from_pidfile($fe_pidfile);
+kill('TERM', $fe_pid)  if $fe_pid;
+stop_spamd();
@@ -0,0 +1,56 @@
+#!/usr/bin/perl -T
+
+use lib '.'; use lib 't';
+use SATest; sa_t_init("spamd_graceful_reload");
+use File::Spec;
+
+use Test::More;
+plan skip_all => "Spamd tests disabled" if $SKIP_SPAMD_TESTS;
+plan skip_all => "Long running tests disabled" unless conf_bool('run_long_tests');
+plan skip_all => "Tests don't work on windows" if $RUNNING_ON_WINDOWS;
+plan tests => 32;
+
+# ---------------------------------------------------------------------------
+
+my($pid1, $pid2);
+
+dbgprint "Starting spamd...\n";
+start_spamd("-L --graceful-reload");
+sleep 1;
+
+for $retry (0 .. 3) {
+  ok ($pid1 = read_from_pidfile($spamd_pidfile));
+  dbgprint "HUPing spamd at pid $pid1, loop try $retry...\n";
+
+  # the old server keeps running until the new one has written the pidfile
+  # and taken over, so the pidfile never disappears
+  ok (kill ('HUP', $pid1));
+  for my $wait (0 .. 97) {
+    $pid2 = read_from_pidfile($spamd_pidfile);
+    last if $pid2 && $pid2 != $pid1;
+    sleep 1;
+  }
+
+  dbgprint "Looking for new spamd at pid $pid2...\n";
+  ok ($pid2 && $pid2 != $pid1);
+  ok ($pid2 and kill (0, $pid2));
+
+  dbgprint "Waiting for old spamd at pid $pid1 to drain...\n";
+  for my $wait (0 .. 19) {
+    last if !kill (0, $pid1);
+    sleep 1;
+  }
+  ok (!kill (0, $pid1));
+
+  dbgprint "Checking GTUBE...\n";
+  %patterns = (
+    q{ X-Spam-Flag: YES } => 'flag',
+    q{ GTUBE }            => 'gtube',
+  );
+  ok (spamcrun ("< data/spam/gtube.eml", \&patterns_run_cb));
+  ok_all_patterns;
+}
+
+dbgprint "Stopping spamd...\n";
+$spamd_pid = read_from_pidfile($spamd_pidfile);
+stop_spamd;
@@ -0,0 +1,36 @@
+#!/usr/bin/perl -T
+
+use lib '.'; use lib 't';
+use SATest; sa_t_init("spamd_result_cache");
+
+use Test::More;
+plan skip_all => "Spamd tests disabled" if $SKIP_SPAMD_TESTS;
+plan skip_all => "Tests don't work on windows" if $RUNNING_ON_WINDOWS;
+plan tests => 14;
+
+# ---------------------------------------------------------------------------
+
+%patterns = (
+  q{ X-Spam-Status: Yes, score=}, 'status',
+  q{ X-Spam-Flag: YES}, 'flag',
+  q{ TEST_ENDSNUMS}, 'endsinnums',
+  q{ TEST_NOREALNAME}, 'noreal',
+);
+
+start_spamd("-D spamd -L --result-cache-size=64");
+ok (spamcrun ("< data/spam/001", \&patterns_run_cb));
+ok_all_patterns();
+
+# the second scan of the same message is answered from the cache
+clear_pattern_counters();
+ok (spamcrun ("< data/spam/001", \&patterns_run_cb));
+ok_all_patterns();
+
+%patterns = (
+  q{ spamd: result cache miss }, 'miss',
+  q{ spamd: result cache hit, score }, 'hit',
+  q{,cached=1,}, 'cached',
+);
+checkfile($spamd_stderr, \&patterns_run_cb);
+ok_all_patterns();
+ok (stop_spamd());
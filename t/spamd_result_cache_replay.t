@@ -0,0 +1,65 @@
+#!/usr/bin/perl -T
+
+use lib '.'; use lib 't';
+use SATest; sa_t_init("spamd_result_cache_replay");
+
+use Test::More;
+plan skip_all => "Tests don't work on windows" if $RUNNING_ON_WINDOWS;
+plan skip_all => "no SysV shared memory"
+  unless eval { require IPC::SysV; IPC::SysV->import('shmat'); 1 };
+plan tests => 8;
+
+use Mail::SpamAssassin;
+use Mail::SpamAssassin::SpamdResultCache;
+
+# ---------------------------------------------------------------------------
+
+# T_DYNAMIC has no score of its own: a plugin would score it with
+# got_hit(..., score => ...)
+tstlocalrules ("
+  body T_STATIC /sample/
+  score T_STATIC 1.5
+  body T_DYNAMIC /nonexistent-pattern/
+  score T_DYNAMIC 0
+");
+
+my $sa = create_saobj({ dont_copy_prefs => 1 });
+$sa->init(1);
+my $conf = $sa->{conf};
+
+my $cache = Mail::SpamAssassin::SpamdResultCache->new({
+    entries => 16, ttl => 60 });
+
+my @msg = ("From: a\@example.com\n", "Subject: test\n", "\n", "sample\n");
+
+# a scan in which a plugin gave T_DYNAMIC a score of 2.25
+my $mail = $sa->parse(\@msg);
+my $status = $sa->check($mail);
+$status->got_hit('T_DYNAMIC', 'BODY: ', score => 2.25);
+$status->{score} = (sprintf "%0.3f", $status->{score}) + 0;
+my $key = $cache->message_key($mail, 'user');
+$cache->store($key, $status);
+my $scan_score = $status->get_score();
+my $scan_tests = $status->get_names_of_tests_hit();
+$status->finish();
+$mail->finish();
+
+# the next scan does not score T_DYNAMIC again
+$conf->{scores}->{T_DYNAMIC} = 0;
+
+$mail = $sa->parse(\@msg);
+$status = Mail::SpamAssassin::PerMsgStatus->new($sa, $mail);
+ok ($cache->replay($key, $status));
+ok ($status->{result_from_cache});
+is ($status->get_score(), $scan_score);
+like ($status->get_names_of_tests_hit(), qr/\bT_DYNAMIC\b/);
+is ($status->get_names_of_tests_hit(), $scan_tests);
+like ($status->get_report(), qr/^\s*2\.2\s+T_DYNAMIC\b/m);
+
+# replaying leaves the config alone
+is ($conf->{scores}->{T_DYNAMIC}, 0);
+is ($conf->{scores}->{T_STATIC}, 1.5);
+
+$status->finish();
+$mail->finish();
+$cache->detach();